@@ -24,7 +24,7 @@ void ACZero::Set(Pin pin, byte invert)
 	Port.HardEvent = true;
 	Port.Set(pin);
 	if (invert < 2) Port.Invert = invert;
-	Port.Press.Bind(&ACZero::OnHandler, this);
+	Port.Press.Bind<ACZero, &ACZero::OnHandler>(this);
 	Port.UsePress();
 }
 
@@ -2,6 +2,7 @@
 #include "Kernel\Task.h"
 #include "Kernel\TTime.h"
 #include "Kernel\WaitHandle.h"
+#include "Core\StringView.h"
 
 #include "Device\SerialPort.h"
 
@@ -35,7 +36,7 @@ struct CmdState
 	cstring	Key3 = nullptr;
 
 	uint Parse(const Buffer& bs, WaitHandle& handle);
-	uint FindKey(const String& str);
+	uint FindKey(const StringView& str);
 };
 
 /******************************** AT ********************************/
@@ -258,6 +259,52 @@ bool AT::WaitForCmd(cstring expect, uint msTimeout)
 	return rt;
 }
 
+AT::Request::~Request()
+{
+	// 提前返回或超时没有EndSend，AT还指向本请求
+	if (_Owner) _Owner->EndSend(*this);
+
+	delete (CmdState*)_State;
+}
+
+// 发出指令后马上返回，不等待
+bool AT::BeginSend(const String& cmd, Request& req, cstring expect, cstring expect2)
+{
+	TS("AT::BeginSend");
+
+	// 判断是否正在发送其它指令
+	if (_Expect) return false;
+
+	auto we = (CmdState*)req._State;
+	if (!we) req._State = we = new CmdState();
+
+	req.Result.SetLength(0);
+	we->Result = &req.Result;
+	we->Key1 = expect;
+	we->Key2 = expect2;
+	we->Key3 = "busy ";
+
+	auto& handle = req.Handle;
+	handle.Result = false;
+	handle.State = we;
+
+	_Expect = &handle;
+	req._Owner = this;
+
+	Port->Write(cmd);
+
+	return true;
+}
+
+// 结束异步指令，释放占用
+bool AT::EndSend(Request& req)
+{
+	if (_Expect == &req.Handle) _Expect = nullptr;
+	req._Owner = nullptr;
+
+	return req.Handle.Result;
+}
+
 void ParseFail(cstring name, const Buffer& bs)
 {
 #if NET_DEBUG
@@ -269,7 +316,7 @@ void ParseFail(cstring name, const Buffer& bs)
 	if (p < bs.Length() && bs[p] == '\n') p++;
 
 	// 无法识别的数据可能是空格前缀，需要特殊处理
-	auto str = bs.Sub(p, -1).AsString();
+	auto str = BufferView(bs).Sub(p).AsString();
 	if (str)
 	{
 		net_printf("AT:%s 无法识别[%d]：", name, bs.Length());
@@ -295,15 +342,17 @@ uint AT::OnReceive(Buffer& bs, void* param)
 	bs.AsString().Show(true);*/
 
 	//分割数据，查询是否有GPS数据输出
-	auto str = bs.AsString();
-	auto sp = str.Split(",");
-	auto sp1=sp.Next();
-	if (sp1.Contains("+UGNSINF: 1") )
+	// 视图只移动指针，粘包分析过程中不拷贝数据
+	StringView str(bs);
+	auto sp = str;
+	StringView item;
+	sp.Split(",", item);
+	if (item.Contains("+UGNSINF: 1"))
 	{
-		sp.Next();
-		sp.Next();
-		latitude = sp.Next().ToFloat();
-		longitude = sp.Next().ToFloat();
+		sp.Split(",", item);
+		sp.Split(",", item);
+		if (sp.Split(",", item)) latitude = item.ToFloat();
+		if (sp.Split(",", item)) longitude = item.ToFloat();
 
 		return 0;
 	}
@@ -313,7 +362,7 @@ uint AT::OnReceive(Buffer& bs, void* param)
 	while (p >= 0 && p < bs.Length())
 	{
 		s = p;
-		p = str.IndexOf(DataKey, s);
+		p = DataKey ? str.IndexOf(DataKey, s) : -1;
 
 		// +IPD之前之后的数据，留给命令分析
 		int size = p >= 0 ? p - s : bs.Length() - s;
@@ -341,7 +390,7 @@ uint AT::OnReceive(Buffer& bs, void* param)
 		// +IPD开头的数据，作为收到数据
 		if (p >= 0)
 		{
-			p += String(DataKey).Length();
+			p += StringView(DataKey).Length();
 			if (p >= bs.Length())
 			{
 #if NET_DEBUG
@@ -394,13 +443,12 @@ uint CmdState::Parse(const Buffer& bs, WaitHandle& handle)
 	TS("WaitExpect::Parse");
 
 	// 适配任意关键字后，也就是收到了成功或失败，通知业务层已结束
-	auto s_ = bs.AsString();
-	auto& s = (const String&)s_;
+	StringView s(bs);
 	int p = FindKey(s);
 	auto& rs = *Result;
 
 	// 捕获所有
-	rs += s;
+	s.AppendTo(rs);
 
 	// 匹配关键字，任务完成
 	if (p > 0)
@@ -419,28 +467,31 @@ uint CmdState::Parse(const Buffer& bs, WaitHandle& handle)
 	return p;
 }
 
-uint CmdState::FindKey(const String& str)
+uint CmdState::FindKey(const StringView& str)
 {
 	// 适配第一关键字
-	int p = Key1 ? str.IndexOf(Key1) : -1;
+	StringView key = Key1;
+	int p = key ? str.IndexOf(key) : -1;
 	if (p >= 0)
 	{
 		//net_printf("适配第一关键字 %s \r\n", Key1);
-		return p + String(Key1).Length();
+		return p + key.Length();
 	}
 	// 适配第二关键字
-	p = Key2 ? str.IndexOf(Key2) : -1;
+	key = Key2;
+	p = key ? str.IndexOf(key) : -1;
 	if (p >= 0)
 	{
 		//net_printf("适配第二关键字 %s \r\n", Key2);
-		return p + String(Key2).Length();
+		return p + key.Length();
 	}
 	// 适配busy
-	p = str.IndexOf(Key3);
+	key = Key3;
+	p = key ? str.IndexOf(key) : -1;
 	if (p >= 0)
 	{
 		//net_printf("适配第三关键字 %s \r\n", Key3);
-		return p + String(Key3).Length();
+		return p + key.Length();
 	}
 	return 0;
 }
@@ -1,6 +1,8 @@
 ﻿#ifndef __AT_H__
 #define __AT_H__
 
+#include "Kernel\WaitHandle.h"
+
 // GPRS的AT指令集 GSM 07.07
 class AT
 {
@@ -33,6 +35,27 @@ public:
 	// 等待命令返回
 	bool WaitForCmd(cstring expect, uint msTimeout);
 
+	// 异步指令。由协程作为成员持有，跨越让出点
+	class Request
+	{
+	public:
+		WaitHandle	Handle;	// 收到期望字符串时被设置
+		String		Result;	// 响应内容
+
+		Request() { _State = nullptr; _Owner = nullptr; }
+		// 没有调用EndSend就销毁时，释放对AT的占用
+		~Request();
+
+	private:
+		friend class AT;
+		void*	_State;
+		AT*		_Owner;	// 发出指令的AT，EndSend后清空
+	};
+	// 发出指令后马上返回，不等待。协程中使用CO_WAIT(req.Handle, ms)等待，结束后调用EndSend
+	bool BeginSend(const String& cmd, Request& req, cstring expect = "OK", cstring expect2 = "ERROR");
+	// 结束异步指令，释放占用，返回是否收到期望字符串
+	bool EndSend(Request& req);
+
 private:
 	void*		_Expect;	// 等待内容
 
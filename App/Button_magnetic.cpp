@@ -19,7 +19,7 @@ Button_magnetic::Button_magnetic(Pin key, Pin led, Pin relay_pin1, Pin relay_pin
 
 	Key = new InputPort(key);
 	//Key->Register(OnPress, this);
-	Key->Press.Bind(&Button_magnetic::OnPress, this);
+	Key->Press.Bind<Button_magnetic, &Button_magnetic::OnPress>(this);
 	Key->UsePress();
 
 	if(led != P0) Led = new OutputPort(led);
@@ -34,7 +34,7 @@ Button_magnetic::Button_magnetic(Pin key, Pin led, bool ledInvert, Pin relay_pin
 
 	Key = new InputPort(key);
 	//Key->Register(OnPress, this);
-	Key->Press.Bind(&Button_magnetic::OnPress, this);
+	Key->Press.Bind<Button_magnetic, &Button_magnetic::OnPress>(this);
 	Key->UsePress();
 
 	if(led != P0) Led = new OutputPort(led, ledInvert);
@@ -35,7 +35,7 @@ void PulsePort::Open()
 	if (Port->HardEvent) _task = Sys.AddTask(OnPressTask, this, -1, -1, "脉冲事件");
 
 	Port->HardEvent = true;
-	Port->Press.Bind(&PulsePort::OnPress, this);
+	Port->Press.Bind<PulsePort, &PulsePort::OnPress>(this);
 	Port->UsePress();
 	Port->Open();
 
@@ -92,13 +92,13 @@ bool Raster::Open()
 
 	if (RasterA != nullptr)
 	{
-		RasterA->Press.Bind(&Raster::OnHandlerA, this);
+		RasterA->Press.Bind<Raster, &Raster::OnHandlerA>(this);
 		RasterA->Open();
 	}
 
 	if (RasterB != nullptr)
 	{
-		RasterB->Press.Bind(&Raster::OnHandlerB, this);
+		RasterB->Press.Bind<Raster, &Raster::OnHandlerB>(this);
 		RasterB->Open();
 	}
 
@@ -21,7 +21,7 @@ Sensor::Sensor(Pin key, Pin led, Pin buzzer)
 
 	Key = new InputPort(key);
 	//Key->Register(OnPress, this);
-	Key->Press.Bind(&Sensor::OnPress, this);
+	Key->Press.Bind<Sensor, &Sensor::OnPress>(this);
 	Key->UsePress();
 
 	if(led != P0) Led = new OutputPort(led);
@@ -34,7 +34,7 @@ Sensor::Sensor(Pin key, Pin led, bool ledInvert, Pin buzzer, bool buzzerInvert)
 
 	Key = new InputPort(key);
 	//Key->Register(OnPress, this);
-	Key->Press.Bind(&Sensor::OnPress, this);
+	Key->Press.Bind<Sensor, &Sensor::OnPress>(this);
 	Key->UsePress();
 
 	if(led != P0) Led = new OutputPort(led, ledInvert);
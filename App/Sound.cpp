@@ -49,7 +49,7 @@ void Music::Sound()
 	{
 		_timer->SetFrequency(100000);
 		//_timer->Register(TimerHander, this);
-		_timer->Register(Delegate<Timer&>(&Music::TimerHander, this));
+		_timer->Register(Delegate<Timer&>(MethodOf(&Music::TimerHander), this));
 		_timer->Open();
 		Sounding = true;
 	}
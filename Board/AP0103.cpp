@@ -148,8 +148,8 @@ NetworkInterface* AP0103::Create8266(bool apOnly)
 	}
 
 	esp->SetLed(*Leds[1]);
-	Client->Register("SetWiFi", &Esp8266::SetWiFi, esp);
-	Client->Register("GetWiFi", &Esp8266::GetWiFi, esp);
+	Client->Register("SetWiFi", MethodOf(&Esp8266::SetWiFi), esp);
+	Client->Register("GetWiFi", MethodOf(&Esp8266::GetWiFi), esp);
 
 	return esp;
 }
@@ -210,8 +210,8 @@ void AP0103::InitAlarm()
 	if (!Client)return;
 
 	if (!AlarmObj) AlarmObj = new Alarm();
-	Client->Register("Policy/AlarmSet", &Alarm::Set, AlarmObj);
-	Client->Register("Policy/AlarmGet", &Alarm::Get, AlarmObj);
+	Client->Register("Policy/AlarmSet", MethodOf(&Alarm::Set), AlarmObj);
+	Client->Register("Policy/AlarmGet", MethodOf(&Alarm::Get), AlarmObj);
 
 	AlarmObj->OnAlarm	= OnAlarm;
 	AlarmObj->Start();
@@ -286,6 +286,8 @@ void AP0103::InitTinyServer()
 
 	TinyCtl->Port = Nrf;
 	TinyCtl->QueueLength = 64;
+	// 网关需要过滤全部节点的重复消息
+	TinyCtl->Window.Capacity = 256;
 	TinyCtl->ApplyConfig();
 
 	// 新配置需要保存一下
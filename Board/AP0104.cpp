@@ -142,8 +142,8 @@ NetworkInterface* AP0104::Create8266(bool apOnly)
 	}
 
 	esp->SetLed(*Leds[1]);
-	Client->Register("SetWiFi", &Esp8266::SetWiFi, esp);
-	Client->Register("GetWiFi", &Esp8266::GetWiFi, esp);
+	Client->Register("SetWiFi", MethodOf(&Esp8266::SetWiFi), esp);
+	Client->Register("GetWiFi", MethodOf(&Esp8266::GetWiFi), esp);
 
 	return esp;
 }
@@ -204,8 +204,8 @@ void AP0104::InitAlarm()
 	if (!Client)return;
 
 	if (!AlarmObj) AlarmObj = new Alarm();
-	Client->Register("Policy/AlarmSet", &Alarm::Set, AlarmObj);
-	Client->Register("Policy/AlarmGet", &Alarm::Get, AlarmObj);
+	Client->Register("Policy/AlarmSet", MethodOf(&Alarm::Set), AlarmObj);
+	Client->Register("Policy/AlarmGet", MethodOf(&Alarm::Get), AlarmObj);
 
 	AlarmObj->OnAlarm	= OnAlarm;
 	AlarmObj->Start();
@@ -277,6 +277,8 @@ void AP0104::InitTinyServer()
 
 	TinyCtl->Port = Nrf;
 	TinyCtl->QueueLength = 64;
+	// 网关需要过滤全部节点的重复消息
+	TinyCtl->Window.Capacity = 256;
 	TinyCtl->ApplyConfig();
 
 	// 新配置需要保存一下
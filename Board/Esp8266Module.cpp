@@ -46,9 +46,9 @@ NetworkInterface* Esp8266Module::Create8266(OutputPort* led)
 	}
 
 	if (led)esp->SetLed(*led);
-	//Client->Register("SetWiFi", &Esp8266::SetWiFi, esp);
-	//Client->Register("GetWiFi", &Esp8266::GetWiFi, esp);
-	//Client->Register("GetAPs", &Esp8266::GetAPs, esp);
+	//Client->Register("SetWiFi", MethodOf(&Esp8266::SetWiFi), esp);
+	//Client->Register("GetWiFi", MethodOf(&Esp8266::GetWiFi), esp);
+	//Client->Register("GetAPs", MethodOf(&Esp8266::GetAPs), esp);
 
 	return esp;
 }
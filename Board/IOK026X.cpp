@@ -120,8 +120,8 @@ void IOK026X::InitAlarm()
 	if (!Client)return;
 
 	if (!AlarmObj) AlarmObj = new Alarm();
-	Client->Register("Policy/AlarmSet", &Alarm::Set, AlarmObj);
-	Client->Register("Policy/AlarmGet", &Alarm::Get, AlarmObj);
+	Client->Register("Policy/AlarmSet", MethodOf(&Alarm::Set), AlarmObj);
+	Client->Register("Policy/AlarmGet", MethodOf(&Alarm::Get), AlarmObj);
 
 	AlarmObj->OnAlarm = OnAlarm;
 	AlarmObj->Start();
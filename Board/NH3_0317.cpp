@@ -134,8 +134,8 @@ void NH3_0317::InitAlarm()
 	if (!Client) return;
 
 	if (!AlarmObj) AlarmObj = new Alarm();
-	Client->Register("Policy/AlarmSet", &Alarm::Set, AlarmObj);
-	Client->Register("Policy/AlarmGet", &Alarm::Get, AlarmObj);
+	Client->Register("Policy/AlarmSet", MethodOf(&Alarm::Set), AlarmObj);
+	Client->Register("Policy/AlarmGet", MethodOf(&Alarm::Get), AlarmObj);
 
 	AlarmObj->OnAlarm	= OnAlarm;
 	AlarmObj->Start();
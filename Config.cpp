@@ -3,6 +3,8 @@
 #include "Config.h"
 #include "Device\Flash.h"
 #include "Security\Crc.h"
+#include "Core\Intern.h"
+#include "Message\Schema.h"
 
 #define CFG_DEBUG DEBUG
 //#define CFG_DEBUG 0
@@ -168,6 +170,9 @@ Config::Config(const Storage& st, uint addr, uint size)
 {
 	Address	= addr;
 	Size	= size;
+
+	Buffer(_Cache, sizeof(_Cache)).Clear();
+	_CacheIndex	= 0;
 }
 
 // 检查签名
@@ -235,10 +240,44 @@ const ConfigBlock* NewBlock(const Storage& st, uint addr, int size)
 	return cfg;
 }
 
+// 先查缓存，未命中再遍历配置块链表
+const void* Config::Lookup(const String& name) const
+{
+	// 名称换成驻留指针，缓存按指针匹配
+	auto key	= Intern::Find(name.GetBuffer(), name.Length());
+	if(key)
+	{
+		for(int i=0; i<ArrayLength(_Cache); i++)
+		{
+			auto& item	= _Cache[i];
+			if(item.Name != key) continue;
+
+			// 配置块可能已被删除或整区擦除，校验后才能使用
+			auto cfg	= (const ConfigBlock*)item.Block;
+			if(cfg->Valid() && name == cfg->Name) return cfg;
+
+			item.Name	= nullptr;
+			break;
+		}
+	}
+
+	auto cfg	= FindBlock(Device, Address, name);
+	if(!cfg) return nullptr;
+
+	// 找到才驻留，名称个数受配置块个数限制
+	if(!key) key	= Intern::Add(name.GetBuffer(), name.Length());
+
+	auto& item	= _Cache[_CacheIndex++ % ArrayLength(_Cache)];
+	item.Name	= key;
+	item.Block	= cfg;
+
+	return cfg;
+}
+
 // 循环查找配置块
 const void* Config::Find(const String& name) const
 {
-	return FindBlock(Device, Address, name);
+	return Lookup(name);
 }
 
 // 创建一个指定大小的配置块。找一个满足该大小的空闲数据块，或者在最后划分一个
@@ -265,7 +304,7 @@ bool Config::Remove(const String& name) const
 
     if(!name) return false;
 
-	auto cfg = FindBlock(Device, Address, name);
+	auto cfg = (const ConfigBlock*)Lookup(name);
 	if(!cfg) return false;
 
 	// 只清空名称，修改哈希，不能改大小，否则无法定位下一个配置块
@@ -324,7 +363,7 @@ const void* Config::Set(const String& name, const Buffer& bs) const
 	assert(name.Length() < (int)sizeof(ConfigBlock::Name), "配置区名称太长");
     if(name.Length() >= (int)sizeof(ConfigBlock::Name)) return nullptr;
 
-	auto cfg = FindBlock(Device, Address, name);
+	auto cfg = (const ConfigBlock*)Lookup(name);
 	if(!cfg) cfg	= NewBlock(Device, Address, bs.Length());
     if(!cfg) return nullptr;
 
@@ -343,7 +382,7 @@ bool Config::Get(const String& name, Buffer& bs) const
 
     if(!name) return false;
 
-	auto cfg = FindBlock(Device, Address, name);
+	auto cfg = (const ConfigBlock*)Lookup(name);
     if(!cfg) return false;
 
 	return cfg->CopyTo(bs) > 0;
@@ -355,7 +394,7 @@ const void* Config::Get(const String& name) const
 
     if(!name) return nullptr;
 
-	auto cfg = FindBlock(Device, Address, name);
+	auto cfg = (const ConfigBlock*)Lookup(name);
     if(cfg && cfg->Size) return cfg->Data();
 
     return nullptr;
@@ -414,6 +453,7 @@ ConfigBase::ConfigBase()
 	New	= true;
 
 	_Name	= nullptr;
+	_Schema	= nullptr;
 }
 
 uint ConfigBase::Size() const
@@ -480,11 +520,20 @@ void ConfigBase::Show() const
 
 void ConfigBase::Write(Stream& ms) const
 {
-	ms.Write(ToArray());
+	if(_Schema)
+		_Schema->Write(ms, this);
+	else
+		ms.Write(ToArray());
 }
 
 void ConfigBase::Read(Stream& ms)
 {
+	if(_Schema)
+	{
+		_Schema->Read(ms, this);
+		return;
+	}
+
 	auto bs	= ToArray();
 	ms.Read(bs);
 }
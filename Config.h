@@ -4,11 +4,23 @@
 #include "Kernel\Sys.h"
 #include "Storage\Storage.h"
 
+class Schema;
+
 // 配置管理
 // 配置区以指定签名开头，后续链式跟随各配置块
 class Config
 {
 private:
+	// 查找缓存，按驻留名称匹配，命中时只需校验该块，不必遍历配置块链表
+	struct CacheItem
+	{
+		cstring		Name;
+		const void*	Block;
+	};
+	mutable CacheItem	_Cache[4];
+	mutable byte		_CacheIndex;
+
+	const void* Lookup(const String& name) const;
 
 public:
 	const Storage&	Device;	// 配置存储的设备
@@ -58,7 +70,7 @@ public:
 	virtual void Clear();
 	virtual void Show() const;
 
-	// 序列化到消息数据流
+	// 序列化到消息数据流。有字段描述时按描述紧凑编码，否则整段拷贝
 	void Write(Stream& ms) const;
 	void Read(Stream& ms);
 
@@ -73,6 +85,9 @@ protected:
 
 	void* _Start;
 	void* _End;
+
+	// 字段描述，偏移相对于配置对象，配置类须单继承ConfigBase
+	const Schema*	_Schema;
 };
 
 // 必须设定为1字节对齐，否则offsetof会得到错误的位置
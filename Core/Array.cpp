@@ -3,6 +3,7 @@
 #include "Type.h"
 #include "Buffer.h"
 #include "Array.h"
+#include "MemoryArena.h"
 
 /******************************** Array ********************************/
 
@@ -20,18 +21,29 @@ Array::Array(const void* data, int len) : Buffer((void*)data, len)
 
 Array::Array(const Buffer& rhs) : Buffer(nullptr, 0)
 {
-	Copy(0, rhs, 0, -1);
-
 	Init();
+
+	Copy(0, rhs, 0, -1);
 }
 
 Array::Array(Array&& rval) : Buffer(nullptr, 0)
 {
+	Init();
+
 	move(rval);
 }
 
 void Array::move(Array& rval)
 {
+	// 内存区里的数据随作用域释放，目标可能活得更久，只能拷贝
+	if(!rval._needFree && rval.Arena && rval.Arena->Contains(rval._Arr))
+	{
+		if(SetLength(rval._Length))
+			Buffer(_Arr, _Size * _Length).Copy(0, rval._Arr, _Size * rval._Length);
+
+		return;
+	}
+
 	// 如果自己有申请内存，则需要先释放
 	if (_needFree && _Arr != rval._Arr) Release();
 
@@ -50,6 +62,7 @@ void Array::move(Array& rval)
 void Array::Init()
 {
 	Expand	= true;
+	Arena	= nullptr;
 	_Size	= 1;
 
 	_Capacity	= _Length;
@@ -284,31 +297,58 @@ bool Array::CheckCapacity(int len, int bak)
 	// 是否可以扩容
 	if(!Expand) return false;
 
-	// 自动计算合适的容量
-	int sz = 0x40;
-	while(sz < len) sz <<= 1;
+	// 按1.5倍扩容。比翻倍浪费少，释放的旧块也更容易被后面的分配复用
+	int sz = _Capacity + (_Capacity >> 1);
+	if(sz < 0x40) sz = 0x40;
+	if(sz < len) sz = len;
+
+	return Realloc(sz, bak);
+}
+
+// 调整容量为指定大小，并备份指定长度的数据。inplace表示优先原地调整
+bool Array::Realloc(int len, int bak, bool inplace)
+{
+	// 可写的自有内存，先试试原地调整，省掉一次分配和拷贝
+	if(inplace && _Arr && _canWrite)
+	{
+		bool rs	= false;
+		if(_needFree)
+			rs	= ResizeInPlace(_Arr, _Size * len);
+		else if(Arena)
+			rs	= Arena->Resize(_Arr, _Size * _Capacity, _Size * len);
+
+		if(rs)
+		{
+			_Capacity	= len;
+			if(_Length > len) _Length = len;
+
+			return true;
+		}
+	}
 
 	bool _free	= _needFree;
 
-	void* p = Alloc(sz);
+	void* p = Alloc(len);
 	if(!p) return false;
 
 	// 是否需要备份数据
 	if(bak > _Length) bak = _Length;
-	if(bak > 0 && _Arr)
+	if(bak > len) bak = len;
+	if(bak > 0 && _Arr && _Arr != p)
 		// 为了安全，按照字节拷贝
-		Buffer(p, sz).Copy(0, _Arr, bak);
+		Buffer(p, _Size * len).Copy(0, _Arr, _Size * bak);
 
 	int oldlen	= _Length;
 	if (_free && _Arr != p)
 	{
 		// Release(); 会动标志位 不能用它
-		delete _Arr;
+		delete[] (byte*)_Arr;
 	}
 
 	_Arr		= (char*)p;
-	_Capacity	= sz;
-	_Length		= oldlen;
+	_Capacity	= len;
+	_Length		= oldlen < len ? oldlen : len;
+	_canWrite	= true;
 
 	// _needFree 由Alloc决定
 	// 有可能当前用的内存不是内部内存，然后要分配的内存小于内部内存，则直接使用内部，不需要释放
@@ -317,13 +357,48 @@ bool Array::CheckCapacity(int len, int bak)
 	return true;
 }
 
+// 预留容量，一次分配到位，避免后面多次扩容
+bool Array::Reserve(int len)
+{
+	if(_Arr && len <= _Capacity && _canWrite) return true;
+	if(!Expand) return false;
+
+	return Realloc(len, _Length);
+}
+
+// 释放多余容量。只处理堆内存，内存区和外部缓冲区不归自己管
+void Array::ShrinkToFit()
+{
+	if(!_Arr || !_needFree || _Length >= _Capacity) return;
+
+	// 按实际长度重新分配，小数据搬回内部缓冲区
+	int len	= _Length > 0 ? _Length : 1;
+	Realloc(len, _Length, false);
+}
+
 void* Array::Alloc(int len)
 {
+	// 没有指定内存区时，作用域内的栈上对象使用当前内存区
+	auto arena	= Arena ? Arena : MemoryArena::Find(this);
+	if(arena)
+	{
+		auto p	= arena->Alloc(_Size * len);
+		if(p)
+		{
+			Arena	= arena;
+			_needFree	= false;
+			return p;
+		}
+	}
+
 	_needFree	= true;
 
 	return new byte[_Size * len];
 }
 
+// 运行时没有提供时，不支持原地调整
+WEAK bool ResizeInPlace(void* ptr, int size) { return false; }
+
 bool operator==(const Array& bs1, const Array& bs2)
 {
 	if(bs1.Length() != bs2.Length()) return false;
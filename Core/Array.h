@@ -3,11 +3,14 @@
 
 #include "Buffer.h"
 
+class MemoryArena;
+
 // 变长数组。自动扩容
 class Array : public Buffer
 {
 public:
 	bool	Expand;	// 是否可扩容
+	MemoryArena*	Arena;	// 临时内存区。非空时扩容从这里分配，随内存区整体释放
 	
 	// 数组最大容量。初始化时决定，后面不允许改变
 	inline int Capacity() const { return _Capacity; }
@@ -47,6 +50,11 @@ public:
 	// 设置指定位置的值，不足时自动扩容
 	virtual void SetItemAt(int i, const void* item);
 
+	// 预留容量，一次分配到位，避免后面多次扩容
+	virtual bool Reserve(int len);
+	// 释放多余容量，小数据可能搬回内部缓冲区
+	virtual void ShrinkToFit();
+
     // 重载索引运算符[]，返回指定元素的第一个字节
     byte operator[](int i) const;
     byte& operator[](int i);
@@ -69,6 +77,8 @@ protected:
 
 	// 检查容量。如果不足则扩大，并备份指定长度的数据
 	bool CheckCapacity(int len, int bak);
+	// 调整容量为指定大小，并备份指定长度的数据。inplace表示优先原地调整
+	bool Realloc(int len, int bak, bool inplace = true);
 	virtual void* Alloc(int len);
 	// 释放已占用内存
 	virtual bool Release();
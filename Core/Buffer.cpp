@@ -7,6 +7,8 @@
 #include "_Core.h"
 
 #include "Buffer.h"
+#include "Convert.h"
+#include "MemSearch.h"
 #include "SString.h"
 
 /******************************** Buffer ********************************/
@@ -251,21 +253,15 @@ const Buffer Buffer::Sub(int index, int len) const
 // 显示十六进制数据，指定分隔字符
 String& Buffer::ToHex(String& str, char sep, int newLine) const
 {
-	auto buf = GetBuffer();
+	int len = Length();
+	if (len <= 0) return str;
 
-	// 拼接在字符串后面
-	for (int i = 0; i < Length(); i++, buf++)
-	{
-		if (i)
-		{
-			if (newLine > 0 && i % newLine == 0)
-				str += "\r\n";
-			else if (sep != '\0')
-				str += sep;
-		}
+	// 一次预留好空间，查表直接写到字符串末尾。SetLength要求长度小于容量，多预留一个字节免得再次扩容
+	int old = str.Length();
+	int n = Convert::HexLength(len, sep, newLine);
+	if (!str.Reserve(old + n + 1) || !str.SetLength(old + n)) return str;
 
-		str.Concat(*buf, -16);
-	}
+	Convert::ToHex(GetBuffer(), len, (char*)str.GetBuffer() + old, sep, newLine);
 
 	return str;
 }
@@ -281,6 +277,31 @@ String Buffer::ToHex(char sep, int newLine) const
 	return str;
 }
 
+// 显示Base64编码，带=填充
+String& Buffer::ToBase64(String& str) const
+{
+	int len = Length();
+	if (len <= 0) return str;
+
+	int old = str.Length();
+	int n = Convert::Base64Length(len);
+	if (!str.Reserve(old + n + 1) || !str.SetLength(old + n)) return str;
+
+	Convert::ToBase64(GetBuffer(), len, (char*)str.GetBuffer() + old);
+
+	return str;
+}
+
+// 显示Base64编码
+String Buffer::ToBase64() const
+{
+	String str;
+
+	ToBase64(str);
+
+	return str;
+}
+
 ushort	Buffer::ToUInt16(int offset, bool isLittleEndian) const
 {
 	auto p = GetBuffer() + offset;
@@ -391,12 +412,9 @@ int Buffer::CompareTo(const void* ptr, int len) const
 	int count = _Length;
 	if (count > len)	count = len;
 
-	// 遍历每一个字符
-	for (cstring p1 = _Arr, p2 = (cstring)ptr; count > 0; count--, p1++, p2++)
-	{
-		int n = *p1 - *p2;
-		if (n) return n;
-	}
+	// 按字比较，找到第一个不同的字节
+	int n = MemSearch::Compare(_Arr, ptr, count);
+	if (n) return n;
 
 	// 判断剩余长度，以此决定大小
 	return _Length - len;
@@ -81,6 +81,10 @@ public:
 	String& ToHex(String& str, char sep = 0, int newLine = 0) const;
 	// 显示十六进制数据，指定分隔字符和换行长度
 	String ToHex(char sep = 0, int newLine = 0) const;
+	// 显示Base64编码
+	String& ToBase64(String& str) const;
+	// 显示Base64编码
+	String ToBase64() const;
 
 	ushort	ToUInt16(int offset = 0, bool isLittleEndian = true) const;
 	uint	ToUInt32(int offset = 0, bool isLittleEndian = true) const;
@@ -0,0 +1,122 @@
+﻿#include "_Core.h"
+
+#include "BufferChain.h"
+
+/******************************** BufferChain ********************************/
+
+BufferChain::BufferChain()
+{
+	_Count		= 0;
+	_HeadLen	= 0;
+}
+
+BufferChain::BufferChain(const Buffer& bs)
+{
+	_Count		= 0;
+	_HeadLen	= 0;
+
+	Add(bs);
+}
+
+int BufferChain::Count() const { return _Count + (_HeadLen ? 1 : 0); }
+
+int BufferChain::Length() const
+{
+	int len	= _HeadLen;
+	for(int i=0; i<_Count; i++) len	+= _Segs[i].Len;
+
+	return len;
+}
+
+const Buffer BufferChain::operator[](int index) const
+{
+	// 头部数据在预留空间末尾
+	if(_HeadLen)
+	{
+		if(index == 0) return Buffer((void*)(_Head + Headroom - _HeadLen), _HeadLen);
+		index--;
+	}
+
+	assert(index >= 0 && index < _Count, "BufferChain[index]");
+
+	auto& seg	= _Segs[index];
+	return Buffer((void*)seg.Ptr, seg.Len);
+}
+
+bool BufferChain::Add(const Buffer& bs)
+{
+	return Add(bs.GetBuffer(), bs.Length());
+}
+
+bool BufferChain::Add(const void* ptr, int len)
+{
+	if(!ptr || len <= 0) return true;
+
+	assert(_Count < MaxSegments, "BufferChain 段数超标");
+	if(_Count >= MaxSegments) return false;
+
+	auto& seg	= _Segs[_Count++];
+	seg.Ptr	= (const byte*)ptr;
+	seg.Len	= len;
+
+	return true;
+}
+
+bool BufferChain::Prepend(const Buffer& bs)
+{
+	int len	= bs.Length();
+	auto p	= Prepend(len);
+	if(!p) return false;
+
+	Buffer::Copy(p, bs.GetBuffer(), len);
+
+	return true;
+}
+
+byte* BufferChain::Prepend(int len)
+{
+	assert(_HeadLen + len <= Headroom, "BufferChain 头部空间不足");
+	if(len < 0 || _HeadLen + len > Headroom) return nullptr;
+
+	// 从后往前占用，外层协议头总是在内层前面
+	_HeadLen	+= len;
+
+	return _Head + Headroom - _HeadLen;
+}
+
+int BufferChain::CopyTo(Buffer& bs, int offset) const
+{
+	auto p		= bs.GetBuffer();
+	int remain	= bs.Length();
+	int count	= 0;
+	int n		= Count();
+	for(int i=0; i<n && remain > 0; i++)
+	{
+		auto& seg	= (*this)[i];
+		int len	= seg.Length();
+
+		// 跳过偏移之前的段
+		if(offset >= len)
+		{
+			offset	-= len;
+			continue;
+		}
+
+		len	-= offset;
+		if(len > remain) len	= remain;
+		Buffer::Copy(p, seg.GetBuffer() + offset, len);
+
+		p		+= len;
+		remain	-= len;
+		count	+= len;
+		offset	= 0;
+	}
+
+	return count;
+}
+
+void BufferChain::Clear()
+{
+	_Count		= 0;
+	_HeadLen	= 0;
+}
@@ -0,0 +1,53 @@
+﻿#ifndef __BufferChain_H__
+#define __BufferChain_H__
+
+#include "Type.h"
+#include "Buffer.h"
+
+// 分段缓冲区链。若干段内存串成一个逻辑数据包，发送时逐段写出，不必先合并成连续内存
+// 协议头部拷贝到内部预留空间，可以逐层往前追加；负载只引用不拷贝，引用的内存必须在发送完成前有效
+class BufferChain
+{
+public:
+	static const int MaxSegments	= 6;	// 最多引用段数，不含头部
+	static const int Headroom		= 16;	// 头部预留空间
+
+	BufferChain();
+	// 包装单段数据
+	explicit BufferChain(const Buffer& bs);
+
+	// 段数，头部算一段
+	int Count() const;
+	// 总长度
+	int Length() const;
+	// 头部长度，也就是组包时拷贝的字节数
+	inline int HeadLength() const { return _HeadLen; }
+	// 获取指定段
+	const Buffer operator[](int index) const;
+
+	// 在后面追加一段，只引用不拷贝。空数据忽略
+	bool Add(const Buffer& bs);
+	bool Add(const void* ptr, int len);
+	// 在最前面插入头部，拷贝到预留空间
+	bool Prepend(const Buffer& bs);
+	// 在最前面预留头部空间，返回可写指针，空间不足返回空
+	byte* Prepend(int len);
+
+	// 合并拷贝到连续缓冲区，从指定偏移开始，返回拷贝字节数
+	int CopyTo(Buffer& bs, int offset = 0) const;
+	void Clear();
+
+private:
+	struct Segment
+	{
+		const byte*	Ptr;
+		int			Len;
+	};
+
+	Segment	_Segs[MaxSegments];
+	byte	_Count;
+	byte	_HeadLen;
+	byte	_Head[Headroom];
+};
+
+#endif
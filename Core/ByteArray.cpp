@@ -97,10 +97,7 @@ void* ByteArray::Alloc(int len)
 		return Arr;
 	}
 	else
-	{
-		_needFree	= true;
-		return new byte[len];
-	}
+		return Array::Alloc(len);
 }
 
 ByteArray& ByteArray::operator = (const Buffer& rhs)
@@ -0,0 +1,384 @@
+﻿#include <math.h>
+
+#include "_Core.h"
+
+#include "Convert.h"
+
+// 十六进制字符表
+static const char _HexUpper[]	= "0123456789ABCDEF";
+static const char _HexLower[]	= "0123456789abcdef";
+
+// 00到99的两位十进制字符表，每次查表输出两位
+static const char _Pairs[]	=
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+// Base64字符表
+static const char _Base64[]	= "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Base64反查表，0xFF表示非法字符
+static const byte _Base64Index[128]	=
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+	0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// 10的幂，定点小数的放大倍数
+static const uint _Pow10[]	= { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+/******************************** 十六进制 ********************************/
+
+int Convert::HexLength(int len, char sep, int newLine)
+{
+	if(len <= 0) return 0;
+
+	// 换行处用\r\n，其它间隔用分隔符
+	int lines	= newLine > 0 ? (len - 1) / newLine : 0;
+	int n	= (len << 1) + (lines << 1);
+	if(sep) n	+= len - 1 - lines;
+
+	return n;
+}
+
+int Convert::ToHex(const void* ptr, int len, char* str, char sep, int newLine, bool upper)
+{
+	if(!ptr || len <= 0) return 0;
+
+	auto s		= (const byte*)ptr;
+	auto hex	= upper ? _HexUpper : _HexLower;
+	auto p		= str;
+
+	// 不带分隔的最常见，单独一个紧凑循环
+	if(!sep && newLine <= 0)
+	{
+		for(auto e = s + len; s < e; s++)
+		{
+			*p++	= hex[*s >> 4];
+			*p++	= hex[*s & 0x0F];
+		}
+		return len << 1;
+	}
+
+	for(int i = 0; i < len; i++, s++)
+	{
+		if(i)
+		{
+			if(newLine > 0 && i % newLine == 0)
+			{
+				*p++	= '\r';
+				*p++	= '\n';
+			}
+			else if(sep)
+				*p++	= sep;
+		}
+		*p++	= hex[*s >> 4];
+		*p++	= hex[*s & 0x0F];
+	}
+
+	return p - str;
+}
+
+int Convert::ToHex(uint value, int size, char* str, bool upper)
+{
+	auto hex	= upper ? _HexUpper : _HexLower;
+	int n	= size << 1;
+
+	// 从低位往高位，倒着写
+	for(auto p = str + n; p > str; value >>= 4)
+	{
+		*--p	= hex[value & 0x0F];
+	}
+
+	return n;
+}
+
+/******************************** Base64 ********************************/
+
+int Convert::ToBase64(const void* ptr, int len, char* str)
+{
+	if(!ptr || len <= 0) return 0;
+
+	auto s	= (const byte*)ptr;
+	auto p	= str;
+
+	// 每3字节拼成24位，拆成4个6位
+	for(; len >= 3; len -= 3, s += 3)
+	{
+		uint v	= (s[0] << 16) | (s[1] << 8) | s[2];
+		*p++	= _Base64[v >> 18];
+		*p++	= _Base64[(v >> 12) & 0x3F];
+		*p++	= _Base64[(v >> 6) & 0x3F];
+		*p++	= _Base64[v & 0x3F];
+	}
+
+	// 剩余1或2字节，补=
+	if(len > 0)
+	{
+		uint v	= s[0] << 16;
+		if(len > 1) v	|= s[1] << 8;
+
+		*p++	= _Base64[v >> 18];
+		*p++	= _Base64[(v >> 12) & 0x3F];
+		*p++	= len > 1 ? _Base64[(v >> 6) & 0x3F] : '=';
+		*p++	= '=';
+	}
+
+	return p - str;
+}
+
+int Convert::FromBase64(cstring str, int len, void* buf, int size)
+{
+	if(!str || !buf) return -1;
+
+	auto p	= (byte*)buf;
+	auto e	= p + size;
+	uint v	= 0;
+	int n	= 0;
+	for(int i = 0; i < len; i++)
+	{
+		byte c	= str[i];
+		if(c == '=') break;
+		if(c == ' ' || c == '\r' || c == '\n' || c == '\t') continue;
+
+		byte d	= c < 0x80 ? _Base64Index[c] : 0xFF;
+		if(d == 0xFF) return -1;
+
+		// 凑够4个字符输出3字节
+		v	= (v << 6) | d;
+		if(++n == 4)
+		{
+			if(p + 3 > e) return -1;
+
+			*p++	= v >> 16;
+			*p++	= v >> 8;
+			*p++	= v;
+			v	= 0;
+			n	= 0;
+		}
+	}
+
+	// 剩余2或3个字符，对应1或2字节
+	if(n == 1) return -1;
+	if(n > 1)
+	{
+		if(p + n - 1 > e) return -1;
+
+		v	<<= (4 - n) * 6;
+		*p++	= v >> 16;
+		if(n == 3) *p++	= v >> 8;
+	}
+
+	return p - (byte*)buf;
+}
+
+/******************************** 十进制 ********************************/
+
+static inline int DecimalLength(uint value)
+{
+	if(value < 10) return 1;
+	if(value < 100) return 2;
+	if(value < 1000) return 3;
+	if(value < 10000) return 4;
+	if(value < 100000) return 5;
+	if(value < 1000000) return 6;
+	if(value < 10000000) return 7;
+	if(value < 100000000) return 8;
+	if(value < 1000000000) return 9;
+
+	return 10;
+}
+
+// 从末尾往前，每次输出两位
+static inline void WritePairs(uint value, char* end)
+{
+	auto p	= end;
+	while(value >= 100)
+	{
+		auto d	= _Pairs + (value % 100) * 2;
+		value	/= 100;
+		*--p	= d[1];
+		*--p	= d[0];
+	}
+	if(value >= 10)
+	{
+		auto d	= _Pairs + value * 2;
+		*--p	= d[1];
+		*--p	= d[0];
+	}
+	else
+		*--p	= '0' + value;
+}
+
+// 固定输出8位，不足补0
+static inline void Write8(uint value, char* str)
+{
+	for(auto p = str + 8; p > str; value /= 100)
+	{
+		auto d	= _Pairs + (value % 100) * 2;
+		*--p	= d[1];
+		*--p	= d[0];
+	}
+}
+
+int Convert::ToDecimal(uint value, char* str)
+{
+	int n	= DecimalLength(value);
+	WritePairs(value, str + n);
+
+	return n;
+}
+
+int Convert::ToDecimal(int value, char* str)
+{
+	if(value >= 0) return ToDecimal((uint)value, str);
+
+	*str	= '-';
+	return ToDecimal(0U - (uint)value, str + 1) + 1;
+}
+
+int Convert::ToDecimal(UInt64 value, char* str)
+{
+	if(value <= 0xFFFFFFFF) return ToDecimal((uint)value, str);
+
+	// 每次拆出低8位，64位除法次数降到最少
+	int n	= ToDecimal(value / 100000000, str);
+	Write8((uint)(value % 100000000), str + n);
+
+	return n + 8;
+}
+
+int Convert::ToDecimal(Int64 value, char* str)
+{
+	if(value >= 0) return ToDecimal((UInt64)value, str);
+
+	*str	= '-';
+	return ToDecimal(0ULL - (UInt64)value, str + 1) + 1;
+}
+
+/******************************** 定点小数 ********************************/
+
+static int WriteNaN(double value, char* str)
+{
+	auto s	= value != value ? "NaN" : (value < 0 ? "-Inf" : "Inf");
+	auto p	= str;
+	while(*s) *p++	= *s++;
+
+	return p - str;
+}
+
+// 整数部分和放大后的小数部分拼起来，去掉小数末尾的0
+static int WriteFixed(char* str, char* p, UInt64 ip, uint frac, int decimalPlaces)
+{
+	// 四舍五入后为0时不要负号
+	if(!ip && !frac) p	= str;
+
+	p	+= Convert::ToDecimal(ip, p);
+
+	if(frac)
+	{
+		while(frac % 10 == 0)
+		{
+			frac	/= 10;
+			decimalPlaces--;
+		}
+
+		// 小数部分右对齐，前面补0
+		*p++	= '.';
+		auto e	= p + decimalPlaces;
+		for(auto q = e; q > p; frac /= 10)
+		{
+			*--q	= '0' + frac % 10;
+		}
+		p	= e;
+	}
+
+	return p - str;
+}
+
+int Convert::ToFixed(float value, int decimalPlaces, char* str)
+{
+	// 超出32位整数范围，以及非数字和无穷大，交给双精度处理
+	if(!(value > -4.0e9f && value < 4.0e9f)) return ToFixed((double)value, decimalPlaces, str);
+
+	if(decimalPlaces < 0) decimalPlaces	= 0;
+	if(decimalPlaces > 9) decimalPlaces	= 9;
+
+	auto p	= str;
+	if(value < 0)
+	{
+		*p++	= '-';
+		value	= -value;
+	}
+
+	// 全部用单精度计算，避免软件模拟双精度
+	auto ip		= (uint)value;
+	auto scale	= _Pow10[decimalPlaces];
+	auto frac	= (uint)((value - ip) * scale + 0.5f);
+	if(frac >= scale)
+	{
+		ip++;
+		frac	-= scale;
+	}
+
+	return WriteFixed(str, p, ip, frac, decimalPlaces);
+}
+
+int Convert::ToFixed(double value, int decimalPlaces, char* str)
+{
+	// 非数字和无穷大
+	if(value - value != 0) return WriteNaN(value, str);
+
+	if(decimalPlaces < 0) decimalPlaces	= 0;
+	if(decimalPlaces > 9) decimalPlaces	= 9;
+
+	auto p	= str;
+	if(value < 0)
+	{
+		*p++	= '-';
+		value	= -value;
+	}
+
+	// 超出64位整数的很少见，按科学计数法输出，保证不超过MaxFixed
+	int exp	= 0;
+	if(value >= 1e19)
+	{
+		exp		= (int)log10(value);
+		value	/= pow(10.0, exp);
+		if(value >= 10)
+		{
+			value	/= 10;
+			exp++;
+		}
+	}
+
+	auto ip		= (UInt64)value;
+	auto scale	= _Pow10[decimalPlaces];
+	auto frac	= (uint)((value - ip) * scale + 0.5);
+	if(frac >= scale)
+	{
+		ip++;
+		frac	-= scale;
+	}
+	if(!exp) return WriteFixed(str, p, ip, frac, decimalPlaces);
+
+	// 尾数进位到10
+	if(ip >= 10)
+	{
+		ip	= 1;
+		exp++;
+	}
+	p	= str + WriteFixed(str, p, ip, frac, decimalPlaces);
+	*p++	= 'e';
+	p	+= ToDecimal(exp, p);
+
+	return p - str;
+}
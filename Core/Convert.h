@@ -0,0 +1,42 @@
+﻿#ifndef __Convert_H__
+#define __Convert_H__
+
+#include "Type.h"
+
+// 格式化转换。查表输出十六进制/Base64，整数每次处理两位十进制，浮点数按定点整数输出
+// 全部直接写入调用方预留好的缓冲区，不加结束符，返回写入字符数
+// 消息日志、Json和LinkClient上报都要大量拼接数字和十六进制，避免临时缓冲区和逐字节追加
+class Convert
+{
+public:
+	// 十进制最大字符数，含负号
+	static const int MaxDecimal	= 21;
+	// 定点浮点数最大字符数，含负号、小数点和9位小数
+	static const int MaxFixed	= 32;
+
+	// 十六进制字符数，指定分隔字符和换行长度
+	static int HexLength(int len, char sep = 0, int newLine = 0);
+	// 输出十六进制，指定分隔字符和换行长度。缓冲区不少于HexLength
+	static int ToHex(const void* ptr, int len, char* str, char sep = 0, int newLine = 0, bool upper = true);
+	// 整数输出为固定长度的十六进制，size为字节数，高位在前
+	static int ToHex(uint value, int size, char* str, bool upper = true);
+
+	// Base64字符数，带填充
+	static int Base64Length(int len) { return (len + 2) / 3 * 4; }
+	// 输出标准Base64，带=填充
+	static int ToBase64(const void* ptr, int len, char* str);
+	// 解析Base64，跳过空白，遇到=结束。返回字节数，非法字符或缓冲区不足返回-1
+	static int FromBase64(cstring str, int len, void* buf, int size);
+
+	// 输出十进制。缓冲区不少于MaxDecimal
+	static int ToDecimal(uint value, char* str);
+	static int ToDecimal(int value, char* str);
+	static int ToDecimal(UInt64 value, char* str);
+	static int ToDecimal(Int64 value, char* str);
+
+	// 输出定点小数，最多9位小数，四舍五入并去掉末尾的0。缓冲区不少于MaxFixed
+	static int ToFixed(float value, int decimalPlaces, char* str);
+	static int ToFixed(double value, int decimalPlaces, char* str);
+};
+
+#endif
@@ -31,6 +31,20 @@ protected:
 	}
 };
 
+// 成员函数包装。把成员函数编译成第一参数为目标对象的静态函数
+// 成员函数指针在不同编译器下大小和布局都不一样，不能强转成普通指针保存，而静态函数可以
+template<typename TMethod> struct MethodThunk;
+
+template<typename T, typename TReturn, typename... TArgs>
+struct MethodThunk<TReturn(T::*)(TArgs...)>
+{
+	template<TReturn(T::*Func)(TArgs...)>
+	static TReturn Call(void* target, TArgs... args) { return (((T*)target)->*Func)(args...); }
+};
+
+// 成员函数对应的静态函数，func必须是编译时常量，如 MethodOf(&TokenClient::OnReceive)
+#define MethodOf(func) (MethodThunk<decltype(func)>::template Call<func>)
+
 // 委托。第一参数目标对象指针，第二泛型参数
 template <typename TArg>
 class Delegate : public IDelegate
@@ -41,7 +55,7 @@ public:
 
 	using IDelegate::Bind;
 
-	Delegate()	{ Bind(nullptr, nullptr); }
+	Delegate()	{ IDelegate::Bind(nullptr, nullptr); }
 	Delegate(const Delegate& dlg)	= delete;
 
 	// 全局函数或类静态函数
@@ -54,17 +68,17 @@ public:
 	template<typename T>
 	Delegate(void(*func)(T&, TArg), T* target)	{ Bind((void*)func, target); }
 
-	// 类成员函数
-	// func是一个对象，对象值为函数指针，但是不能直接转为void*，所以需要通过指针转为别的类型，再转回来才能赋值
-	template<typename T>
-	Delegate(void(T::*func)(TArg), T* target)	{ Bind((void*)*(int*)&func, target); }
+	// 类成员函数。用MethodOf(&T::Func)在编译时生成带目标参数的静态函数
+	Delegate(VAction func, void* target)	{ Bind((void*)func, target); }
 
 	void Bind(Action func)	{ Bind((void*)func); }
 	void Bind(TAction func)	{ Bind((void*)func); }
 	template<typename T>
 	void Bind(void(*func)(T&, TArg), T* target)	{ Bind((void*)func, target); }
-	template<typename T>
-	void Bind(void(T::*func)(TArg), T* target)	{ Bind((void*)*(int*)&func, target); }
+	void Bind(VAction func, void* target)	{ Bind((void*)func, target); }
+	// 类成员函数，编译时绑定，重载的成员函数也能按参数选对。如 Bind<Button, &Button::OnPress>(this)
+	template<typename T, void(T::*Func)(TArg)>
+	void Bind(T* target)	{ IDelegate::Bind((void*)&MethodThunk<void(T::*)(TArg)>::template Call<Func>, target); }
 
 	// 执行委托
 	void operator()(TArg arg)
@@ -89,7 +103,7 @@ public:
 
 	using IDelegate::Bind;
 
-	Delegate2()	{ Bind(nullptr, nullptr); }
+	Delegate2()	{ IDelegate::Bind(nullptr, nullptr); }
 	Delegate2(const Delegate2& dlg)	= delete;
 
 	// 全局函数或类静态函数
@@ -104,16 +118,17 @@ public:
 	template<typename T>
 	Delegate2(void(*func)(T&, TArg, TArg2), T* target)	{ Bind((void*)func, target); }
 
-	// 类成员函数
-	template<typename T>
-	Delegate2(void(T::*func)(TArg, TArg2), T* target)	{ Bind((void*)*(int*)&func, target); }
+	// 类成员函数。用MethodOf(&T::Func)在编译时生成带目标参数的静态函数
+	Delegate2(VAction func, void* target)	{ Bind((void*)func, target); }
 
 	void Bind(Action2 func)	{ Bind((void*)func); }
 	void Bind(TAction func)	{ Bind((void*)func); }
 	template<typename T>
 	void Bind(void(*func)(T&, TArg, TArg2), T* target)	{ Bind((void*)func, target); }
-	template<typename T>
-	void Bind(void(T::*func)(TArg, TArg2), T* target)	{ Bind((void*)*(int*)&func, target); }
+	void Bind(VAction func, void* target)	{ Bind((void*)func, target); }
+	// 类成员函数，编译时绑定，重载的成员函数也能按参数选对。如 Bind<Button, &Button::OnPress>(this)
+	template<typename T, void(T::*Func)(TArg, TArg2)>
+	void Bind(T* target)	{ IDelegate::Bind((void*)&MethodThunk<void(T::*)(TArg, TArg2)>::template Call<Func>, target); }
 
 	// 执行委托
 	void operator()(TArg arg, TArg2 arg2)
@@ -138,7 +153,7 @@ public:
 
 	using IDelegate::Bind;
 
-	Delegate3()	{ Bind(nullptr, nullptr); }
+	Delegate3()	{ IDelegate::Bind(nullptr, nullptr); }
 	Delegate3(const Delegate3& dlg)	= delete;
 
 	// 全局函数或类静态函数
@@ -151,16 +166,17 @@ public:
 	template<typename T>
 	Delegate3(void(*func)(T&, TArg, TArg2, TArg3), T* target)	{ Bind((void*)func, target); }
 
-	// 类成员函数
-	template<typename T>
-	Delegate3(void(T::*func)(TArg, TArg2, TArg3), T* target)	{ Bind((void*)*(int*)&func, target); }
+	// 类成员函数。用MethodOf(&T::Func)在编译时生成带目标参数的静态函数
+	Delegate3(VAction func, void* target)	{ Bind((void*)func, target); }
 
 	void Bind(Action3 func)	{ Bind((void*)func); }
 	void Bind(TAction func)	{ Bind((void*)func); }
 	template<typename T>
 	void Bind(void(*func)(T&, TArg, TArg2, TArg3), T* target)	{ Bind((void*)func, target); }
-	template<typename T>
-	void Bind(void(T::*func)(TArg, TArg2, TArg3), T* target)	{ Bind((void*)*(int*)&func, target); }
+	void Bind(VAction func, void* target)	{ Bind((void*)func, target); }
+	// 类成员函数，编译时绑定，重载的成员函数也能按参数选对。如 Bind<Button, &Button::OnPress>(this)
+	template<typename T, void(T::*Func)(TArg, TArg2, TArg3)>
+	void Bind(T* target)	{ IDelegate::Bind((void*)&MethodThunk<void(T::*)(TArg, TArg2, TArg3)>::template Call<Func>, target); }
 
 	// 执行委托
 	void operator()(TArg arg, TArg2 arg2, TArg3 arg3)
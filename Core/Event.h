@@ -0,0 +1,154 @@
+﻿#ifndef _Event_H_
+#define _Event_H_
+
+#include "Delegate.h"
+
+template<typename... TArgs> class Event;
+
+// 事件订阅节点。放在订阅者内部，订阅和退订都不需要分配内存
+// 节点析构时自动退订，订阅者销毁后不会留下野指针
+template<typename... TArgs>
+class EventNode
+{
+	friend class Event<TArgs...>;
+
+public:
+	typedef void(*TAction)(TArgs...);
+	typedef void(*VAction)(void*, TArgs...);
+
+	EventNode()	{ Method = nullptr; Target = nullptr; Prev = Next = this; }
+	EventNode(const EventNode& node) = delete;
+	~EventNode()	{ Unlink(); }
+
+	// 全局函数或类静态函数
+	void Bind(TAction func)	{ Method = (void*)func; Target = nullptr; }
+	// 类成员函数，用MethodOf(&T::Func)生成
+	void Bind(VAction func, void* target)	{ Method = (void*)func; Target = target; }
+	// 类成员函数，编译时绑定
+	template<typename T, void(T::*Func)(TArgs...)>
+	void Bind(T* target)	{ Bind(&MethodThunk<void(T::*)(TArgs...)>::template Call<Func>, target); }
+
+	// 是否已订阅
+	bool Linked() const	{ return Next != this; }
+	// 退订
+	void Unlink()
+	{
+		Prev->Next	= Next;
+		Next->Prev	= Prev;
+		Prev = Next	= this;
+	}
+
+private:
+	EventNode*	Prev;
+	EventNode*	Next;
+	void*	Method;
+	void*	Target;
+
+	void Invoke(TArgs... args)
+	{
+		if(Target)
+			((VAction)Method)(Target, args...);
+		else
+			((TAction)Method)(args...);
+	}
+};
+
+// 多播事件。订阅节点串成环形双向链表，订阅退订都是O(1)，触发时顺序调用
+// 内置一个默认节点，兼容原来单播委托的 = 写法，Add追加更多订阅者
+template<typename... TArgs>
+class Event
+{
+public:
+	typedef EventNode<TArgs...>	Node;
+	typedef typename Node::TAction	TAction;
+	typedef typename Node::VAction	VAction;
+
+	Event()	{ }
+	Event(const Event& evt) = delete;
+	~Event()	{ Clear(); }
+
+	// 设置默认处理者，为空时取消
+	Event& operator=(TAction func)	{ _Default.Bind(func); Attach(); return *this; }
+	// 兼容各种委托，参数类型由委托自己保证
+	Event& operator=(const IDelegate& dlg)
+	{
+		_Default.Method	= dlg.Method;
+		_Default.Target	= dlg.Target;
+		Attach();
+
+		return *this;
+	}
+	void Bind(VAction func, void* target)	{ _Default.Bind(func, target); Attach(); }
+	template<typename T, void(T::*Func)(TArgs...)>
+	void Bind(T* target)	{ _Default.template Bind<T, Func>(target); Attach(); }
+
+	// 追加订阅者，已在别的事件里的先退订
+	void Add(Node& node)
+	{
+		node.Unlink();
+
+		node.Prev	= _Head.Prev;
+		node.Next	= &_Head;
+		_Head.Prev->Next	= &node;
+		_Head.Prev	= &node;
+	}
+	// 退订
+	void Remove(Node& node)	{ node.Unlink(); }
+	// 退订所有订阅者
+	void Clear()	{ while(_Head.Next != &_Head) _Head.Next->Unlink(); }
+
+	// 订阅者个数
+	int Count() const
+	{
+		int n	= 0;
+		for(auto node = _Head.Next; node != &_Head; node = node->Next)
+		{
+			if(node->Method) n++;
+		}
+
+		return n;
+	}
+
+	explicit operator bool() const	{ return _Head.Next != &_Head; }
+	bool operator !() const	{ return _Head.Next == &_Head; }
+
+	// 触发事件。当前节点后面插一个栈上的游标，处理函数里退订或者销毁任何订阅者都不影响遍历
+	// 游标没有处理函数，嵌套触发时跳过
+	void operator()(TArgs... args)
+	{
+		Node cursor;
+		for(auto node = _Head.Next; node != &_Head; )
+		{
+			cursor.Prev	= node;
+			cursor.Next	= node->Next;
+			node->Next->Prev	= &cursor;
+			node->Next	= &cursor;
+
+			if(node->Method) node->Invoke(args...);
+
+			// 处理函数里清空了事件
+			if(!cursor.Linked()) break;
+
+			node	= cursor.Next;
+			cursor.Unlink();
+		}
+	}
+
+private:
+	Node	_Head;		// 链表头，不参与调用
+	Node	_Default;	// 默认节点，总是排在最前面
+
+	// 默认节点有处理函数时挂到最前面，否则退订
+	void Attach()
+	{
+		_Default.Unlink();
+		if(!_Default.Method) return;
+
+		_Default.Prev	= &_Head;
+		_Default.Next	= _Head.Next;
+		_Head.Next->Prev	= &_Default;
+		_Head.Next	= &_Default;
+	}
+};
+
+#endif
@@ -0,0 +1,119 @@
+﻿#include <string.h>
+
+#include "_Core.h"
+
+#include "Intern.h"
+
+#define INTERN_BUCKETS	32
+
+// 驻留条目。静态字符串直接引用原处，否则拷贝紧跟在条目后面
+struct InternItem
+{
+	InternItem*	Next;
+	uint		Hash;
+	int			Length;
+	cstring		Str;
+};
+
+static InternItem*	_Buckets[INTERN_BUCKETS];
+static int			_Count	= 0;
+
+/******************************** Intern ********************************/
+
+uint Intern::Hash(cstring str, int len)
+{
+	uint hash	= 2166136261U;
+	if(!str) return hash;
+
+	auto p	= (const byte*)str;
+	if(len < 0)
+	{
+		for(; *p; p++) hash	= (hash ^ *p) * 16777619U;
+	}
+	else
+	{
+		for(auto e = p + len; p < e; p++) hash	= (hash ^ *p) * 16777619U;
+	}
+
+	return hash;
+}
+
+cstring Intern::Find(cstring str, int len)
+{
+	if(!str) return nullptr;
+	if(len < 0) len	= strlen(str);
+
+	return Find(str, len, Hash(str, len));
+}
+
+cstring Intern::Find(cstring str, int len, uint hash)
+{
+	if(!str) return nullptr;
+	if(len < 0) len	= strlen(str);
+
+	// 先比哈希和长度，都相同才比内容
+	for(auto item = _Buckets[hash & (INTERN_BUCKETS - 1)]; item; item = item->Next)
+	{
+		if(item->Hash == hash && item->Length == len && memcmp(item->Str, str, len) == 0) return item->Str;
+	}
+
+	return nullptr;
+}
+
+cstring Intern::Add(cstring str, int len)
+{
+	if(!str) return nullptr;
+	if(len < 0) len	= strlen(str);
+
+	uint hash	= Hash(str, len);
+	auto rs	= Find(str, len, hash);
+	if(rs) return rs;
+
+	// 条目和字符串一次申请
+	auto buf	= new byte[sizeof(InternItem) + len + 1];
+	auto item	= (InternItem*)buf;
+	auto p		= (char*)&item[1];
+	memcpy(p, str, len);
+	p[len]	= '\0';
+
+	item->Hash		= hash;
+	item->Length	= len;
+	item->Str		= p;
+
+	auto& head	= _Buckets[hash & (INTERN_BUCKETS - 1)];
+	item->Next	= head;
+	head	= item;
+	_Count++;
+
+	return p;
+}
+
+cstring Intern::Static(cstring str)
+{
+	if(!str) return nullptr;
+
+	return Static(str, Hash(str, -1));
+}
+
+cstring Intern::Static(cstring str, uint hash)
+{
+	if(!str) return nullptr;
+
+	int len	= strlen(str);
+	auto rs	= Find(str, len, hash);
+	if(rs) return rs;
+
+	auto item	= new InternItem();
+	item->Hash		= hash;
+	item->Length	= len;
+	item->Str		= str;
+
+	auto& head	= _Buckets[hash & (INTERN_BUCKETS - 1)];
+	item->Next	= head;
+	head	= item;
+	_Count++;
+
+	return str;
+}
+
+int Intern::Count() { return _Count; }
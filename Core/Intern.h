@@ -0,0 +1,39 @@
+﻿#ifndef __Intern_H__
+#define __Intern_H__
+
+#include "Type.h"
+
+// 编译期计算字符串哈希，FNV-1a，与Intern::Hash结果一致
+// 可用于switch的case标签，例如 case HashOf("Device/Login"):
+constexpr uint HashOf(cstring str, uint hash = 2166136261U)
+{
+	return *str ? HashOf(str + 1, (hash ^ (byte)*str) * 16777619U) : hash;
+}
+
+// 字符串驻留池。相同内容只保留一份，驻留后的名称直接按指针比较
+// 路由表、端口表等以驻留指针为键，查找时先把外来字符串换成驻留指针，再按指针匹配
+// 池按哈希分桶，条目只增不减，只适合有限的名称集合，不要驻留任意外部数据
+class Intern
+{
+public:
+	// 驻留字符串，不存在时拷贝一份。返回池中唯一指针
+	static cstring Add(cstring str, int len = -1);
+	// 驻留静态字符串，直接引用不拷贝。字符串必须常驻，例如字面量
+	static cstring Static(cstring str);
+	static cstring Static(cstring str, uint hash);
+
+	// 查找已驻留的字符串，不存在返回nullptr，不会添加
+	static cstring Find(cstring str, int len = -1);
+	static cstring Find(cstring str, int len, uint hash);
+
+	// 运行期计算哈希，len为-1时算到零结束符
+	static uint Hash(cstring str, int len = -1);
+	// 驻留字符串个数
+	static int Count();
+};
+
+// 驻留字面量，哈希在编译期算好
+template<uint H> struct HashValue { static const uint Value = H; };
+#define INTERN(str) Intern::Static(str, HashValue<HashOf(str)>::Value)
+
+#endif
@@ -176,22 +176,57 @@ bool IList::CheckCapacity(int count)
 	// 是否超出容量
 	if(_Arr && count <= _Capacity) return true;
 
-	// 自动计算合适的容量
-	int sz = 0x40 >> 2;
-	while(sz < count) sz <<= 1;
+	// 按1.5倍扩容
+	int sz = _Capacity + (_Capacity >> 1);
+	if(sz < (0x40 >> 2)) sz = 0x40 >> 2;
+	if(sz < count) sz = count;
 
-	void* p = new byte[sz << 2];
+	return Realloc(sz);
+}
+
+// 调整容量为指定大小。内部缓冲区放得下就用内部的，堆上的先试试原地调整
+bool IList::Realloc(int count)
+{
+	void* p = nullptr;
+	if(count <= ArrayLength(Arr))
+	{
+		p	= Arr;
+		count	= ArrayLength(Arr);
+	}
+	else if(_Arr != Arr && ResizeInPlace(_Arr, count << 2))
+	{
+		_Capacity	= count;
+		return true;
+	}
+	else
+		p	= new byte[count << 2];
 	if(!p) return false;
 
 	// 需要备份数据
-	if(_Count > 0 && _Arr)
+	if(_Count > 0 && _Arr && _Arr != p)
 		// 为了安全，按照字节拷贝
-		Buffer(p, sz << 2).Copy(0, _Arr, _Count << 2);
+		Buffer(p, count << 2).Copy(0, _Arr, _Count << 2);
 
 	if(_Arr && _Arr != Arr) delete[] _Arr;
 
 	_Arr		= (void**)p;
-	_Capacity	= sz;
+	_Capacity	= count;
 
 	return true;
 }
+
+// 预留容量，一次分配到位
+bool IList::Reserve(int count)
+{
+	if(count <= _Capacity) return true;
+
+	return Realloc(count);
+}
+
+// 释放多余容量，元素不多时搬回内部缓冲区
+void IList::ShrinkToFit()
+{
+	if(_Arr == Arr || _Count >= _Capacity) return;
+
+	Realloc(_Count);
+}
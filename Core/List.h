@@ -39,6 +39,11 @@ public:
 	// 释放所有指针指向的内存
 	IList& DeleteAll();
 
+	// 预留容量，一次分配到位
+	bool Reserve(int count);
+	// 释放多余容量，元素不多时搬回内部缓冲区
+	void ShrinkToFit();
+
     // 重载索引运算符[]，返回指定元素的第一个
     void* operator[](int i) const;
     void*& operator[](int i);
@@ -56,6 +61,7 @@ private:
 
 	void Init();
 	bool CheckCapacity(int count);
+	bool Realloc(int count);
 	void move(IList& list);
 };
 
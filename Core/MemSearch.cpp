@@ -0,0 +1,231 @@
+﻿#include <string.h>
+
+#include "_Core.h"
+
+#include "MemSearch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MEM_SSE2 1
+#endif
+
+// 每个字节都是1/0x80的掩码，用于判断字中是否有零字节
+#define ONES	0x01010101U
+#define HIGHS	0x80808080U
+
+static inline bool HasZero(uint v) { return ((v - ONES) & ~v & HIGHS) != 0; }
+
+/******************************** MemSearch ********************************/
+
+int MemSearch::IndexOf(const void* ptr, int len, byte item)
+{
+	if(!ptr || len <= 0) return -1;
+
+	auto s	= (const byte*)ptr;
+	auto p	= s;
+	auto e	= s + len;
+
+#if MEM_SSE2
+	// 主机上一次比较16字节
+	auto ch	= _mm_set1_epi8((char)item);
+	for(; p + 16 <= e; p += 16)
+	{
+		int mask	= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), ch));
+		if(mask)
+		{
+			int i	= 0;
+			while(!(mask & 1)) { mask >>= 1; i++; }
+			return p - s + i;
+		}
+	}
+#else
+	// 先逐字节走到字对齐
+	for(; p < e && ((size_t)p & 3); p++)
+	{
+		if(*p == item) return p - s;
+	}
+
+	// 字对齐后每次检查4个字节，异或后出现零字节说明命中
+	uint mask	= item * ONES;
+	for(; p + 4 <= e; p += 4)
+	{
+		if(HasZero(*(const uint*)p ^ mask)) break;
+	}
+#endif
+
+	// 命中所在的字或者尾部，逐字节确定位置
+	for(; p < e; p++)
+	{
+		if(*p == item) return p - s;
+	}
+
+	return -1;
+}
+
+int MemSearch::LastIndexOf(const void* ptr, int len, byte item)
+{
+	if(!ptr || len <= 0) return -1;
+
+	auto s	= (const byte*)ptr;
+	auto p	= s + len;
+
+	// 尾部逐字节走到字对齐
+	for(; p > s && ((size_t)p & 3); )
+	{
+		if(*--p == item) return p - s;
+	}
+
+	uint mask	= item * ONES;
+	for(; p - 4 >= s; p -= 4)
+	{
+		if(HasZero(*(const uint*)(p - 4) ^ mask)) break;
+	}
+
+	for(; p > s; )
+	{
+		if(*--p == item) return p - s;
+	}
+
+	return -1;
+}
+
+int MemSearch::IndexOf(const void* ptr, int len, const void* sub, int sublen)
+{
+	if(!ptr || !sub || sublen > len) return -1;
+	if(sublen <= 0) return 0;
+
+	auto s	= (const byte*)ptr;
+	auto k	= (const byte*)sub;
+	byte first	= k[0];
+	int end	= len - sublen;
+
+	// 并行找首字节，再比较剩余部分
+	for(int i = 0; i <= end; i++)
+	{
+		int p	= IndexOf(s + i, end - i + 1, first);
+		if(p < 0) return -1;
+
+		i	+= p;
+		if(Compare(s + i + 1, k + 1, sublen - 1) == 0) return i;
+	}
+
+	return -1;
+}
+
+int MemSearch::LastIndexOf(const void* ptr, int len, const void* sub, int sublen)
+{
+	if(!ptr || !sub || sublen > len) return -1;
+	if(sublen <= 0) return len;
+
+	auto s	= (const byte*)ptr;
+	auto k	= (const byte*)sub;
+	byte first	= k[0];
+
+	// 首字节可能出现的最后位置往前找
+	for(int n = len - sublen + 1; n > 0; )
+	{
+		int p	= LastIndexOf(s, n, first);
+		if(p < 0) return -1;
+
+		if(Compare(s + p + 1, k + 1, sublen - 1) == 0) return p;
+		n	= p;
+	}
+
+	return -1;
+}
+
+int MemSearch::Compare(const void* p1, const void* p2, int len)
+{
+	if(len <= 0 || p1 == p2) return 0;
+
+	auto a	= (const byte*)p1;
+	auto b	= (const byte*)p2;
+	auto e	= a + len;
+
+#if MEM_SSE2
+	for(; a + 16 <= e; a += 16, b += 16)
+	{
+		auto va	= _mm_loadu_si128((const __m128i*)a);
+		auto vb	= _mm_loadu_si128((const __m128i*)b);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) break;
+	}
+#else
+	// 两边对齐方式相同时才能按字比较，否则M0上非对齐访问会异常
+	if((((size_t)a ^ (size_t)b) & 3) == 0)
+	{
+		for(; a < e && ((size_t)a & 3); a++, b++)
+		{
+			if(*a != *b) return *a - *b;
+		}
+		for(; a + 4 <= e; a += 4, b += 4)
+		{
+			if(*(const uint*)a != *(const uint*)b) break;
+		}
+	}
+#endif
+
+	// 不同的字或者尾部，逐字节比较
+	for(; a < e; a++, b++)
+	{
+		if(*a != *b) return *a - *b;
+	}
+
+	return 0;
+}
+
+/******************************** SearchPattern ********************************/
+
+SearchPattern::SearchPattern(cstring str)
+{
+	Init(str, str ? strlen(str) : 0);
+}
+
+SearchPattern::SearchPattern(const void* ptr, int len)
+{
+	Init(ptr, len);
+}
+
+void SearchPattern::Init(const void* ptr, int len)
+{
+	if(len > 0xFF) len	= 0xFF;
+	if(!ptr) len	= 0;
+
+	_Ptr	= (const byte*)ptr;
+	_Length	= len;
+
+	// 默认跳过整个关键字长度
+	for(int i = 0; i < (int)sizeof(_Skip); i++) _Skip[i]	= len;
+
+	// 最后一个字符以外，越靠后的字符跳距越小。同桶取最小值，保证不会跳过匹配
+	for(int i = 0; i < len - 1; i++)
+	{
+		auto& n	= _Skip[_Ptr[i] & 0x1F];
+		byte v	= len - 1 - i;
+		if(v < n) n	= v;
+	}
+}
+
+int SearchPattern::IndexOf(const void* ptr, int len, int startIndex) const
+{
+	int m	= _Length;
+	if(!ptr || startIndex < 0) return -1;
+	if(m == 0) return startIndex <= len ? startIndex : -1;
+	// 太短的关键字，跳转收益不如并行找首字节
+	if(m < 3)
+	{
+		int p	= MemSearch::IndexOf((const byte*)ptr + startIndex, len - startIndex, _Ptr, m);
+		return p >= 0 ? p + startIndex : -1;
+	}
+
+	auto s	= (const byte*)ptr;
+	byte last	= _Ptr[m - 1];
+	for(int i = startIndex; i + m <= len; )
+	{
+		byte ch	= s[i + m - 1];
+		if(ch == last && MemSearch::Compare(s + i, _Ptr, m - 1) == 0) return i;
+
+		i	+= _Skip[ch & 0x1F];
+	}
+
+	return -1;
+}
@@ -0,0 +1,46 @@
+﻿#ifndef __MemSearch_H__
+#define __MemSearch_H__
+
+#include "Type.h"
+
+// 内存查找与比较。按字（4字节）并行处理，一次比较4个字节
+// 接收缓冲区里找"OK"、"+IPD"、"\r\n"这类关键字时，比逐字节循环快得多
+class MemSearch
+{
+public:
+	// 查找字节，返回位置，找不到返回-1
+	static int IndexOf(const void* ptr, int len, byte item);
+	// 从后往前查找字节
+	static int LastIndexOf(const void* ptr, int len, byte item);
+	// 查找子串
+	static int IndexOf(const void* ptr, int len, const void* sub, int sublen);
+	// 从后往前查找子串
+	static int LastIndexOf(const void* ptr, int len, const void* sub, int sublen);
+	// 比较两段内存，按无符号字节比较，返回第一个不同字节之差
+	static int Compare(const void* p1, const void* p2, int len);
+};
+
+// 预计算查找模式。Horspool算法，按最后一个字符跳转
+// 用于反复查找的固定关键字，跳转表只算一次。表按字符低5位分桶，冲突时取较小跳距，只有32字节
+// 关键字不拷贝，必须比模式活得更久，长度不超过255
+class SearchPattern
+{
+public:
+	SearchPattern(cstring str);
+	SearchPattern(const void* ptr, int len);
+
+	inline int Length() const { return _Length; }
+	inline cstring GetBuffer() const { return (cstring)_Ptr; }
+
+	// 在数据区中查找，返回位置，找不到返回-1
+	int IndexOf(const void* ptr, int len, int startIndex = 0) const;
+
+private:
+	const byte*	_Ptr;
+	byte	_Length;
+	byte	_Skip[32];
+
+	void Init(const void* ptr, int len);
+};
+
+#endif
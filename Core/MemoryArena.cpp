@@ -0,0 +1,175 @@
+﻿#include "_Core.h"
+
+#include "MemoryArena.h"
+
+#define ARENA_ALIGN	4
+
+static inline int Align(int size) { return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1); }
+
+MemoryArena* MemoryArena::Current	= nullptr;
+
+static inline byte* DataOf(void* chunk, int head) { return (byte*)chunk + head; }
+
+MemoryArena::MemoryArena(int chunkSize)
+{
+	Init(chunkSize);
+}
+
+MemoryArena::MemoryArena(void* buf, int len, int chunkSize)
+{
+	Init(chunkSize);
+
+	// 外部缓冲区对齐后放一个块头
+	int pad	= (int)((size_t)buf & (ARENA_ALIGN - 1));
+	if(pad) pad	= ARENA_ALIGN - pad;
+	auto p	= (byte*)buf + pad;
+	len	-= pad;
+	if(len > (int)sizeof(Chunk))
+	{
+		auto ck		= (Chunk*)p;
+		ck->Next	= nullptr;
+		ck->Size	= len - sizeof(Chunk);
+		ck->Used	= 0;
+
+		_Head	= ck;
+		_First	= ck;
+	}
+}
+
+void MemoryArena::Init(int chunkSize)
+{
+	_Head		= nullptr;
+	_First		= nullptr;
+	_ChunkSize	= chunkSize;
+	_Allocs		= 0;
+	_Last		= nullptr;
+	_Top		= nullptr;
+	_Owner		= nullptr;
+}
+
+MemoryArena::~MemoryArena()
+{
+	Reset();
+}
+
+void* MemoryArena::Alloc(int size)
+{
+	if(size <= 0) size	= ARENA_ALIGN;
+	size	= Align(size);
+
+	auto ck	= _Head;
+	if(!ck || ck->Used + size > ck->Size)
+	{
+		// 当前块不够，申请新块。大块单独一块
+		int len	= size > _ChunkSize ? size : _ChunkSize;
+		ck	= (Chunk*)new byte[sizeof(Chunk) + len];
+		if(!ck) return nullptr;
+
+		ck->Next	= _Head;
+		ck->Size	= len;
+		ck->Used	= 0;
+		_Head	= ck;
+	}
+
+	auto p	= DataOf(ck, sizeof(Chunk)) + ck->Used;
+	ck->Used	+= size;
+	_Allocs++;
+	_Last	= p;
+
+	return p;
+}
+
+bool MemoryArena::Resize(void* ptr, int oldSize, int size)
+{
+	auto ck	= _Head;
+	if(!ptr || !ck || ptr != _Last) return false;
+
+	int used	= (byte*)ptr - DataOf(ck, sizeof(Chunk)) + Align(size);
+	if(used > ck->Size) return false;
+
+	ck->Used	= used;
+
+	return true;
+}
+
+bool MemoryArena::Contains(const void* ptr) const
+{
+	for(auto ck = _Head; ck; ck = ck->Next)
+	{
+		auto p	= DataOf(ck, sizeof(Chunk));
+		if(ptr >= p && ptr < p + ck->Size) return true;
+	}
+
+	return false;
+}
+
+void MemoryArena::Reset()
+{
+	// 堆上的块全部释放，外部缓冲区块保留
+	auto ck	= _Head;
+	while(ck && ck != _First)
+	{
+		auto next	= ck->Next;
+		delete[] (byte*)ck;
+		ck	= next;
+	}
+
+	_Head	= _First;
+	if(_First) _First->Used	= 0;
+	_Last	= nullptr;
+}
+
+int MemoryArena::Used() const
+{
+	int n	= 0;
+	for(auto ck = _Head; ck; ck = ck->Next) n	+= ck->Used;
+
+	return n;
+}
+
+int MemoryArena::Chunks() const
+{
+	int n	= 0;
+	for(auto ck = _Head; ck && ck != _First; ck = ck->Next) n++;
+
+	return n;
+}
+
+MemoryArena* MemoryArena::Find(const void* obj)
+{
+	auto arena	= Current;
+	if(!arena) return nullptr;
+
+	// 中断和其它线程的栈对象可能也在这段地址上，只认打开作用域的上下文
+	auto ctx	= ArenaContext();
+	if(!ctx || ctx != arena->_Owner) return nullptr;
+
+	// 当前栈顶到作用域之间的对象，一定先于作用域销毁
+	byte mark;
+	if(obj < (void*)&mark || obj >= arena->_Top) return nullptr;
+
+	return arena;
+}
+
+// 内核没有提供时，只有一个执行上下文
+WEAK const void* ArenaContext() { return &MemoryArena::Current; }
+
+/******************************** ArenaScope ********************************/
+
+ArenaScope::ArenaScope(MemoryArena& arena)
+{
+	_Prev		= MemoryArena::Current;
+	_PrevTop	= arena._Top;
+	_PrevOwner	= arena._Owner;
+
+	arena._Top		= this;
+	arena._Owner	= ArenaContext();
+	MemoryArena::Current	= &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+	MemoryArena::Current->_Top		= _PrevTop;
+	MemoryArena::Current->_Owner	= _PrevOwner;
+	MemoryArena::Current	= _Prev;
+}
@@ -0,0 +1,80 @@
+﻿#ifndef __MemoryArena_H__
+#define __MemoryArena_H__
+
+#include "Type.h"
+
+// 内存区。按指针递增分配，不单独释放，用完整体释放
+// 适合处理一条消息时产生的临时对象，比逐个new/delete少得多的堆操作，也没有碎片
+// 首块可以用栈上的缓冲区，不够时从堆上申请新块串起来
+class MemoryArena
+{
+public:
+	// 使用堆上的块，每块至少chunkSize字节
+	MemoryArena(int chunkSize = 0x100);
+	// 首块使用外部缓冲区，一般在栈上
+	MemoryArena(void* buf, int len, int chunkSize = 0x100);
+	MemoryArena(const MemoryArena& arena) = delete;
+	~MemoryArena();
+
+	// 分配内存，4字节对齐
+	void* Alloc(int size);
+	// 原地调整最后一次分配的大小，不是最后一次或者空间不足时失败
+	bool Resize(void* ptr, int oldSize, int size);
+	// 指针是否在本内存区
+	bool Contains(const void* ptr) const;
+
+	// 释放所有分配，首块保留复用
+	void Reset();
+
+	int Used() const;	// 已分配字节数
+	int Chunks() const;	// 块数，不含外部缓冲区
+	int Allocs() const { return _Allocs; }	// 分配次数
+
+	// 当前内存区。由ArenaScope安装，作用域内栈上的Array/String/MemoryStream扩容时从这里分配
+	static MemoryArena* Current;
+	// 查找对象可用的当前内存区。只有打开作用域的那个上下文里、作用域内栈上的对象才能用
+	// 中断和其它线程里的对象，以及堆上和静态对象返回空
+	static MemoryArena* Find(const void* obj);
+
+private:
+	friend class ArenaScope;
+
+	// 块头，数据紧随其后
+	struct Chunk
+	{
+		Chunk*	Next;
+		int		Size;	// 数据区大小
+		int		Used;	// 已用
+	};
+
+	Chunk*	_Head;		// 当前块，新块插在头部
+	Chunk*	_First;		// 外部缓冲区块
+	int		_ChunkSize;
+	int		_Allocs;
+	void*	_Last;		// 最后一次分配的地址
+	void*	_Top;		// 作用域所在栈位置，比它深的栈上对象才在作用域内
+	const void*	_Owner;	// 打开作用域的执行上下文
+
+	void Init(int chunkSize);
+};
+
+// 内存区作用域。构造时安装为当前内存区，析构时恢复
+// 作用域内新建的临时对象从内存区分配，生命周期不能超出作用域。超出的对象在堆上或者静态区，不受影响
+// 栈按向下增长判断，同一个栈上的嵌套任务也在作用域内，它们同样先于作用域结束
+// 中断和抢占的线程可能落在同一段栈地址上，按执行上下文区分，它们不使用内存区
+class ArenaScope
+{
+public:
+	ArenaScope(MemoryArena& arena);
+	~ArenaScope();
+
+private:
+	MemoryArena*	_Prev;
+	void*			_PrevTop;
+	const void*		_PrevOwner;
+};
+
+// 当前执行上下文，由内核提供。中断里返回空，不能使用内存区
+const void* ArenaContext();
+
+#endif
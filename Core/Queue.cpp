@@ -3,6 +3,7 @@
 
 extern void EnterCritical();
 extern void ExitCritical();
+extern int AtomicAdd(volatile int* ptr, int value);
 
 Queue::Queue() : _s((void*)nullptr, 0)
 {
@@ -35,24 +36,21 @@ INROOT void Queue::Enqueue(byte dat)
 	// 除法运算是一个超级大祸害，它浪费了大量时间，导致串口中断接收丢数据
 	if(_head >= total) _head -= total;
 
-	EnterCritical();
-	_size++;
-	ExitCritical();
+	AtomicAdd(&_size, 1);
 }
 
 INROOT byte Queue::Dequeue()
 {
 	if(_size == 0) return 0;
 
-	EnterCritical();
-	_size--;
-	ExitCritical();
+	AtomicAdd(&_size, -1);
 
 	/*
 	昨晚发现串口频繁收发一段数据后出现丢数据现象，也即是size为0，然后tail比head小，刚开始小一个字节，然后会逐步拉大。
 	经过分析得知，ARM指令没有递加递减指令，更没有原子操作。
 	size拿出来减一，然后再保存回去，但是保存回去之前，串口接收中断写入，拿到了旧的size，导致最后的size比原计划要小1。
 	该问题只能通过关闭中断来解决。为了减少关中断时间以提升性能，增加了专门的Read方法。
+	现在改用原子操作，M3/M4上不再关中断。
 	*/
 
 	int total	= _s.Capacity();
@@ -106,9 +104,7 @@ int Queue::Write(const Buffer& bs)
 		_head	= 0;
 	}
 
-	EnterCritical();
-	_size += rs;
-	ExitCritical();
+	AtomicAdd(&_size, rs);
 
 	return rs;
 }
@@ -155,12 +151,19 @@ int Queue::Read(Buffer& bs)
 
 	bs.SetLength(rs);
 
-	EnterCritical();
-	_size -= rs;
-	ExitCritical();
+	AtomicAdd(&_size, -rs);
 
 	return rs;
 }
 
 WEAK void EnterCritical() { }
 WEAK void ExitCritical() { }
+WEAK int AtomicAdd(volatile int* ptr, int value)
+{
+	EnterCritical();
+	int v	= *ptr + value;
+	*ptr	= v;
+	ExitCritical();
+
+	return v;
+}
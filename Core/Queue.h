@@ -11,7 +11,7 @@ private:
 	Array _s;	// 数据流
 	int _head;		// 头部位置
     int _tail;		// 尾部位置
-	int _size;		// 长度
+	volatile int _size;	// 长度。中断与任务共享，原子修改
 
 public:
 	Queue();
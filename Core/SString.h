@@ -38,6 +38,10 @@ public:
 	inline cstring GetBuffer() const { return (cstring)_Arr; }
 	// 设置数组长度。改变长度后，确保最后以0结尾
 	virtual bool SetLength(int length, bool bak);
+	// 预留容量，不含结尾的0
+	virtual bool Reserve(int size);
+	// 释放多余容量，确保最后以0结尾
+	virtual void ShrinkToFit();
 
 	// 拷贝数据，默认-1长度表示当前长度
 	virtual int Copy(int destIndex, const void* src, int len);
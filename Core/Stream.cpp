@@ -4,6 +4,7 @@
 
 #include "ByteArray.h"
 #include "SString.h"
+#include "MemoryArena.h"
 
 #include "Stream.h"
 
@@ -324,17 +325,25 @@ MemoryStream::MemoryStream(int len) : Stream(_Arr, ArrayLength(_Arr))
 {
 	Length = 0;
 	_needFree = false;
+	Arena = MemoryArena::Find(this);
 	if (len > ArrayLength(_Arr))
 	{
-		byte* buf = new byte[len];
-		Init(buf, len);
-		_needFree = true;
+		byte* buf = Arena ? (byte*)Arena->Alloc(len) : nullptr;
+		if (buf)
+			Init(buf, len);
+		else
+		{
+			buf = new byte[len];
+			Init(buf, len);
+			_needFree = true;
+		}
 	}
 }
 
 MemoryStream::MemoryStream(void* buf, int len) : Stream(buf, len)
 {
 	_needFree = false;
+	Arena = MemoryArena::Find(this);
 }
 
 // 销毁数据流
@@ -355,21 +364,43 @@ bool MemoryStream::CheckRemain(int count)
 	{
 		if (!CanResize) return Stream::CheckRemain(count);
 
-		// 原始容量成倍扩容
+		// 原始容量按1.5倍扩容
 		int total = _Position + count;
-		int size = _Capacity;
+		int size = _Capacity + (_Capacity >> 1);
 		if (size < 0x10) size = 0x10;
-		while (size < total) size <<= 1;
+		if (size < total) size = total;
+
+		// 先试试原地扩容，省掉一次分配和拷贝
+		bool rs = false;
+		if (_Buffer != _Arr)
+		{
+			if (_needFree)
+				rs = ResizeInPlace(_Buffer, size);
+			else if (Arena)
+				rs = Arena->Resize(_Buffer, _Capacity, size);
+		}
+		if (rs)
+		{
+			_Capacity = size;
+			return true;
+		}
 
 		// 申请新的空间，并复制数据
-		byte* bufNew = new byte[size];
+		bool fr = true;
+		byte* bufNew = nullptr;
+		if (Arena)
+		{
+			bufNew = (byte*)Arena->Alloc(size);
+			if (bufNew) fr = false;
+		}
+		if (!bufNew) bufNew = new byte[size];
 		if (Length > 0) Buffer(_Buffer, Length).CopyTo(0, bufNew, -1);
 
 		if (_Buffer != _Arr && _needFree == true) delete[] _Buffer;
 
 		_Buffer = bufNew;
 		_Capacity = size;
-		_needFree = true;
+		_needFree = fr;
 	}
 
 	return true;
@@ -1,6 +1,8 @@
 ﻿#ifndef _Stream_H_
 #define _Stream_H_
 
+class MemoryArena;
+
 // 数据流
 // 数据流内有一个缓冲区，游标位置，数据长度。实际有效数据仅占用缓冲区中间部分，头尾都可能有剩余
 class Stream
@@ -108,6 +110,8 @@ private:
 	virtual bool CheckRemain(int count);
 
 public:
+	MemoryArena*	Arena;	// 临时内存区。非空时扩容从这里分配，随内存区整体释放
+
 	// 分配指定大小的数据流
 	MemoryStream(int len = 0);
 	// 使用缓冲区初始化数据流，支持自动扩容
@@ -13,6 +13,8 @@
 #include "_Core.h"
 
 #include "ByteArray.h"
+#include "Convert.h"
+#include "MemSearch.h"
 
 #include "SString.h"
 
@@ -194,6 +196,30 @@ bool String::CheckCapacity(int size)
 	return true;
 }
 
+// 预留容量，多留一个字节给结尾的0
+bool String::Reserve(int size)
+{
+	if (_Arr && size <= _Capacity && _canWrite) return true;
+
+	if (!Array::Reserve(size + 1)) return false;
+
+	_Capacity--;
+	_Arr[_Length] = '\0';
+
+	return true;
+}
+
+// 释放多余容量
+void String::ShrinkToFit()
+{
+	if (!_Arr || !_needFree || _Length >= _Capacity) return;
+
+	if (!Realloc(_Length + 1, _Length, false)) return;
+
+	_Capacity--;
+	_Arr[_Length] = '\0';
+}
+
 void* String::Alloc(int len)
 {
 	if (len <= (int)sizeof(Arr))
@@ -202,10 +228,7 @@ void* String::Alloc(int len)
 		return Arr;
 	}
 	else
-	{
-		_needFree = true;
-		return new byte[len];
-	}
+		return Array::Alloc(len);
 }
 
 String& String::copy(cstring cstr, int length)
@@ -374,20 +397,13 @@ bool String::Concat(byte num, int radix)
 	{
 		if (!CheckCapacity(_Length + (sizeof(num) << 1))) return false;
 
-		utohex(num, sizeof(num), _Arr + _Length, radix < 0);
-		_Length += (sizeof(num) << 1);
+		_Length += Convert::ToHex(num, sizeof(num), _Arr + _Length, radix < 0);
+		_Arr[_Length] = '\0';
 
 		return true;
 	}
 
-	char buf[1 + 3 * sizeof(byte)];
-#if defined(_MSC_VER)
-	_itoa_s(num, buf, sizeof(buf), radix);
-#else
-	itoa(num, buf, radix);
-#endif
-
-	return Concat(buf, strlen(buf));
+	return Concat((uint)num, radix);
 }
 
 bool String::Concat(short num, int radix)
@@ -395,13 +411,7 @@ bool String::Concat(short num, int radix)
 	// 十六进制固定长度
 	if (radix == 16 || radix == -16) return Concat((ushort)num, radix);
 
-	char buf[2 + 3 * sizeof(int)];
-#if defined(_MSC_VER)
-	_itoa_s(num, buf, sizeof(buf), radix);
-#else
-	itoa(num, buf, radix);
-#endif
-	return Concat(buf, strlen(buf));
+	return Concat((int)num, radix);
 }
 
 bool String::Concat(ushort num, int radix)
@@ -411,15 +421,13 @@ bool String::Concat(ushort num, int radix)
 	{
 		if (!CheckCapacity(_Length + (sizeof(num) << 1))) return false;
 
-		utohex(num, sizeof(num), _Arr + _Length, radix < 0);
-		_Length += (sizeof(num) << 1);
+		_Length += Convert::ToHex(num, sizeof(num), _Arr + _Length, radix < 0);
+		_Arr[_Length] = '\0';
 
 		return true;
 	}
 
-	char buf[2 + 3 * sizeof(int)];
-	utoa(num, buf, radix);
-	return Concat(buf, strlen(buf));
+	return Concat((uint)num, radix);
 }
 
 bool String::Concat(int num, int radix)
@@ -427,6 +435,17 @@ bool String::Concat(int num, int radix)
 	// 十六进制固定长度
 	if (radix == 16 || radix == -16) return Concat((uint)num, radix);
 
+	// 十进制直接写到末尾，不经过临时缓冲区
+	if (radix == 10)
+	{
+		if (!CheckCapacity(_Length + Convert::MaxDecimal)) return false;
+
+		_Length += Convert::ToDecimal(num, _Arr + _Length);
+		_Arr[_Length] = '\0';
+
+		return true;
+	}
+
 	char buf[2 + 3 * sizeof(int)];
 #if defined(_MSC_VER)
 	_itoa_s(num, buf, sizeof(buf), radix);
@@ -443,8 +462,18 @@ bool String::Concat(uint num, int radix)
 	{
 		if (!CheckCapacity(_Length + (sizeof(num) << 1))) return false;
 
-		utohex(num, sizeof(num), _Arr + _Length, radix < 0);
-		_Length += (sizeof(num) << 1);
+		_Length += Convert::ToHex(num, sizeof(num), _Arr + _Length, radix < 0);
+		_Arr[_Length] = '\0';
+
+		return true;
+	}
+
+	if (radix == 10)
+	{
+		if (!CheckCapacity(_Length + Convert::MaxDecimal)) return false;
+
+		_Length += Convert::ToDecimal(num, _Arr + _Length);
+		_Arr[_Length] = '\0';
 
 		return true;
 	}
@@ -459,6 +488,16 @@ bool String::Concat(Int64 num, int radix)
 	// 十六进制固定长度
 	if (radix == 16 || radix == -16) return Concat((UInt64)num, radix);
 
+	if (radix == 10)
+	{
+		if (!CheckCapacity(_Length + Convert::MaxDecimal)) return false;
+
+		_Length += Convert::ToDecimal(num, _Arr + _Length);
+		_Arr[_Length] = '\0';
+
+		return true;
+	}
+
 	char buf[2 + 3 * sizeof(Int64)];
 	ltoa(num, buf, radix);
 	return Concat(buf, strlen(buf));
@@ -471,76 +510,47 @@ bool String::Concat(UInt64 num, int radix)
 	{
 		if (!CheckCapacity(_Length + (sizeof(num) << 1))) return false;
 
-		utohex((int)(num >> 32), sizeof(num) >> 1, _Arr + _Length, radix < 0);
-		_Length += sizeof(num);
-		utohex((int)(num & 0xFFFFFFFF), sizeof(num) >> 1, _Arr + _Length, radix < 0);
-		_Length += sizeof(num);
+		_Length += Convert::ToHex((uint)(num >> 32), sizeof(num) >> 1, _Arr + _Length, radix < 0);
+		_Length += Convert::ToHex((uint)(num & 0xFFFFFFFF), sizeof(num) >> 1, _Arr + _Length, radix < 0);
+		_Arr[_Length] = '\0';
 
 		return true;
 	}
 
-	char buf[1 + 3 * sizeof(UInt64)];
-	ultoa(num, buf, radix);
-	return Concat(buf, strlen(buf));
-}
-
-static char* ftoa(char* str, int len, double num, int prec)
-{
-	// 先计算整数部分，连符号一起计算了
-	// 在逐级计算小数点后
-	int n = (int)num;
-	num -= n;
-	if (num < 0)num = -num;
-
-	// 整数部分
-	ltoa((Int64)n, str, 10);
-
-	if (prec > 0 && num > 0.0)
+	if (radix == 10)
 	{
-		// 小数部分
-		int slen = strlen(str);
-		int m = 10;
-		while (--prec > 0) m *= 10;
-
-		str[slen++] = '.';
-		ltoa((Int64)(m*num), str + slen, 10);
-		slen = strlen(str);
-		/*for (int i = 0; i < prec; i++)
-		{
-			num *= 10;
-			n = (int)num;
-			num -= n;
-			str[slen++] = '0' + n;
-		}
-		str[slen] = 0;*/
+		if (!CheckCapacity(_Length + Convert::MaxDecimal)) return false;
 
-		// 干掉后面多余的0
-		for (int i = slen - 1; i >= 0 && str[i] == '0'; i--, slen--)
-		{
-			str[i] = '\0';
-		}
-		if (str[slen - 1] == '.') str[slen - 1] = '\0';
+		_Length += Convert::ToDecimal(num, _Arr + _Length);
+		_Arr[_Length] = '\0';
+
+		return true;
 	}
 
-	return str;
+	char buf[1 + 3 * sizeof(UInt64)];
+	ultoa(num, buf, radix);
+	return Concat(buf, strlen(buf));
 }
 
+// 定点输出，单精度全程不用双精度运算
 bool String::Concat(float num, int decimalPlaces)
 {
-	char buf[20];
-	//dtostrf(num, decimalPlaces, buf, sizeof(buf));
-	//sprintf(buf, "%f", num);
-	ftoa(buf, sizeof(buf), num, decimalPlaces);
-	return Concat(buf, strlen(buf));
+	if (!CheckCapacity(_Length + Convert::MaxFixed)) return false;
+
+	_Length += Convert::ToFixed(num, decimalPlaces, _Arr + _Length);
+	_Arr[_Length] = '\0';
+
+	return true;
 }
 
 bool String::Concat(double num, int decimalPlaces)
 {
-	char buf[20];
-	//dtostrf(num, decimalPlaces, buf, sizeof(buf));
-	//sprintf(buf, "%f", num);
-	ftoa(buf, sizeof(buf), num, decimalPlaces);
-	return Concat(buf, strlen(buf));
+	if (!CheckCapacity(_Length + Convert::MaxFixed)) return false;
+
+	_Length += Convert::ToFixed(num, decimalPlaces, _Arr + _Length);
+	_Arr[_Length] = '\0';
+
+	return true;
 }
 
 int String::CompareTo(const String& s) const
@@ -796,12 +806,9 @@ int String::IndexOf(const char ch, int startIndex) const
 	if (startIndex < 0) return -1;
 	if (startIndex >= _Length) return -1;
 
-	for (int i = startIndex; i < _Length; i++)
-	{
-		if (_Arr[i] == ch) return i;
-	}
+	int p = MemSearch::IndexOf(_Arr + startIndex, _Length - startIndex, ch);
 
-	return -1;
+	return p >= 0 ? p + startIndex : -1;
 }
 
 int String::IndexOf(const String& str, int startIndex) const
@@ -817,12 +824,11 @@ int String::IndexOf(cstring str, int startIndex) const
 int String::LastIndexOf(const char ch, int startIndex) const
 {
 	if (startIndex >= _Length) return -1;
+	if (startIndex < 0) startIndex = 0;
 
-	for (int i = _Length - 1; i >= startIndex; i--)
-	{
-		if (_Arr[i] == ch) return i;
-	}
-	return -1;
+	int p = MemSearch::LastIndexOf(_Arr + startIndex, _Length - startIndex, ch);
+
+	return p >= 0 ? p + startIndex : -1;
 }
 
 int String::LastIndexOf(const String& str, int startIndex) const
@@ -844,25 +850,12 @@ int String::Search(cstring str, int len, int startIndex, bool rev) const
 	int count = _Length - len;
 	if (startIndex > count) return -1;
 
-	// 遍历源字符串
+	// 按字并行找首字符，再比较剩余部分
 	auto s = _Arr + startIndex;
-	auto e = _Arr + _Length - 1;
-	auto p = rev ? e : s;
-	for (int i = 0; i <= count; i++)
-	{
-		// 最大比较个数以目标字符串为准，源字符串确保长度足够
-		if (strncmp(p, str, len) == 0) return p - _Arr;
+	int p = rev ? MemSearch::LastIndexOf(s, _Length - startIndex, str, len)
+		: MemSearch::IndexOf(s, _Length - startIndex, str, len);
 
-		if (rev)
-		{
-			if (--p < s) break;
-		}
-		else
-		{
-			if (++p > e) break;
-		}
-	}
-	return -1;
+	return p >= 0 ? p + startIndex : -1;
 }
 
 bool String::Contains(const String& str) const { return IndexOf(str) >= 0; }
@@ -1084,21 +1077,7 @@ char* utohex(uint value, byte size, char* string, bool upper)
 {
 	if (string == nullptr) return 0;
 
-	// 字节数乘以2是字符个数
-	size <<= 1;
-	// 指针提前指向最后一个字符，数字从小往大处理，字符需要倒过来赋值
-	auto tp = string + size;;
-	*tp-- = '\0';
-	char ch = upper ? 'A' : 'a';
-	for (int i = 0; i < size; i++)
-	{
-		byte bt = value & 0x0F;
-		value >>= 4;
-		if (bt < 10)
-			*tp-- = bt + '0';
-		else
-			*tp-- = bt + ch - 10;
-	}
+	string[Convert::ToHex(value, size, string, upper)] = '\0';
 
 	return string;
 }
@@ -0,0 +1,282 @@
+﻿#include <string.h>
+
+#include "_Core.h"
+
+#include "StringView.h"
+#include "MemSearch.h"
+
+static inline bool isSpace(char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\v' || ch == '\f'; }
+static inline char toLower(char ch) { return ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch; }
+
+/******************************** StringView ********************************/
+
+StringView::StringView(cstring str)
+{
+	_Ptr	= str;
+	_Length	= str ? strlen(str) : 0;
+}
+
+int StringView::IndexOf(char ch, int startIndex) const
+{
+	if(startIndex < 0) startIndex	= 0;
+	if(startIndex >= _Length) return -1;
+
+	int p	= MemSearch::IndexOf(_Ptr + startIndex, _Length - startIndex, ch);
+
+	return p >= 0 ? p + startIndex : -1;
+}
+
+int StringView::IndexOf(const StringView& str, int startIndex) const
+{
+	if(startIndex < 0) startIndex	= 0;
+	if(startIndex > _Length) return -1;
+
+	int p	= MemSearch::IndexOf(_Ptr + startIndex, _Length - startIndex, str._Ptr, str._Length);
+
+	return p >= 0 ? p + startIndex : -1;
+}
+
+int StringView::IndexOf(const SearchPattern& pattern, int startIndex) const
+{
+	return pattern.IndexOf(_Ptr, _Length, startIndex);
+}
+
+int StringView::LastIndexOf(char ch) const
+{
+	return MemSearch::LastIndexOf(_Ptr, _Length, ch);
+}
+
+int StringView::LastIndexOf(const StringView& str) const
+{
+	return MemSearch::LastIndexOf(_Ptr, _Length, str._Ptr, str._Length);
+}
+
+bool StringView::StartsWith(const StringView& str) const
+{
+	return str._Length <= _Length && MemSearch::Compare(_Ptr, str._Ptr, str._Length) == 0;
+}
+
+bool StringView::EndsWith(const StringView& str) const
+{
+	return str._Length <= _Length && MemSearch::Compare(_Ptr + _Length - str._Length, str._Ptr, str._Length) == 0;
+}
+
+int StringView::CompareTo(const StringView& str, bool ignoreCase) const
+{
+	int len	= _Length < str._Length ? _Length : str._Length;
+	for(int i = 0; i < len; i++)
+	{
+		char c1	= _Ptr[i];
+		char c2	= str._Ptr[i];
+		if(ignoreCase)
+		{
+			c1	= toLower(c1);
+			c2	= toLower(c2);
+		}
+		if(c1 != c2) return c1 - c2;
+	}
+
+	return _Length - str._Length;
+}
+
+bool StringView::Equals(const StringView& str) const
+{
+	return _Length == str._Length && MemSearch::Compare(_Ptr, str._Ptr, _Length) == 0;
+}
+
+bool StringView::EqualsIgnoreCase(const StringView& str) const
+{
+	return _Length == str._Length && CompareTo(str, true) == 0;
+}
+
+StringView StringView::Sub(int start, int len) const
+{
+	if(start < 0) start	= 0;
+	if(start > _Length) start	= _Length;
+	if(len < 0 || len > _Length - start) len	= _Length - start;
+
+	return StringView(_Ptr + start, len);
+}
+
+StringView StringView::TrimStart() const
+{
+	int s	= 0;
+	while(s < _Length && isSpace(_Ptr[s])) s++;
+
+	return StringView(_Ptr + s, _Length - s);
+}
+
+StringView StringView::TrimEnd() const
+{
+	int len	= _Length;
+	while(len > 0 && isSpace(_Ptr[len - 1])) len--;
+
+	return StringView(_Ptr, len);
+}
+
+StringView StringView::Trim() const
+{
+	return TrimStart().TrimEnd();
+}
+
+bool StringView::Split(const StringView& sep, StringView& item)
+{
+	if(!_Ptr) return false;
+
+	int p	= IndexOf(sep);
+	if(p < 0)
+	{
+		item	= *this;
+		// 取走最后一段，下一次返回false
+		_Ptr	= nullptr;
+		_Length	= 0;
+	}
+	else
+	{
+		item	= StringView(_Ptr, p);
+		p	+= sep._Length;
+		_Ptr	+= p;
+		_Length	-= p;
+	}
+
+	return true;
+}
+
+int StringView::ToInt(int def) const
+{
+	int i	= 0;
+	bool neg	= false;
+	if(i < _Length && (_Ptr[i] == '-' || _Ptr[i] == '+')) neg	= _Ptr[i++] == '-';
+
+	int s	= i;
+	int v	= 0;
+	for(; i < _Length; i++)
+	{
+		char ch	= _Ptr[i];
+		if(ch < '0' || ch > '9') break;
+		v	= v * 10 + (ch - '0');
+	}
+	if(i == s) return def;
+
+	return neg ? -v : v;
+}
+
+uint StringView::ToHex() const
+{
+	int i	= 0;
+	if(_Length >= 2 && _Ptr[0] == '0' && (_Ptr[1] == 'x' || _Ptr[1] == 'X')) i	= 2;
+
+	uint v	= 0;
+	for(; i < _Length; i++)
+	{
+		char ch	= _Ptr[i];
+		if(ch >= '0' && ch <= '9')
+			ch	-= '0';
+		else if(ch >= 'a' && ch <= 'f')
+			ch	-= 'a' - 10;
+		else if(ch >= 'A' && ch <= 'F')
+			ch	-= 'A' - 10;
+		else
+			break;
+		v	= (v << 4) | ch;
+	}
+
+	return v;
+}
+
+float StringView::ToFloat() const
+{
+	int i	= 0;
+	bool neg	= false;
+	if(i < _Length && (_Ptr[i] == '-' || _Ptr[i] == '+')) neg	= _Ptr[i++] == '-';
+
+	float v	= 0;
+	for(; i < _Length && _Ptr[i] >= '0' && _Ptr[i] <= '9'; i++) v	= v * 10 + (_Ptr[i] - '0');
+
+	if(i < _Length && _Ptr[i] == '.')
+	{
+		float f	= 0.1f;
+		for(i++; i < _Length && _Ptr[i] >= '0' && _Ptr[i] <= '9'; i++)
+		{
+			v	+= (_Ptr[i] - '0') * f;
+			f	*= 0.1f;
+		}
+	}
+
+	return neg ? -v : v;
+}
+
+String StringView::ToString() const
+{
+	String str;
+	AppendTo(str);
+
+	return str;
+}
+
+String& StringView::AppendTo(String& str) const
+{
+	if(_Length > 0) str.Copy(str.Length(), _Ptr, _Length);
+
+	return str;
+}
+
+void StringView::Show(bool newLine) const
+{
+	for(int i = 0; i < _Length; i++) debug_printf("%c", _Ptr[i]);
+	if(newLine) debug_printf("\r\n");
+}
+
+/******************************** BufferView ********************************/
+
+int BufferView::IndexOf(byte item, int startIndex) const
+{
+	if(startIndex < 0) startIndex	= 0;
+	if(startIndex >= _Length) return -1;
+
+	int p	= MemSearch::IndexOf(_Ptr + startIndex, _Length - startIndex, item);
+
+	return p >= 0 ? p + startIndex : -1;
+}
+
+int BufferView::IndexOf(const BufferView& bs, int startIndex) const
+{
+	return AsString().IndexOf(bs.AsString(), startIndex);
+}
+
+bool BufferView::StartsWith(const BufferView& bs) const
+{
+	return bs._Length <= _Length && MemSearch::Compare(_Ptr, bs._Ptr, bs._Length) == 0;
+}
+
+bool BufferView::Equals(const BufferView& bs) const
+{
+	return _Length == bs._Length && MemSearch::Compare(_Ptr, bs._Ptr, _Length) == 0;
+}
+
+BufferView BufferView::Sub(int start, int len) const
+{
+	if(start < 0) start	= 0;
+	if(start > _Length) start	= _Length;
+	if(len < 0 || len > _Length - start) len	= _Length - start;
+
+	return BufferView(_Ptr + start, len);
+}
+
+ushort BufferView::ToUInt16(int offset, bool isLittleEndian) const
+{
+	if(offset + 2 > _Length) return 0;
+
+	auto p	= _Ptr + offset;
+	return isLittleEndian ? (p[0] | (p[1] << 8)) : ((p[0] << 8) | p[1]);
+}
+
+uint BufferView::ToUInt32(int offset, bool isLittleEndian) const
+{
+	if(offset + 4 > _Length) return 0;
+
+	auto p	= _Ptr + offset;
+	if(isLittleEndian) return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint)p[3] << 24);
+
+	return ((uint)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
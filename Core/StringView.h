@@ -0,0 +1,109 @@
+﻿#ifndef __StringView_H__
+#define __StringView_H__
+
+#include "Buffer.h"
+#include "SString.h"
+
+class SearchPattern;
+
+// 字符串视图。只有指针和长度，不拥有数据，不保证零结尾
+// 用于解析路径，截取、查找、修剪、分割都只移动指针，不拷贝也不分配
+// 视图不能比所指向的数据活得更久
+class StringView
+{
+public:
+	StringView() { _Ptr = nullptr; _Length = 0; }
+	StringView(cstring str);
+	StringView(cstring str, int len) { _Ptr = str; _Length = str ? len : 0; }
+	StringView(const String& str) { _Ptr = str.GetBuffer(); _Length = str.Length(); }
+	explicit StringView(const Buffer& bs) { _Ptr = (cstring)bs.GetBuffer(); _Length = bs.Length(); }
+
+	inline cstring GetBuffer() const { return _Ptr; }
+	inline int Length() const { return _Length; }
+
+	explicit operator bool() const { return _Length > 0; }
+	bool operator !() const { return _Length == 0; }
+	char operator[](int index) const { return index >= 0 && index < _Length ? _Ptr[index] : 0; }
+
+	int IndexOf(char ch, int startIndex = 0) const;
+	int IndexOf(const StringView& str, int startIndex = 0) const;
+	// 用预计算模式查找固定关键字
+	int IndexOf(const SearchPattern& pattern, int startIndex = 0) const;
+	int LastIndexOf(char ch) const;
+	int LastIndexOf(const StringView& str) const;
+	bool Contains(const StringView& str) const { return IndexOf(str) >= 0; }
+	bool StartsWith(const StringView& str) const;
+	bool EndsWith(const StringView& str) const;
+
+	int CompareTo(const StringView& str, bool ignoreCase = false) const;
+	bool Equals(const StringView& str) const;
+	bool EqualsIgnoreCase(const StringView& str) const;
+	bool operator == (const StringView& rhs) const { return Equals(rhs); }
+	bool operator != (const StringView& rhs) const { return !Equals(rhs); }
+
+	// 截取子视图，默认-1长度表示剩余全部，越界部分自动截断
+	StringView Sub(int start, int len = -1) const;
+	StringView TrimStart() const;
+	StringView TrimEnd() const;
+	StringView Trim() const;
+
+	// 按分隔符切出下一段，自身前移到分隔符之后。没有分隔符时取走剩余全部，已空时返回false
+	bool Split(const StringView& sep, StringView& item);
+
+	// 解析整数，遇到非数字停止。可选正负号，不足一位时返回默认值
+	int ToInt(int def = 0) const;
+	// 解析十六进制无符号整数，可选0x前缀
+	uint ToHex() const;
+	// 解析浮点数，不支持指数
+	float ToFloat() const;
+
+	// 拷贝为字符串
+	String ToString() const;
+	// 追加到字符串末尾
+	String& AppendTo(String& str) const;
+	void Show(bool newLine = false) const;
+
+private:
+	cstring	_Ptr;
+	int		_Length;
+};
+
+// 缓冲区视图。只有指针和长度，不拥有数据，用于二进制数据的解析
+class BufferView
+{
+public:
+	BufferView() { _Ptr = nullptr; _Length = 0; }
+	BufferView(const void* ptr, int len) { _Ptr = (const byte*)ptr; _Length = ptr ? len : 0; }
+	BufferView(const Buffer& bs) { _Ptr = bs.GetBuffer(); _Length = bs.Length(); }
+
+	inline const byte* GetBuffer() const { return _Ptr; }
+	inline int Length() const { return _Length; }
+
+	explicit operator bool() const { return _Length > 0; }
+	bool operator !() const { return _Length == 0; }
+	byte operator[](int index) const { return index >= 0 && index < _Length ? _Ptr[index] : 0; }
+
+	int IndexOf(byte item, int startIndex = 0) const;
+	int IndexOf(const BufferView& bs, int startIndex = 0) const;
+	bool StartsWith(const BufferView& bs) const;
+	bool Equals(const BufferView& bs) const;
+	bool operator == (const BufferView& rhs) const { return Equals(rhs); }
+	bool operator != (const BufferView& rhs) const { return !Equals(rhs); }
+
+	// 截取子视图，默认-1长度表示剩余全部，越界部分自动截断
+	BufferView Sub(int start, int len = -1) const;
+
+	ushort	ToUInt16(int offset = 0, bool isLittleEndian = true) const;
+	uint	ToUInt32(int offset = 0, bool isLittleEndian = true) const;
+
+	// 按字符串看待
+	StringView AsString() const { return StringView((cstring)_Ptr, _Length); }
+	// 包装为缓冲区，供只接受Buffer的接口使用，不拷贝数据
+	Buffer AsBuffer() const { return Buffer((void*)_Ptr, _Length); }
+
+private:
+	const byte*	_Ptr;
+	int		_Length;
+};
+
+#endif
@@ -61,4 +61,7 @@ public:
 #define	WEAK	__attribute__((weak))
 #endif
 
+// 原地调整堆上内存块的大小，成功返回true。由运行时实现，默认不支持
+bool ResizeInPlace(void* ptr, int size);
+
 #endif
@@ -13,7 +13,7 @@ public:
 	~DMA();
 
     int Retry;  // 等待重试次数，默认200
-    int Error;  // 错误次数
+    int Error;  // 错误次数。中断路径也会修改，用AtomicAdd递增
 
 	bool Start();	// 开始
 	bool WaitForStop();	// 停止
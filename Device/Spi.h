@@ -21,7 +21,7 @@ private:
 public:
     int		Speed;  // 速度
     int		Retry;  // 等待重试次数，默认200
-    int		Error;  // 错误次数
+    int		Error;  // 错误次数。可能在中断里的传输中修改，用AtomicAdd递增
 	bool	Opened;
 
 	Spi();
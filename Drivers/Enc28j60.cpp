@@ -706,7 +706,12 @@ byte Enc28j60::GetRevision()
 
 bool Enc28j60::OnWrite(const Buffer& bs)
 {
-	uint len = bs.Length();
+	return OnWriteEx(BufferChain(bs), nullptr);
+}
+
+bool Enc28j60::OnWriteEx(const BufferChain& bc, const void* opt)
+{
+	uint len = bc.Length();
 	assert(len <= MAX_FRAMELEN, "以太网数据帧超大");
 
 	if (!Linked())
@@ -735,8 +740,12 @@ bool Enc28j60::OnWrite(const Buffer& bs)
 	// 写每个包的控制字节（0x00意味着使用macon3设置）
 	WriteOp(ENC28J60_WRITE_BUF_MEM, 0, 0x00);
 
-	// 复制数据包到传输缓冲区
-	WriteBuffer((const byte*)bs.GetBuffer(), len);
+	// 各段依次复制到传输缓冲区，写指针自动递增
+	for (int i = 0; i < bc.Count(); i++)
+	{
+		auto& seg = bc[i];
+		WriteBuffer(seg.GetBuffer(), seg.Length());
+	}
 
 	/*
 	仅发送复位通过SPI接口向ECON1寄存器的 TXRST 位写入1可实现仅发送复位。
@@ -805,7 +814,8 @@ bool Enc28j60::OnWrite(const Buffer& bs)
 			ReadBuffer((byte*)&TXStatus, sizeof(TXStatus));
 
 #if NET_DEBUG
-			const byte* packet = (const byte*)bs.GetBuffer();
+			// 以太网头部在第一段
+			const byte* packet = bc[0].GetBuffer();
 			MacAddress dest = packet;
 			MacAddress src = packet + 6;
 			dest.Show();
@@ -66,6 +66,8 @@ protected:
 	virtual void OnClose() { }
 
 	virtual bool OnWrite(const Buffer& bs);
+	// 各段依次写入发送缓冲区，不在内存里合并
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 	virtual uint OnRead(Buffer& bs);
 };
 
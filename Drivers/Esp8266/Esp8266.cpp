@@ -159,7 +159,7 @@ bool Esp8266::OnOpen()
 
 	if (!_task) _task = Sys.AddTask(&Esp8266::Process, this, -1, -1, "Esp8266");
 
-	At.Received.Bind(&Esp8266::OnReceive, this);
+	At.Received.Bind<Esp8266, &Esp8266::OnReceive>(this);
 
 	return true;
 }
@@ -355,31 +355,27 @@ void Esp8266::OnReceive(Buffer& bs)
 {
 	TS("Esp8266::OnReceive");
 
-	auto str = bs.AsString();
-
-	StringSplit sp(str, ",");
+	// 视图逐段切割，不拷贝字符串
+	StringView sp(bs);
+	StringView rs;
 
 	// 第一段
-	auto rs = sp.Next();
-	if (!rs) return;
-	int idx = rs.ToInt();
+	if (!sp.Split(",", rs) || !rs) return;
+	int idx = rs.ToInt(-1);
 	if (idx < 0 || idx > 4) return;
 
-	if (!(rs = sp.Next())) return;
+	if (!sp.Split(",", rs) || !rs) return;
 	int len = rs.ToInt();
 
 	IPEndPoint ep;
-	if (!(rs = sp.Next())) return;
+	if (!sp.Split(",", rs) || !rs) return;
 	ep.Address = IPAddress::Parse(rs);
 
-	// 提前改变下一个分隔符
-	sp.Sep = ":";
-	if (!(rs = sp.Next())) return;
+	// 端口后面是冒号，然后是数据
+	if (!sp.Split(":", rs) || !rs || !sp.GetBuffer()) return;
 	ep.Port = rs.ToInt();
 
-	// 后面是数据
-	sp.Next();
-	int s = sp.Position;
+	int s = sp.GetBuffer() - (cstring)bs.GetBuffer();
 	if (s <= 0) return;
 
 	// 校验数据长度
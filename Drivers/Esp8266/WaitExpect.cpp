@@ -1,5 +1,7 @@
 ﻿#include "Kernel\Sys.h"
 
+#include "Core\MemSearch.h"
+
 #include "WaitExpect.h"
 
 #define NET_DEBUG DEBUG
@@ -12,6 +14,9 @@
 
 /******************************** WaitExpect ********************************/
 
+// 固定关键字，跳转表只算一次
+static const SearchPattern _Busy("busy ");
+
 bool WaitExpect::Wait(int msTimeout)
 {
 	// 提前等待一会，再开始轮询，专门为了加快命中快速响应的指令
@@ -28,8 +33,7 @@ uint WaitExpect::Parse(const Buffer& bs)
 	TS("WaitExpect::Parse");
 
 	// 适配任意关键字后，也就是收到了成功或失败，通知业务层已结束
-	auto s_	= bs.AsString();
-	auto& s	= (const String&)s_;
+	StringView s(bs);
 	int p	= FindKey(s);
 	auto& rs= *Result;
 
@@ -37,12 +41,15 @@ uint WaitExpect::Parse(const Buffer& bs)
 	if(Capture)
 	{
 		if(p > 0)
-			rs	+= bs.Sub(0, p).AsString();
+			s.Sub(0, p).AppendTo(rs);
 		else
-			rs	+= s;
+			s.AppendTo(rs);
 	}
 	else if(p > 0)
-		rs	= bs.Sub(0, p).AsString();
+	{
+		rs.SetLength(0);
+		s.Sub(0, p).AppendTo(rs);
+	}
 
 	// 匹配关键字，任务完成
 	if(p > 0)
@@ -61,24 +68,26 @@ uint WaitExpect::Parse(const Buffer& bs)
 	return p;
 }
 
-uint WaitExpect::FindKey(const String& str)
+uint WaitExpect::FindKey(const StringView& str)
 {
 	// 适配第一关键字
-	int p	= Key1 ? str.IndexOf(Key1) : -1;
+	StringView key	= Key1;
+	int p	= key ? str.IndexOf(key) : -1;
 	if(p >= 0)
 	{
 		//net_printf("适配第一关键字 %s \r\n", Key1);
-		return p + String(Key1).Length();
+		return p + key.Length();
 	}
 	// 适配第二关键字
-	p	= Key2 ? str.IndexOf(Key2) : -1;
+	key	= Key2;
+	p	= key ? str.IndexOf(key) : -1;
 	if(p >= 0)
 	{
 		net_printf("适配第二关键字 %s \r\n", Key2);
-		return p + String(Key2).Length();
+		return p + key.Length();
 	}
 	// 适配busy
-	p	= str.IndexOf("busy ");
+	p	= str.IndexOf(_Busy);
 	if(p >= 0)
 	{
 		net_printf("适配 busy  \r\n");
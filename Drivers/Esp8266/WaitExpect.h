@@ -2,6 +2,7 @@
 #define __WaitExpect_H__
 
 #include "Kernel\WaitHandle.h"
+#include "Core\StringView.h"
 
 // 等待
 class WaitExpect
@@ -19,7 +20,7 @@ public:
 
 	bool Wait(int msTimeout);
 	uint Parse(const Buffer& bs);
-	uint FindKey(const String& str);
+	uint FindKey(const StringView& str);
 };
 
 #endif
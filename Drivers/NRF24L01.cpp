@@ -250,7 +250,7 @@ void NRF24L01::Init(Spi* spi, Pin ce, Pin irq, Pin power)
 		Irq.HardEvent	= true;
 		Irq.Init(irq, true);
 		//if(!Irq.Register(OnIRQ, this)) Irq.HardEvent	= false;
-		Irq.Press.Bind(&NRF24L01::OnIRQ, this);
+		Irq.Press.Bind<NRF24L01, &NRF24L01::OnIRQ>(this);
 		Irq.UsePress();
     }
 	if(power != P0) _Power.Set(power);
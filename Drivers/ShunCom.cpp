@@ -169,7 +169,7 @@ bool ShunCom::OnWriteEx(const Buffer& bs, const void* opt)
 	if (!AddrLength || !opt) return OnWrite(bs);
 	// 加入地址
 	ByteArray bs2;
-	bs2.Copy(0, opt, AddrLength);
+	bs2.Copy(0, Buffer((void*)opt, AddrLength), 0, AddrLength);
 	//debug_printf("zigbee发送\r\n");
 	//bs2.Show();
 
@@ -178,6 +178,17 @@ bool ShunCom::OnWriteEx(const Buffer& bs, const void* opt)
 	return OnWrite(bs2);
 }
 
+bool ShunCom::OnWriteEx(const BufferChain& bc, const void* opt)
+{
+	if (!AddrLength || !opt) return PackPort::OnWriteEx(bc, nullptr);
+
+	// 地址作为头部加在最前面，负载仍然分段交给串口
+	BufferChain bc2(bc);
+	if (!bc2.Prepend(Buffer((void*)opt, AddrLength))) return ITransport::OnWriteEx(bc, opt);
+
+	return PackPort::OnWriteEx(bc2, nullptr);
+}
+
 // 进入配置模式
 bool ShunCom::EnterConfig()
 {
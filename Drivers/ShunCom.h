@@ -61,5 +61,6 @@ private:
 	virtual uint OnReceive(Buffer& bs, void* param);
 
 	virtual bool OnWriteEx(const Buffer& bs, const void* opt);
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 };
 #endif
@@ -240,10 +240,12 @@ public:
 	//virtual bool Change(const String& remote, ushort port);
 
 	virtual bool OnWrite(const Buffer& bs);
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 	virtual uint OnRead(Buffer& bs);
 
 	// 发送数据
 	virtual bool Send(const Buffer& bs);
+	virtual bool Send(const BufferChain& bc);
 	// 接收数据
 	virtual uint Receive(Buffer& bs);
 
@@ -301,6 +303,7 @@ public:
 
 private:
 	virtual bool OnWriteEx(const Buffer& bs, const void* opt);
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 };
 
 /****************************** W5500 ************************************/
@@ -366,7 +369,7 @@ void W5500::Init(Spi* spi, Pin irq, Pin rst)
 		//Irq.Mode		= InputPort::Rising;
 		Irq.HardEvent	= true;
 		Irq.Init(irq, true);
-		Irq.Press.Bind(&W5500::OnIRQ, this);
+		Irq.Press.Bind<W5500, &W5500::OnIRQ>(this);
 		Irq.UsePress();
 	}
 
@@ -722,6 +725,19 @@ bool W5500::WriteFrame(ushort addr, const Buffer& bs, byte socket, byte block)
 	return true;
 }
 
+bool W5500::WriteFrame(ushort addr, const BufferChain& bc, byte socket, byte block)
+{
+	SpiScope sc(_spi);
+
+	SetAddress(addr, 1, socket, block);
+	for(int i=0; i<bc.Count(); i++)
+	{
+		_spi->Write(bc[i]);
+	}
+
+	return true;
+}
+
 bool W5500::ReadFrame(ushort addr, Buffer& bs, byte socket, byte block)
 {
 	SpiScope sc(_spi);
@@ -1329,6 +1345,12 @@ uint HardSocket::Receive(Buffer& bs)
 
 // 发送数据
 bool HardSocket::Send(const Buffer& bs)
+{
+	return Send(BufferChain(bs));
+}
+
+// 分段发送数据，各段直接写入芯片发送缓冲区
+bool HardSocket::Send(const BufferChain& bc)
 {
 	if(!Open()) return false;
 	/*debug_printf("%s::Send [%d]=", Protocol == 0x01 ? "Tcp" : "Udp", bs.Length());
@@ -1339,14 +1361,15 @@ bool HardSocket::Send(const Buffer& bs)
 	// 不在UDP  不在TCP连接OK 状态下返回
 	if(!(st == SOCK_UDP || st == SOCK_ESTABLISHE))return false;
 	// 读取缓冲区空闲大小 硬件内部自动计算好空闲大小
+	int len = bc.Length();
 	ushort remain = _REV16(SocRegRead2(TX_FSR));
-	if( remain < bs.Length())return false;
+	if( remain < len)return false;
 
 	// 读取发送缓冲区写指针
 	ushort addr = _REV16(SocRegRead2(TX_WR));
-	_Host.WriteFrame(addr, bs, Index, 0x02);
+	_Host.WriteFrame(addr, bc, Index, 0x02);
 	// 更新发送缓存写指针位置
-	addr += bs.Length();
+	addr += len;
 	SocRegWrite2(TX_WR,_REV16(addr));
 
 	// 启动发送 异步中断处理发送异常等
@@ -1359,6 +1382,7 @@ bool HardSocket::Send(const Buffer& bs)
 }
 
 bool HardSocket::OnWrite(const Buffer& bs) {	return Send(bs); }
+bool HardSocket::OnWriteEx(const BufferChain& bc, const void* opt) { return Send(bc); }
 uint HardSocket::OnRead(Buffer& bs) { return Receive(bs); }
 
 void HardSocket::ClearRX()
@@ -1562,6 +1586,18 @@ bool UdpClient::OnWriteEx(const Buffer& bs, const void* opt)
 	return SendTo(bs, *ep);
 }
 
+bool UdpClient::OnWriteEx(const BufferChain& bc, const void* opt)
+{
+	auto ep = (IPEndPoint*)opt;
+	if(!ep || *ep == Remote) return Send(bc);
+
+	Change(*ep);
+	bool rs = Send(bc);
+	Change(Remote);
+
+	return rs;
+}
+
 void UdpClient::OnProcess(byte reg)
 {
 	S_Interrupt ir;
@@ -36,6 +36,8 @@ public:
 
 	// 读写帧，帧本身由外部构造   （包括帧数据内部的读写标志）
 	bool WriteFrame(ushort addr, const Buffer& bs, byte socket = 0 ,byte block = 0);
+	// 各段在一次SPI传输内连续写入，芯片内地址自动递增
+	bool WriteFrame(ushort addr, const BufferChain& bc, byte socket = 0 ,byte block = 0);
 	bool ReadFrame(ushort addr, Buffer& bs, byte socket = 0 ,byte block = 0);
 
 	// 复位 包含硬件复位和软件复位
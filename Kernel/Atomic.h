@@ -0,0 +1,86 @@
+﻿#ifndef __Atomic_H__
+#define __Atomic_H__
+
+#include "Kernel\Sys.h"
+
+// 原子整数。中断与任务共享的计数器，读改写不会丢失，也不需要关中断
+class AtomicInt
+{
+public:
+	AtomicInt(int value = 0) { _Value = value; }
+
+	int Value() const { return _Value; }
+	operator int() const { return _Value; }
+	AtomicInt& operator=(int value) { _Value = value; return *this; }
+
+	int Add(int value) { return AtomicAdd(&_Value, value); }
+	int operator++() { return AtomicAdd(&_Value, 1); }
+	int operator--() { return AtomicAdd(&_Value, -1); }
+	int operator+=(int value) { return AtomicAdd(&_Value, value); }
+	int operator-=(int value) { return AtomicAdd(&_Value, -value); }
+
+	// 等于old时改为value，返回是否成功
+	bool CompareExchange(int old, int value) { return AtomicCompareExchange(&_Value, old, value); }
+	// 取走当前值并清零，用于周期性统计
+	int Exchange(int value)
+	{
+		int old;
+		do
+		{
+			old	= _Value;
+		}
+		while(!AtomicCompareExchange(&_Value, old, value));
+
+		return old;
+	}
+
+private:
+	volatile int	_Value;
+};
+
+// 顺序锁。用于一个写者更新多个字段，读者无锁读取一致的快照
+// 写者写入前后各递增一次序号，读者发现序号为奇数或前后不一致时重试
+// 写者只能有一个，比如只在某个中断里更新的统计。读者不能打断写者，否则会一直等待
+class SeqLock
+{
+public:
+	SeqLock() { _Seq = 0; }
+
+	void BeginWrite() { _Seq++; MemoryBarrier(); }
+	void EndWrite() { MemoryBarrier(); _Seq++; }
+
+	// 开始读取，返回序号。写入中时等待
+	uint BeginRead() const
+	{
+		uint seq;
+		while((seq = _Seq) & 1);
+		MemoryBarrier();
+
+		return seq;
+	}
+	// 读取期间有写入，需要重新读取
+	bool Retry(uint seq) const
+	{
+		MemoryBarrier();
+		return _Seq != seq;
+	}
+
+	uint Sequence() const { return _Seq; }
+
+private:
+	volatile uint	_Seq;
+};
+
+/*
+读取示例，中断里更新的多字段统计
+	Stat st;
+	uint seq;
+	do
+	{
+		seq	= lock.BeginRead();
+		st	= _Stat;
+	}
+	while(lock.Retry(seq));
+*/
+
+#endif
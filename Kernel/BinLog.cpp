@@ -0,0 +1,141 @@
+﻿#include "BinLog.h"
+#include "Task.h"
+
+#include "Device\SerialPort.h"
+
+bool	BinLog::_Running	= false;
+uint	BinLog::_Task		= 0;
+uint	BinLog::Records		= 0;
+uint	BinLog::Drops		= 0;
+
+// 环形缓冲区。每条记录首字节为长度，写完数据后才填，为0表示还没写完；0xFF表示跳到开头
+// 读者取走记录后整条清零
+static byte _Ring[BinLog::Size];
+static volatile int	_Head	= 0;	// 预留位置，只增不减
+static volatile int	_Tail	= 0;	// 读取位置
+static volatile int	_Flushing	= 0;
+
+#define RING_MASK	(BinLog::Size - 1)
+#define RING_WRAP	0xFF
+
+static void FlushTask(void* param) { BinLog::Flush(); }
+
+void BinLog::Start(int period)
+{
+	if(_Running) return;
+
+	Buffer::Zero(_Ring, sizeof(_Ring));
+	_Head	= 0;
+	_Tail	= 0;
+	Records	= 0;
+	Drops	= 0;
+
+	if(!_Task) _Task	= Sys.AddTask(FlushTask, nullptr, period, period, "二进制日志");
+
+	_Running	= true;
+}
+
+void BinLog::Stop()
+{
+	if(!_Running) return;
+
+	Flush();
+	_Running	= false;
+
+	Sys.RemoveTask(_Task);
+	// 下次Start重新创建任务
+	_Task	= 0;
+}
+
+void BinLog::Put(byte* buf, int& len, const void* data, int size)
+{
+	if(len + size > MaxRecord) size	= MaxRecord - len;
+	if(size <= 0) return;
+
+	Buffer::Copy(buf + len, data, size);
+	len	+= size;
+}
+
+void BinLog::Put(byte* buf, int& len, cstring value)
+{
+	if(!value) value	= "";
+
+	int n	= 0;
+	while(n < MaxString && value[n]) n++;
+	if(len + 1 + n > MaxRecord) n	= MaxRecord - len - 1;
+	if(n < 0) return;
+
+	buf[len++]	= n;
+	Put(buf, len, value, n);
+}
+
+INROOT void BinLog::Commit(const byte* buf, int len)
+{
+	// 长度字节加数据
+	int n	= len + 1;
+	int head, off, need;
+	do
+	{
+		head	= _Head;
+		off		= head & RING_MASK;
+		need	= n;
+		// 尾部放不下，跳过剩余部分从头开始
+		if(off + n > Size) need	+= Size - off;
+
+		if(need > Size - (head - _Tail))
+		{
+			// 多个中断可能同时写入，计数也要原子
+			AtomicAdd((volatile int*)&Drops, 1);
+			return;
+		}
+	}
+	while(!AtomicCompareExchange(&_Head, head, head + need));
+
+	if(need > n)
+	{
+		_Ring[off]	= RING_WRAP;
+		off	= 0;
+	}
+
+	Buffer::Copy(&_Ring[off + 1], buf, len);
+	// 数据写完后才填长度，读者看到长度就能读完整记录
+	MemoryBarrier();
+	_Ring[off]	= len;
+
+	AtomicAdd((volatile int*)&Records, 1);
+}
+
+void BinLog::Flush()
+{
+	// 只能有一个读者
+	if(!AtomicCompareExchange(&_Flushing, 0, 1)) return;
+
+	byte frame[MaxRecord + 2];
+	while(_Tail != _Head)
+	{
+		int off	= _Tail & RING_MASK;
+		byte len	= _Ring[off];
+		// 还没写完，下次再来
+		if(len == 0) break;
+
+		if(len == RING_WRAP)
+		{
+			_Ring[off]	= 0;
+			AtomicAdd(&_Tail, Size - off);
+			continue;
+		}
+
+		frame[0]	= Mark;
+		frame[1]	= len;
+		Buffer::Copy(&frame[2], &_Ring[off + 1], len);
+		// 整条清零后才释放，空闲区始终为零，写者预留的位置不会读到旧数据
+		Buffer::Zero(&_Ring[off], len + 1);
+		MemoryBarrier();
+		AtomicAdd(&_Tail, len + 1);
+
+		auto sp	= SerialPort::GetMessagePort();
+		if(sp && sp->Opened) sp->Write(Buffer(frame, len + 2));
+	}
+
+	_Flushing	= 0;
+}
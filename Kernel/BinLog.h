@@ -0,0 +1,87 @@
+﻿#ifndef __BinLog_H__
+#define __BinLog_H__
+
+#include "Kernel\Sys.h"
+
+// 二进制日志。日志点只写格式串地址和原始参数到环形缓冲区，由低优先级任务发到调试口，主机再还原成文本
+// 格式串放在独立段里，地址就是编号，编译时确定。主机解码工具见 Tool\LogDecode.cs
+// 未启动时退化为debug_printf，日志点不用区分两种模式
+//
+// 帧格式：0x1E 长度 编号(4) 参数...
+// 参数按格式串顺序：整数/字符/指针4字节，%ll 8字节，浮点按float 4字节，字符串为长度加内容
+class BinLog
+{
+public:
+	static const int	Size		= 1024;	// 环形缓冲区大小，2的幂
+	static const int	MaxRecord	= 64;	// 单条记录最大字节数，超出部分截断
+	static const int	MaxString	= 24;	// 字符串参数最大字节数
+	static const byte	Mark		= 0x1E;	// 帧起始标记
+
+	static uint	Records;	// 写入记录数
+	static uint	Drops;		// 缓冲区满丢弃的记录数
+
+	// 开始二进制日志，添加发送任务
+	static void Start(int period = 10);
+	static void Stop();
+	static bool Running() { return _Running; }
+
+	// 记录一条日志。中断里可用，多个写者之间无锁
+	template<typename... Args>
+	static void Log(cstring format, Args... args)
+	{
+		if(!_Running)
+		{
+			debug_printf(format, args...);
+			return;
+		}
+
+		byte buf[MaxRecord];
+		int len	= 0;
+		Put(buf, len, (const void*)format);
+		Pack(buf, len, args...);
+		Commit(buf, len);
+	}
+
+	// 把缓冲区里的记录全部发到调试口。文本日志输出前也会先调用，保证先后顺序
+	static void Flush();
+
+private:
+	static bool	_Running;
+	static uint	_Task;
+
+	static void Commit(const byte* buf, int len);
+
+	static void Pack(byte* buf, int& len) { }
+	template<typename T, typename... Args>
+	static void Pack(byte* buf, int& len, T value, Args... args)
+	{
+		Put(buf, len, value);
+		Pack(buf, len, args...);
+	}
+
+	static void Put(byte* buf, int& len, const void* data, int size);
+	static void Put(byte* buf, int& len, int value) { Put(buf, len, &value, 4); }
+	static void Put(byte* buf, int& len, uint value) { Put(buf, len, &value, 4); }
+	static void Put(byte* buf, int& len, long value) { int v = value; Put(buf, len, &v, 4); }
+	static void Put(byte* buf, int& len, unsigned long value) { uint v = value; Put(buf, len, &v, 4); }
+	static void Put(byte* buf, int& len, long long value) { Put(buf, len, &value, 8); }
+	static void Put(byte* buf, int& len, unsigned long long value) { Put(buf, len, &value, 8); }
+	static void Put(byte* buf, int& len, double value) { float v = value; Put(buf, len, &v, 4); }
+	static void Put(byte* buf, int& len, const void* value) { uint v = (uint)(size_t)value; Put(buf, len, &v, 4); }
+	static void Put(byte* buf, int& len, cstring value);
+};
+
+#if DEBUG
+	#if defined(__GNUC__) || defined(__CC_ARM)
+		#define BINLOG_SECTION __attribute__((section(".binlog")))
+	#else
+		#define BINLOG_SECTION
+	#endif
+
+	// 二进制日志，格式串必须是字面量
+	#define log_printf(format, ...) do { BINLOG_SECTION static const char __fmt[] = format; BinLog::Log(__fmt, ##__VA_ARGS__); } while(0)
+#else
+	#define log_printf(format, ...)
+#endif
+
+#endif
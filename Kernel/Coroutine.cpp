@@ -0,0 +1,64 @@
+﻿#include "Task.h"
+
+#include "Coroutine.h"
+
+Coroutine::Coroutine()
+{
+	Name		= nullptr;
+	TaskID		= 0;
+	Poll		= 10;
+	Finished	= false;
+
+	_Line		= 0;
+	_Polling	= false;
+	_Until		= 0;
+}
+
+Coroutine::~Coroutine()
+{
+	Sys.RemoveTask(TaskID);
+}
+
+void Coroutine::Start(int dueTime)
+{
+	_Line		= 0;
+	Finished	= false;
+
+	if(!TaskID)
+		TaskID	= Sys.AddTask(OnTask, this, dueTime, Poll, Name);
+	else
+		Sys.SetTask(TaskID, true, dueTime);
+}
+
+void Coroutine::Stop()
+{
+	Sys.SetTask(TaskID, false);
+}
+
+void Coroutine::Wake()
+{
+	Sys.SetTask(TaskID, true, 0);
+}
+
+void Coroutine::OnTask(void* param)
+{
+	auto co	= (Coroutine*)param;
+	auto task	= Task::Get(co->TaskID);
+	if(!task) return;
+
+	if(!co->Run())
+	{
+		co->Finished	= true;
+		task->Enable	= false;
+		return;
+	}
+
+	// 按照让出原因安排下一次执行时间。睡眠到截止时间，等待条件时定期检查
+	UInt64 next	= co->_Until;
+	if(co->_Polling)
+	{
+		auto poll	= Sys.Ms() + co->Poll;
+		if(poll < next) next	= poll;
+	}
+	task->NextTime	= next;
+}
@@ -0,0 +1,58 @@
+﻿#ifndef __Coroutine_H__
+#define __Coroutine_H__
+
+#include "Kernel\Sys.h"
+
+// 协程。无栈协程，采用达夫设备实现的原线程(protothread)
+// 等待时记下续点返回调度器，由任务调度器在到期或条件满足时从续点继续执行，不会像ExecuteForWait那样在当前栈上嵌套调度其它任务
+// 注意：局部变量在让出点之后不再有效，需要跨越让出点的状态必须作为成员保存；同一行只能有一个让出点
+class Coroutine
+{
+public:
+	cstring	Name;		// 名称
+	uint	TaskID;		// 承载协程的任务
+	ushort	Poll;		// 等待条件时的轮询间隔ms，默认10
+	bool	Finished;	// 是否已执行完成
+
+	Coroutine();
+	virtual ~Coroutine();
+
+	// 开始执行协程，dueTime为首次执行时间
+	void Start(int dueTime = 0);
+	void Stop();
+	// 马上唤醒协程，用于等待条件已经满足的场合
+	void Wake();
+
+protected:
+	ushort	_Line;		// 续点行号，0表示从头开始
+	bool	_Polling;	// 是否在等待条件，需要定时检查
+	UInt64	_Until;		// 等待的截止时间ms，0表示没有
+
+	// 协程体，使用CO_BEGIN/CO_END包围。返回true表示在让出点暂停，false表示执行完成
+	virtual bool Run() = 0;
+
+private:
+	static void OnTask(void* param);
+};
+
+// 协程体开始和结束
+#define CO_BEGIN		switch(_Line) { case 0:
+#define CO_END			} _Line = 0; return false;
+
+// 让出时间片，下一轮调度马上继续
+#define CO_YIELD()		do { _Until = 0; _Polling = false; _Line = __LINE__; return true; case __LINE__:; } while(0)
+
+// 睡眠指定毫秒数，期间调度器可以执行其它任务或者进入低功耗
+#define CO_SLEEP(ms)	do { _Until = Sys.Ms() + (ms); _Polling = false; _Line = __LINE__; case __LINE__: if(Sys.Ms() < _Until) return true; } while(0)
+
+// 等待条件成立，或者超时
+#define CO_WAIT_UNTIL(cond, ms)	do { _Until = Sys.Ms() + (ms); _Polling = true; _Line = __LINE__; case __LINE__: if(!(cond) && Sys.Ms() < _Until) return true; } while(0)
+
+// 在句柄上登记等待，直到条件成立或者超时。句柄被设置时马上唤醒，不必等到下一次轮询
+// 信号量和通道：CO_WAIT_ON(sem.Handle, sem.TryWait(), ms)、CO_WAIT_ON(ch.CanRead, ch.TryRead(Item), ms)
+#define CO_WAIT_ON(handle, cond, ms)	do { (handle).Waiter = TaskID; _Until = Sys.Ms() + (ms); _Polling = true; _Line = __LINE__; case __LINE__: if(!(cond) && Sys.Ms() < _Until) return true; (handle).Waiter = 0; } while(0)
+
+// 等待句柄被设置，或者超时。之后通过handle.Result判断结果
+#define CO_WAIT(handle, ms)		CO_WAIT_ON(handle, (handle).Result, ms)
+
+#endif
@@ -7,7 +7,7 @@
 #define MEMORY_ALIGN	4
 
 // 当前堆
-const Heap* Heap::Current = nullptr;
+Heap* Heap::Current = nullptr;
 
 /*
 堆分配原理：
@@ -48,6 +48,7 @@ Heap::Heap(uint addr, int size)
 
 	_Used = sizeof(MemoryBlock) << 1;
 	_Count = 0;
+	_Allocs = 0;
 
 	// 记录第一个有空闲内存的块，减少内存分配时的查找次数
 	_First = mb;
@@ -59,6 +60,15 @@ int Heap::Used()	const { return _Used; }
 int Heap::Count()	const { return _Count; }
 int Heap::FreeSize()	const { return Size - _Used; }
 
+uint Heap::Top() const
+{
+	// 内存块按地址排序，末尾的哨兵块之前就是最高的已分配块
+	auto mcb = (MemoryBlock*)Address;
+	while (mcb->Next && mcb->Next->Next) mcb = mcb->Next;
+
+	return (uint)mcb + mcb->Used;
+}
+
 void* Heap::Alloc(int size)
 {
 	// 要申请的内存大小需要对齐
@@ -103,6 +113,7 @@ void* Heap::Alloc(int size)
 
 			_Used += need;
 			_Count++;
+			_Allocs++;
 
 			//debug_printf("Heap::Alloc (%p, %d) First=%p Used=%d Count=%d \r\n", ret, need, _First, _Used, _Count);
 
@@ -142,3 +153,34 @@ void Heap::Free(void* ptr)
 	}
 	debug_printf("正在释放不是本系统申请的内存 0x%p \r\n", ptr);
 }
+
+bool Heap::Resize(void* ptr, int size)
+{
+	if (!ptr || size <= 0) return false;
+
+	size = (size + MEMORY_ALIGN - 1) & (~(MEMORY_ALIGN - 1));
+	int need = size + sizeof(MemoryBlock);
+
+	auto cur = (MemoryBlock*)ptr - 1;
+
+	SmartIRQ irq;
+	for (auto mcb = ((MemoryBlock*)Address)->Next; mcb->Next != nullptr; mcb = mcb->Next)
+	{
+		if (mcb != cur) continue;
+
+		// 当前块到下一块之间的空间就是能用的上限
+		int room = (byte*)cur->Next - (byte*)cur;
+		if (need > room) return false;
+
+		_Used += need - cur->Used;
+		cur->Used = need;
+
+		// 缩小后当前块有了空闲
+		if (cur < _First) _First = cur;
+
+		return true;
+	}
+
+	// 不是本堆的内存，比如内部缓冲区
+	return false;
+}
@@ -12,17 +12,22 @@ public:
 
 	int Used() const;	// 已使用内存数
 	int Count() const;	// 已使用内存块数
+	uint Allocs() const { return _Allocs; }	// 累计分配次数
 	int FreeSize() const;	// 可用内存数
+	uint Top() const;	// 最高的已分配内存块结束地址，主栈不能越过这里
 
 	void* Alloc(int size);
 	void Free(void* ptr);
+	// 原地调整已分配内存块的大小，后面空闲足够才能扩大。失败时不做任何改变
+	bool Resize(void* ptr, int size);
 
 	// 当前堆
-	static const Heap* Current;
+	static Heap* Current;
 
 private:
 	int		_Used;
 	int		_Count;
+	uint	_Allocs;
 	void*	_First;	// 第一个有空闲的内存块，加速搜索
 };
 
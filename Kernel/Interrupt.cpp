@@ -1,14 +1,19 @@
 ﻿#include "Kernel\Sys.h"
 
 #include "Interrupt.h"
+#include "TaskTrace.h"
 
 extern InterruptCallback Vectors[];      // 对外的中断向量表
 extern void* VectorParams[];       // 每一个中断向量对应的参数
 
 TInterrupt Interrupt;
 
+static void InitDeferred();
+
 void TInterrupt::Init() const
 {
+	InitDeferred();
+
 	OnInit();
 }
 
@@ -44,7 +49,9 @@ INROOT void TInterrupt::Process(uint num) const
 	// 找到应用层中断委托并调用
 	auto isr = (InterruptCallback)Vectors[num];
 	void* param = (void*)VectorParams[num];
+	TaskTrace::Record(TaskTrace::IrqBegin, num - 16);
 	isr(num - 16, param);
+	TaskTrace::Record(TaskTrace::IrqEnd, num - 16);
 }
 
 // 系统挂起
@@ -59,6 +66,177 @@ void TInterrupt::Halt()
 	while (true);
 }
 
+/******************************** 内存区上下文 ********************************/
+
+#include "Thread.h"
+#include "Core\MemoryArena.h"
+
+// 中断里不用内存区。抢占式线程各有各的栈，按线程区分
+const void* ArenaContext()
+{
+	if(TInterrupt::IsHandler()) return nullptr;
+
+	return Thread::Current ? (const void*)Thread::Current : (const void*)&Interrupt;
+}
+
+/******************************** 中断下半部 ********************************/
+
+#include "Task.h"
+#include "TTime.h"
+#include "Atomic.h"
+
+// 下半部事件。Seq是有界队列的序号，等于位置+1时表示已发布，等于位置时表示空闲
+struct DeferredEvent
+{
+	volatile uint	Seq;
+	short	Irq;
+	uint	Data;
+	uint	Stamp;	// 投递时间，微秒
+};
+
+// 下半部处理函数，带统计
+struct DeferredHandler
+{
+	short	Irq;
+	DeferredCallback	Handler;
+	void*	Param;
+	uint	Count;		// 处理次数
+	uint	MaxLatency;	// 最大延迟，微秒
+};
+
+#define DEFER_SIZE	32	// 必须是2的幂
+#define DEFER_MAX	8
+
+static DeferredEvent	_Events[DEFER_SIZE];
+static volatile uint	_EventTail	= 0;	// 生产者位置，中断里竞争
+static uint	_EventHead	= 0;	// 消费者位置，只有调度器访问
+static AtomicInt	_EventDrops;	// 多个中断可能同时丢弃
+static uint	_EventBatches	= 0;
+static bool	_Draining	= false;
+static DeferredHandler	_Handlers[DEFER_MAX];
+
+static void InitDeferred()
+{
+	for(int i=0; i<DEFER_SIZE; i++) _Events[i].Seq	= i;
+	_EventTail	= 0;
+	_EventHead	= 0;
+}
+
+bool TInterrupt::ActivateDeferred(short irq, DeferredCallback handler, void* param)
+{
+	assert(handler, "handler");
+
+	DeferredHandler* hd	= nullptr;
+	for(int i=0; i<DEFER_MAX; i++)
+	{
+		auto& h	= _Handlers[i];
+		if(h.Handler && h.Irq == irq) { hd = &h; break; }
+		if(!h.Handler && !hd) hd	= &h;
+	}
+	if(!hd) return false;
+
+	SmartIRQ irq2;
+	hd->Irq		= irq;
+	hd->Param	= param;
+	hd->Count	= 0;
+	hd->MaxLatency	= 0;
+	hd->Handler	= handler;
+
+	return true;
+}
+
+void TInterrupt::DeactivateDeferred(short irq)
+{
+	for(int i=0; i<DEFER_MAX; i++)
+	{
+		auto& h	= _Handlers[i];
+		if(h.Handler && h.Irq == irq) h.Handler	= nullptr;
+	}
+}
+
+INROOT bool TInterrupt::Post(short irq, uint data)
+{
+	// 抢占位置。嵌套中断同时投递时，失败的一方重试下一个位置
+	uint pos	= _EventTail;
+	DeferredEvent* ev;
+	while(true)
+	{
+		ev	= &_Events[pos & (DEFER_SIZE - 1)];
+		int diff	= (int)(ev->Seq - pos);
+		if(diff == 0)
+		{
+			if(AtomicCompareExchange((volatile int*)&_EventTail, (int)pos, (int)(pos + 1))) break;
+		}
+		else if(diff < 0)
+		{
+			// 消费者还没取走，队列已满
+			++_EventDrops;
+			return false;
+		}
+		pos	= _EventTail;
+	}
+
+	ev->Irq		= irq;
+	ev->Data	= data;
+	ev->Stamp	= TaskTrace::Stamp();
+	// 最后发布，消费者看到序号才会读取
+	ev->Seq		= pos + 1;
+
+	// 打断调度器睡眠，尽快处理
+	Task::Scheduler()->Sleeping	= false;
+
+	return true;
+}
+
+void TInterrupt::Drain()
+{
+	auto& ev	= _Events[_EventHead & (DEFER_SIZE - 1)];
+	if(ev.Seq != _EventHead + 1 || _Draining) return;
+
+	_Draining	= true;
+	_EventBatches++;
+
+	// 每批最多处理一圈，避免中断风暴时饿死其它任务
+	for(int n=0; n<DEFER_SIZE; n++)
+	{
+		auto& e	= _Events[_EventHead & (DEFER_SIZE - 1)];
+		if(e.Seq != _EventHead + 1) break;
+
+		short irq	= e.Irq;
+		uint data	= e.Data;
+		// 每个事件单独取时间，前面的处理函数运行期间发布的事件也不会算出负延迟
+		uint lat	= TaskTrace::Stamp() - e.Stamp;
+		// 归还位置，下一圈的生产者可用
+		e.Seq	= _EventHead + DEFER_SIZE;
+		_EventHead++;
+
+		for(int i=0; i<DEFER_MAX; i++)
+		{
+			auto& h	= _Handlers[i];
+			if(!h.Handler || h.Irq != irq) continue;
+
+			h.Count++;
+			if(lat > h.MaxLatency) h.MaxLatency	= lat;
+			h.Handler(irq, h.Param, data);
+			break;
+		}
+	}
+
+	_Draining	= false;
+}
+
+void TInterrupt::ShowDeferred()
+{
+	debug_printf("中断下半部 批次=%d 排队=%d 丢弃=%d\r\n", _EventBatches, _EventTail - _EventHead, _EventDrops.Value());
+	for(int i=0; i<DEFER_MAX; i++)
+	{
+		auto& h	= _Handlers[i];
+		if(!h.Handler) continue;
+
+		debug_printf("\tIRQ %d \t次数 %d \t最大延迟 %dus\r\n", h.Irq, h.Count, h.MaxLatency);
+	}
+}
+
 /******************************** SmartIRQ ********************************/
 
 // 智能IRQ，初始化时备份，销毁时还原
@@ -82,31 +260,17 @@ INROOT SmartIRQ::~SmartIRQ()
 
 /******************************** Lock ********************************/
 
-#include "TTime.h"
-
 // 智能锁。初始化时锁定一个整数，销毁时解锁
+// 比较并交换一步完成判断和加锁，不需要关全局中断
 Lock::Lock(int& ref)
 {
-	Success = false;
-	if (ref > 0) return;
-
-	// 加全局锁以后再修改引用
-	SmartIRQ irq;
-	// 再次判断，DoubleLock双锁结构，避免小概率冲突
-	if (ref > 0) return;
-
 	_ref = &ref;
-	ref++;
-	Success = true;
+	Success = AtomicCompareExchange(&ref, 0, 1);
 }
 
 Lock::~Lock()
 {
-	if (Success)
-	{
-		SmartIRQ irq;
-		(*_ref)--;
-	}
+	if (Success) AtomicAdd(_ref, -1);
 }
 
 bool Lock::Wait(int ms)
@@ -114,23 +278,15 @@ bool Lock::Wait(int ms)
 	// 可能已经进入成功
 	if (Success) return true;
 
-	int& ref = *_ref;
 	// 等待超时时间
 	TimeWheel tw(ms);
 	tw.Sleep = 1;
-	while (ref > 0)
+	while (!AtomicCompareExchange(_ref, 0, 1))
 	{
 		// 延迟一下，释放CPU使用权
 		//Sys.Sleep(1);
 		if (tw.Expired()) return false;
 	}
-
-	// 加全局锁以后再修改引用
-	SmartIRQ irq;
-	// 再次判断，DoubleLock双锁结构，避免小概率冲突
-	if (ref > 0) return false;
-
-	ref++;
 	Success = true;
 
 	return true;
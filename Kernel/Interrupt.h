@@ -3,6 +3,8 @@
 
 // 中断委托（中断号，参数）
 typedef void (*InterruptCallback)(ushort num, void* param);
+// 中断下半部委托（中断号，参数，数据）
+typedef void (*DeferredCallback)(ushort num, void* param, uint data);
 
 //VectorySize 64 未考证
 // 中断管理类
@@ -17,6 +19,15 @@ public:
     bool Activate(short irq, InterruptCallback isr, void* param = nullptr);
     // 解除中断注册
     bool Deactivate(short irq);
+
+	// 注册中断下半部（中断号，函数，参数）。中断里只投递事件，由调度器在任务上下文批量处理
+	bool ActivateDeferred(short irq, DeferredCallback handler, void* param = nullptr);
+	void DeactivateDeferred(short irq);
+	// 中断里投递事件。无锁多生产者队列，只做几次读写，队列满时丢弃并计数
+	static bool Post(short irq, uint data = 0);
+	// 批量处理下半部事件。调度器每轮调用，不可重入
+	static void Drain();
+	static void ShowDeferred();
     // 开中断
     //bool Enable(short irq) const;
     // 关中断
@@ -0,0 +1,87 @@
+﻿#include "StackWatch.h"
+#include "Task.h"
+#include "Heap.h"
+
+uint*	StackWatch::_Bottom	= nullptr;
+uint*	StackWatch::_Mark	= nullptr;
+
+void StackWatch::Paint(uint* start, uint* end)
+{
+	while(start < end) *start++	= Pattern;
+}
+
+const uint* StackWatch::Mark(const uint* start, const uint* end)
+{
+	while(start < end && *start == Pattern) start++;
+
+	return start;
+}
+
+uint StackWatch::Recommend(uint used)
+{
+	uint size	= used + (used >> 2);
+
+	return (size + 7) & ~7;
+}
+
+void StackWatch::PaintMain(uint size)
+{
+	// 局部变量地址就是当前栈指针附近，留出一点余量给本函数
+	uint local	= 0;
+	auto top	= (uint*)((uint)&local & ~3) - 16;
+	auto bottom	= (uint*)((uint)top - size);
+
+	// 主栈向下生长进入堆的末尾，不能覆盖已分配的内存
+	// 在线程栈上调用时，栈指针位于堆内，这里直接放弃
+	auto hp	= Heap::Current;
+	if(hp)
+	{
+		auto heap	= (uint*)((hp->Top() + 3) & ~3);
+		if(bottom < heap) bottom	= heap;
+	}
+	if(bottom >= top) return;
+
+	Paint(bottom, top);
+	_Bottom	= bottom;
+	_Mark	= top;
+
+	debug_printf("StackWatch::PaintMain (0x%p, 0x%p) %d 字节\r\n", bottom, top, (top - bottom) << 2);
+}
+
+INROOT const uint* StackWatch::MainMark()
+{
+	auto p	= _Mark;
+	if(!p) return nullptr;
+
+	// 水位以下仍是特征值，说明没有加深
+	if(p <= _Bottom || p[-1] == Pattern) return p;
+
+	// 向下找到连续特征值为止，避免局部变量恰好等于特征值造成误判
+	while(p > _Bottom && (p[-1] != Pattern || (p - 1 > _Bottom && p[-2] != Pattern))) p--;
+	_Mark	= p;
+
+	return p;
+}
+
+uint StackWatch::MainUsed()
+{
+	auto p	= MainMark();
+	if(!p) return 0;
+
+	return Sys.StackTop() - (uint)p;
+}
+
+void StackWatch::ShowMain()
+{
+	if(!_Bottom)
+	{
+		debug_printf("StackWatch 主栈未填充\r\n");
+		return;
+	}
+
+	uint used	= MainUsed();
+	uint size	= Sys.StackTop() - (uint)_Bottom;
+	debug_printf("主栈 用量 %d/%d 字节 建议 0x%x", used, size, Recommend(used));
+	if(MainMark() <= _Bottom) debug_printf(" 已用尽填充区，实际可能更深");
+	debug_printf("\r\n");
+}
@@ -0,0 +1,37 @@
+﻿#ifndef __StackWatch_H__
+#define __StackWatch_H__
+
+#include "Kernel\Sys.h"
+
+// 栈水位。栈空间预先填充特征值，从底部向上找到第一个被改写的字，就是历史最深位置
+// 线程栈在创建时填充，主栈由PaintMain填充当前栈指针以下的一段
+class StackWatch
+{
+public:
+	static const uint Pattern	= 0xCDCDCDCD;	// 填充特征值
+
+	// 填充[start, end)
+	static void Paint(uint* start, uint* end);
+	// 从start向上找到第一个被改写的字
+	static const uint* Mark(const uint* start, const uint* end);
+	// [start, end)区间的历史最大用量，字节
+	static uint Used(const uint* start, const uint* end) { return (end - Mark(start, end)) << 2; }
+	// 建议大小。历史用量加25%余量，8字节对齐
+	static uint Recommend(uint used);
+
+	// 填充主栈当前栈指针以下size字节，不会越过已分配的堆
+	static void PaintMain(uint size = 0x800);
+	// 主栈是否已填充
+	static bool MainPainted() { return _Bottom != nullptr; }
+	// 更新主栈水位，返回当前最深位置。水位只会加深，一般只需检查一个字
+	static const uint* MainMark();
+	// 主栈历史最大用量，字节
+	static uint MainUsed();
+	static void ShowMain();
+
+private:
+	static uint*	_Bottom;	// 主栈填充区底部
+	static uint*	_Mark;		// 主栈水位
+};
+
+#endif
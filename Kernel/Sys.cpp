@@ -2,6 +2,7 @@
 
 #include "Interrupt.h"
 #include "TTime.h"
+#include "BinLog.h"
 
 TSys Sys;
 const TTime Time;
@@ -238,6 +239,9 @@ extern "C"
 	{
 		if(Sys.Clock == 0 || Sys.MessagePort == COM_NONE) return 0;
 
+		// 先发出积压的二进制日志，保持先后顺序
+		if(BinLog::Running()) BinLog::Flush();
+
 		char cs[512];
 		int tab	= 0;
 
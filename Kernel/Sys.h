@@ -175,6 +175,11 @@ public:
 void EnterCritical();
 void ExitCritical();
 
+// 原子操作。Cortex-M3/M4使用LDREX/STREX，M0没有独占指令，短暂关中断
+int AtomicAdd(volatile int* ptr, int value);	// 加上指定值，返回新值
+bool AtomicCompareExchange(volatile int* ptr, int old, int value);	// 等于old时改为value，返回是否成功
+void MemoryBarrier();
+
 //extern uint32_t __REV(uint32_t value);
 //extern uint32_t __REV16(uint16_t value);
 
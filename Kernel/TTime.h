@@ -26,6 +26,7 @@ public:
 	Func OnSave;
 	typedef void (*FuncInt)(int);
 	FuncInt OnSleep;
+	uint	Wakeups;		// 低功耗睡眠唤醒次数，用于统计每秒唤醒频率
 
     TTime();
 
@@ -37,6 +38,10 @@ public:
 	void SetTime(UInt64 seconds);	// 设置时间
 
 	void Sleep(int ms, bool* running = nullptr) const;
+	// 无滴答睡眠。暂停毫秒定时器，避免睡眠期间被定时器中断唤醒
+	void Pause();
+	// 恢复毫秒定时器，补偿睡眠期间由外部时钟测得的毫秒数
+	void Resume(uint ms);
     void Delay(int us) const;	// 微秒级延迟
 
 	uint TicksToUs(uint ticks) const;
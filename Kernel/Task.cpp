@@ -1,5 +1,10 @@
 ﻿#include "Task.h"
 #include "TTime.h"
+#include "WaitHandle.h"
+#include "Interrupt.h"
+#include "TaskTrace.h"
+#include "BinLog.h"
+#include "StackWatch.h"
 
 Task::Task()
 {
@@ -29,6 +34,11 @@ void Task::Init()
 	Cost		= 0;
 	CostMs		= 0;
 	MaxCost		= 0;
+	Total		= 0;
+	for(int i=0; i<ArrayLength(Delays); i++) Delays[i]	= 0;
+	Deadline	= 0;
+	Misses		= 0;
+	MaxStack	= 0;
 
 	Enable		= true;
 	Event		= false;
@@ -45,6 +55,20 @@ INROOT bool Task::Execute(UInt64 now)
 	if(dp >= MaxDeepth) return false;
 	dp++;
 
+	// 调度延迟，按2的幂分格统计，找出被饿死的任务
+	if(NextTime > 0 && now > NextTime)
+	{
+		uint delay	= (uint)(now - NextTime);
+		int n	= 1;
+		while(delay > 1 && n < ArrayLength(Delays) - 1) { delay >>= 1; n++; }
+		Delays[n]++;
+	}
+	else
+		Delays[0]++;
+
+	// 实时任务的释放时间，完成时间超过释放时间加截止时间即为错过
+	UInt64 release	= NextTime > 0 && NextTime < now ? NextTime : now;
+
 	// 如果是事件型任务，这里禁用。任务中可以重新启用
 	if(Event)
 		Enable	= false;
@@ -58,7 +82,12 @@ INROOT bool Task::Execute(UInt64 now)
 	auto cur	= Host->Current;
 
 	Host->Current = this;
+	TaskTrace::Record(TaskTrace::TaskBegin, ID);
+	auto mark	= StackWatch::MainMark();
 	Callback(Param);
+	// 主栈水位在本次执行中加深，记到本任务名下
+	if(mark && StackWatch::MainMark() < mark) MaxStack	= StackWatch::MainUsed();
+	TaskTrace::Record(TaskTrace::TaskEnd, ID);
 	Host->Current = cur;
 
 	// 累加任务执行次数和时间
@@ -68,12 +97,14 @@ INROOT bool Task::Execute(UInt64 now)
 
 	ct -= SleepTime;
 	if(ct > MaxCost) MaxCost = ct;
+	Total	+= ct;
+	if(Deadline > 0 && Sys.Ms() > release + Deadline) Misses++;
 	// 根据权重计算平均耗时
 	Cost	= (Cost * 5 + ct * 3) >> 3;
 	CostMs	= Cost / 1000;
 
 #if DEBUG
-	if(ct > 500000) debug_printf("Task::Execute 任务 %d [%d] 执行时间过长 %dus 睡眠 %dus\r\n", ID, Times, ct, SleepTime);
+	if(ct > 500000) log_printf("Task::Execute 任务 %d [%d] 执行时间过长 %dus 睡眠 %dus\r\n", ID, Times, ct, SleepTime);
 #endif
 
 	// 如果只是一次性任务，在这里清理
@@ -154,6 +185,26 @@ void Task::ShowStatus()
 	else
 		debug_printf("%dms", Period);
 	if(!Enable) debug_printf(" 禁用");
+	if(Deadline > 0) debug_printf(" \t截止 %dms 错过 %d", Deadline, Misses);
+	if(MaxStack) debug_printf(" \t栈 %d", MaxStack);
+
+	// CPU占比，万分比
+	auto itv	= Host->_Interval;
+	if(itv)
+	{
+		int p	= (int)((UInt64)Total * 10 / itv);
+		debug_printf(" \t占比 %d.%02d%%", p / 100, p % 100);
+	}
+	Total	= 0;
+
+	// 调度延迟直方图，只显示非空的格子
+	bool late	= false;
+	for(int i=1; i<ArrayLength(Delays); i++) if(Delays[i]) late	= true;
+	if(late)
+	{
+		debug_printf(" \t延迟");
+		for(int i=0; i<ArrayLength(Delays); i++) debug_printf(" %d", Delays[i]);
+	}
 	debug_printf("\r\n");
 }
 
@@ -176,6 +227,11 @@ TaskScheduler::TaskScheduler(cstring name)
 
 	EnterSleep	= nullptr;
 	ExitSleep	= nullptr;
+
+	NextDeadline	= nullptr;
+	_Wakeups	= 0;
+	_Interval	= 0;
+	_Realtime	= 0;
 }
 
 // 使用外部缓冲区初始化任务列表，避免频繁的堆分配
@@ -274,18 +330,121 @@ void TaskScheduler::Remove(uint taskid)
 			debug_printf("%s::Remove%d %s 0x%p\r\n", Name, task->ID, task->Name, task->Callback);
 			// 清零ID，实现重用
 			task->ID = 0;
+			if(task->Deadline > 0) _Realtime--;
+			task->Deadline	= 0;
 
 			break;
 		}
 	}
 }
 
+bool TaskScheduler::SetDeadline(uint taskid, int deadline, int cost)
+{
+	auto task	= (*this)[taskid];
+	if(!task) return false;
+
+	if(deadline > 0)
+	{
+		// 没有实测耗时无法评估，按0计算会放行任何任务
+		if(task->Times) cost	= task->Cost;
+		if(cost <= 0)
+		{
+			debug_printf("%s::SetDeadline %d %s 尚未测得耗时，拒绝\r\n", Name, task->ID, task->Name);
+			return false;
+		}
+
+		// 准入检查。EDF下实时任务总利用率不超过100%即可全部按时完成，利用率按实测平均耗时计算
+		UInt64 util	= 0;
+		for(int i=0; i<_Tasks.Count(); i++)
+		{
+			auto ti	= (Task*)_Tasks[i];
+			if(!ti || !ti->ID || ti->Period <= 0) continue;
+			if(ti != task && ti->Deadline <= 0) continue;
+
+			// 截止时间比周期短时，按截止时间计算更保守
+			int span	= ti->Period;
+			if(ti == task && deadline < span) span	= deadline;
+			else if(ti != task && ti->Deadline < span) span	= ti->Deadline;
+			util	+= (UInt64)(ti == task ? cost : ti->Cost) * 10 / span;
+		}
+		if(util > 10000)
+		{
+			debug_printf("%s::SetDeadline %d %s 利用率 %d.%02d%% 超过上限，拒绝\r\n", Name, task->ID, task->Name, (int)(util / 100), (int)(util % 100));
+			return false;
+		}
+
+		// 预计耗时作为初值，执行后由实测值修正
+		if(!task->Times)
+		{
+			task->Cost		= cost;
+			task->CostMs	= cost / 1000;
+		}
+	}
+
+	if(task->Deadline <= 0 && deadline > 0) _Realtime++;
+	if(task->Deadline > 0 && deadline <= 0) _Realtime--;
+	task->Deadline	= deadline > 0 ? deadline : 0;
+
+	return true;
+}
+
+// 按截止时间先后执行已到期的实时任务，返回执行个数
+INROOT int TaskScheduler::RunDeadlines(UInt64 end, bool isSleep, bool& cancel)
+{
+	int n	= 0;
+	// 每个实时任务最多执行一次，避免周期为0的任务独占
+	for(int k=0; k<_Realtime && !cancel; k++)
+	{
+		Task* best	= nullptr;
+		UInt64 bd	= UInt64_Max;
+		for(int i=0; i<_Tasks.Count(); i++)
+		{
+			auto task	= (Task*)_Tasks[i];
+			if(!task || !task->ID || !task->Enable || task->Deadline <= 0) continue;
+			if(!task->CheckTime(end, isSleep)) continue;
+
+			auto dl	= task->NextTime + task->Deadline;
+			if(dl < bd)
+			{
+				bd		= dl;
+				best	= task;
+			}
+		}
+		if(!best) break;
+
+		if(best->Execute(Sys.Ms())) Times++;
+		n++;
+
+		if(Sys.Ms() > end) break;
+	}
+
+	return n;
+}
+
+// 最近一个实时任务最晚必须开始的时间。普通任务预计在此之前无法完成时，推迟执行
+INROOT UInt64 TaskScheduler::LatestStart() const
+{
+	UInt64 min	= UInt64_Max;
+	for(int i=0; i<_Tasks.Count(); i++)
+	{
+		auto task	= (Task*)_Tasks[i];
+		if(!task || !task->ID || !task->Enable || task->Deadline <= 0) continue;
+
+		auto ls	= task->NextTime + task->Deadline - task->CostMs;
+		if(ls < min) min	= ls;
+	}
+
+	return min;
+}
+
 void TaskScheduler::Start()
 {
 	if(Running) return;
 
 #if DEBUG
 	Add(&TaskScheduler::ShowStatus, this, 10000, 30000, "任务状态");
+	// 填充主栈，统计各任务的栈深度
+	StackWatch::PaintMain();
 #endif
 	debug_printf("%s::准备就绪 开始循环处理%d个任务！\r\n\r\n", Name, Count);
 
@@ -313,11 +472,27 @@ INROOT void TaskScheduler::Execute(uint msMax, bool& cancel)
 {
 	TS("Task::Execute");
 
+	// 中断里设置的句柄，在这里唤醒等待者
+	WaitHandle::Flush();
+	// 中断下半部优先于普通任务
+	TInterrupt::Drain();
+
 	UInt64 now	= Sys.Ms();
 	UInt64 end	= now + msMax;
 	UInt64 min	= UInt64_Max;		// 最小时间，这个时间就会有任务到来
 
 	TimeCost tc;
+	bool isSleep	= msMax != 0xFFFFFFFF;
+
+	// 实时任务按截止时间先后优先执行，每轮只检查一次
+	UInt64 latest	= UInt64_Max;
+	if(_Realtime > 0)
+	{
+		if(RunDeadlines(end, isSleep, cancel) > 0 && (!msMax || Sys.Ms() > end)) return;
+		if(cancel) return;
+
+		latest	= LatestStart();
+	}
 
 	for(int i=0; i<_Tasks.Count(); i++)
 	{
@@ -327,13 +502,24 @@ INROOT void TaskScheduler::Execute(uint msMax, bool& cancel)
 		auto task	= (Task*)_Tasks[i];
 		if(!task || task->ID == 0 || !task->Enable) continue;
 
-		if(task->CheckTime(end, msMax != 0xFFFFFFFF))
+		bool ok	= task->CheckTime(end, isSleep);
+		// 普通任务预计耗时会挤占实时任务时，推迟到下一轮。已经迟到1秒的不再推迟，避免饿死
+		if(ok && latest != UInt64_Max && task->Deadline <= 0 && task->CostMs > 0)
+		{
+			auto now2	= Sys.Ms();
+			if(now2 + task->CostMs > latest && now2 < task->NextTime + 1000) ok	= false;
+		}
+		if(ok)
 		{
+			bool rt	= task->Deadline > 0;
 			if(task->Execute(now)) Times++;
 
 			// 为了确保至少被有效调度一次，需要在被调度任务内判断
 			// 如果已经超出最大可用时间，则退出
 			if(!msMax || Sys.Ms() > end) return;
+
+			// 实时任务执行后下一次释放时间变化
+			if(rt && _Realtime > 0) latest	= LatestStart();
 		}
 		// 注意Execute内部可能已经释放了任务
 		if(task->ID && task->Enable)
@@ -348,6 +534,13 @@ INROOT void TaskScheduler::Execute(uint msMax, bool& cancel)
 
 	Cost	+= tc.Elapsed();
 
+	// 任务之外的到期时间，如睡眠线程，也要按时醒来
+	if(NextDeadline)
+	{
+		auto dl	= NextDeadline();
+		if(dl && dl < min) min	= dl;
+	}
+
 	// 有可能这一次轮询是有限时间
 	if(min > end) min	= end;
 	// 如果有最小时间，睡一会吧
@@ -356,11 +549,13 @@ INROOT void TaskScheduler::Execute(uint msMax, bool& cancel)
 	{
 		min	-= now;
 		Sleeping	= true;
+		TaskTrace::Record(TaskTrace::SleepBegin, (ushort)min);
 		// 通知外部，需要睡眠若干毫秒
 		if(EnterSleep)
 			EnterSleep((int)min);
 		else
 			Time.Sleep((int)min, &Sleeping);
+		TaskTrace::Record(TaskTrace::SleepEnd, (ushort)min);
 		Sleeping	= false;
 
 		// 累加睡眠时间
@@ -424,6 +619,10 @@ void TaskScheduler::ShowStatus()
 	auto ts	= Times;
 	auto ct	= Cost;
 	auto p	= 10000 - (int)(TotalSleep * 10000 / (now - LastTrace));
+	// 每秒低功耗唤醒次数
+	auto wk	= (int)((Time.Wakeups - _Wakeups) * 1000 / (now - LastTrace));
+	_Wakeups	= Time.Wakeups;
+	_Interval	= (uint)(now - LastTrace);
 
 	Times	= 0;
 	Cost	= 0;
@@ -432,13 +631,14 @@ void TaskScheduler::ShowStatus()
 
 	debug_printf("Task::ShowStatus [%d]", ts);
 	debug_printf(" 负载 %d.%d%%", p/100, p%100);
-	debug_printf(" 平均 %dus 当前 ", ts ? ct/ts : 0);
+	debug_printf(" 平均 %dus 唤醒 %d/s 当前 ", ts ? ct/ts : 0, wk);
 	DateTime::Now().Show();
 	debug_printf(" 启动 ");
 	TimeSpan(now).Show(false);
 
 	auto hp	= Heap::Current;
 	debug_printf(" 堆 %d/%d\r\n", hp->Used(), hp->Count());
+	if(StackWatch::MainPainted()) StackWatch::ShowMain();
 
 	// 计算任务执行的平均毫秒数，用于中途调度其它任务，避免一个任务执行时间过长而堵塞其它任务
 	int ms = ct / 1000;
@@ -25,6 +25,11 @@ public:
 	int		Cost;		// 平均执行时间us
 	int		CostMs;		// 平均执行时间ms
 	int		MaxCost;	// 最大执行时间us
+	uint	Total;		// 统计周期内累计执行时间us，用于计算CPU占比
+	ushort	Delays[8];	// 调度延迟直方图，第n格为[2^(n-1), 2^n)毫秒，第0格为准时
+	int		Deadline;	// 相对截止时间ms，到期后必须在该时间内完成。0表示普通任务
+	uint	Misses;		// 错过截止时间的次数
+	ushort	MaxStack;	// 执行时主栈创下的最大用量，字节。主栈填充后统计，嵌套调度的任务也计入外层任务
 
 	bool	Enable;		// 是否启用
 	bool	Event;		// 是否只执行一次后暂停的事件型任务
@@ -60,6 +65,12 @@ class TaskScheduler
 private:
 	List<Task*>	_Tasks;	// 任务列表
 	bool	_SkipSleep;	// 跳过最近一次睡眠，马上开始下一轮循环
+	uint	_Wakeups;	// 上一次统计时的唤醒次数
+	uint	_Interval;	// 上一个统计周期ms
+	int		_Realtime;	// 带截止时间的实时任务个数
+
+	int RunDeadlines(UInt64 end, bool isSleep, bool& cancel);
+	UInt64 LatestStart() const;
 
 	friend class Task;
 
@@ -81,6 +92,9 @@ public:
 	SAction	EnterSleep;	// 通知外部，需要睡眠若干毫秒
 	Func	ExitSleep;	// 通知外部，要求退出睡眠，恢复调度
 
+	typedef UInt64 (*FDeadline)();
+	FDeadline	NextDeadline;	// 外部最早到期时间，如睡眠线程，参与计算睡眠时长
+
 	TaskScheduler(cstring name = nullptr);
 
 	// 使用外部缓冲区初始化任务列表，避免频繁的堆分配
@@ -97,6 +111,9 @@ public:
 		return Add(*(Action*)&func, target, dueTime, period, name);
 	}
 	void Remove(uint taskid);
+	// 设置任务的相对截止时间ms，0表示取消。按实测耗时做准入检查，实时任务总利用率超过100%时拒绝
+	// 还没有执行过的任务需要指定预计耗时cost，单位us，否则拒绝
+	bool SetDeadline(uint taskid, int deadline, int cost = 0);
 
 	void Start();
 	void Stop();
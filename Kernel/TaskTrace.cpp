@@ -0,0 +1,144 @@
+﻿#include "TaskTrace.h"
+#include "Task.h"
+#include "TTime.h"
+#include "Interrupt.h"
+
+TaskTrace::Entry*	TaskTrace::_Entries	= nullptr;
+int		TaskTrace::_Capacity	= 0;
+uint	TaskTrace::_Head	= 0;
+uint	TaskTrace::_Tail	= 0;
+uint	TaskTrace::Drops	= 0;
+
+void TaskTrace::Start(int count)
+{
+	assert(count > 0, "count");
+
+	Stop();
+
+	auto arr	= new Entry[count];
+	_Head		= 0;
+	_Tail		= 0;
+	Drops		= 0;
+	_Capacity	= count;
+	// 最后才打开记录
+	_Entries	= arr;
+}
+
+void TaskTrace::Stop()
+{
+	auto arr	= _Entries;
+	{
+		SmartIRQ irq;
+		_Entries	= nullptr;
+	}
+	if(arr) delete[] arr;
+}
+
+// 毫秒加上滴答部分。滴答部分不足一毫秒，截断避免时间倒流
+INROOT uint TaskTrace::Stamp()
+{
+	uint us	= Time.TicksToUs(Time.CurrentTicks());
+	if(us > 999) us	= 999;
+
+	return (uint)Time.Current() * 1000 + us;
+}
+
+INROOT void TaskTrace::OnRecord(Kinds kind, ushort id)
+{
+	SmartIRQ irq;
+
+	auto arr	= _Entries;
+	if(!arr) return;
+
+	// 满了覆盖最早的记录
+	if(_Head - _Tail >= (uint)_Capacity)
+	{
+		_Tail++;
+		Drops++;
+	}
+
+	auto& e	= arr[_Head % _Capacity];
+	e.Stamp		= Stamp();
+	e.ID		= id;
+	e.Kind		= kind;
+	e.Deepth	= Task::Scheduler()->Deepth;
+
+	_Head++;
+}
+
+int TaskTrace::Count()
+{
+	return _Head - _Tail;
+}
+
+// 任务在线程1，中断在线程2，方便在时间线上分开查看
+static void ShowEvent(const TaskTrace::Entry& e, bool first)
+{
+	cstring ph	= "B";
+	int tid		= 1;
+	switch(e.Kind)
+	{
+		case TaskTrace::TaskEnd:
+		case TaskTrace::SleepEnd:
+			ph	= "E";
+			break;
+		case TaskTrace::IrqBegin:
+			tid	= 2;
+			break;
+		case TaskTrace::IrqEnd:
+			ph	= "E";
+			tid	= 2;
+			break;
+		case TaskTrace::WaitSet:
+			ph	= "i";
+			break;
+	}
+
+	debug_printf(first ? "\r\n" : ",\r\n");
+	debug_printf("{\"ph\":\"%s\",\"ts\":%d,\"pid\":1,\"tid\":%d", ph, e.Stamp, tid);
+
+	switch(e.Kind)
+	{
+		case TaskTrace::TaskBegin:
+		case TaskTrace::TaskEnd:
+		{
+			auto task	= Task::Get(e.ID);
+			if(task && task->Name)
+				debug_printf(",\"name\":\"%s\"", task->Name);
+			else
+				debug_printf(",\"name\":\"Task%d\"", e.ID);
+			debug_printf(",\"args\":{\"id\":%d,\"deepth\":%d}", e.ID, e.Deepth);
+			break;
+		}
+		case TaskTrace::SleepBegin:
+		case TaskTrace::SleepEnd:
+			debug_printf(",\"name\":\"Sleep\",\"args\":{\"ms\":%d}", e.ID);
+			break;
+		case TaskTrace::IrqBegin:
+		case TaskTrace::IrqEnd:
+			debug_printf(",\"name\":\"IRQ%d\"", (short)e.ID);
+			break;
+		case TaskTrace::WaitSet:
+			debug_printf(",\"name\":\"WaitSet\",\"s\":\"t\",\"args\":{\"task\":%d}", e.ID);
+			break;
+	}
+	debug_printf("}");
+}
+
+void TaskTrace::Export()
+{
+	if(!_Entries) return;
+
+	// 导出期间暂停记录，避免调试口输出本身刷掉缓冲区
+	auto arr	= _Entries;
+	_Entries	= nullptr;
+
+	debug_printf("{\"traceEvents\":[");
+	for(uint i = _Tail; i != _Head; i++) ShowEvent(arr[i % _Capacity], i == _Tail);
+	debug_printf("\r\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"drops\":%d}}\r\n", Drops);
+
+	_Head	= 0;
+	_Tail	= 0;
+	Drops	= 0;
+	_Entries	= arr;
+}
@@ -0,0 +1,61 @@
+﻿#ifndef __TaskTrace_H__
+#define __TaskTrace_H__
+
+#include "Kernel\Sys.h"
+
+// 任务跟踪。环形缓冲区记录任务开始结束、调度器睡眠、中断进出和等待句柄事件
+// 默认关闭，Start分配缓冲区后开始记录，Export导出为Chrome trace-event格式的Json，可直接用Perfetto打开
+class TaskTrace
+{
+public:
+	// 事件类型
+	typedef enum
+	{
+		TaskBegin = 0,	// 任务开始，编号为任务ID
+		TaskEnd,		// 任务结束
+		SleepBegin,		// 调度器进入睡眠，编号为计划睡眠毫秒数
+		SleepEnd,		// 调度器醒来
+		IrqBegin,		// 进入中断，编号为中断号
+		IrqEnd,			// 退出中断
+		WaitSet,		// 等待句柄被设置，编号为句柄所在任务
+	} Kinds;
+
+	// 跟踪记录，8字节
+	struct Entry
+	{
+		uint	Stamp;	// 时间戳，微秒
+		ushort	ID;		// 编号
+		byte	Kind;	// 类型
+		byte	Deepth;	// 调度深度
+	};
+
+	static uint	Drops;	// 缓冲区满后被覆盖的记录数
+
+	// 开始记录，分配指定条数的环形缓冲区
+	static void Start(int count = 256);
+	static void Stop();
+	static bool Running() { return _Entries != nullptr; }
+
+	// 记录一个事件。关闭时只有一次判断，中断里可用
+	static void Record(Kinds kind, ushort id)
+	{
+		if(_Entries) OnRecord(kind, id);
+	}
+
+	static int Count();	// 缓冲区里的记录数
+	// 导出Chrome trace-event格式的Json到调试口，导出后清空
+	static void Export();
+
+	// 当前时间戳，微秒
+	static uint Stamp();
+
+private:
+	static Entry*	_Entries;
+	static int	_Capacity;
+	static uint	_Head;	// 写入位置，只增不减
+	static uint	_Tail;	// 最早的记录
+
+	static void OnRecord(Kinds kind, ushort id);
+};
+
+#endif
@@ -1,6 +1,8 @@
 ﻿#include "Thread.h"
 #include "Kernel\Task.h"
 #include "Interrupt.h"
+#include "ThreadPool.h"
+#include "StackWatch.h"
 
 //#define TH_DEBUG DEBUG
 #define TH_DEBUG 0
@@ -132,6 +134,12 @@ Thread::Thread(Action callback, void* state, uint stackSize)
 	assert(stk >= Stack, "Stack");
 
 	Stack = stk;
+
+	// 填充未用部分，用于统计栈水位
+	StackWatch::Paint(p, stk);
+
+	_NextAll = _All;
+	_All = this;
 }
 
 Thread::~Thread()
@@ -140,6 +148,15 @@ Thread::~Thread()
 
 	if(State != Stopped) Stop();
 
+	for(auto pp = &_All; *pp; pp = &(*pp)->_NextAll)
+	{
+		if(*pp == this)
+		{
+			*pp = _NextAll;
+			break;
+		}
+	}
+
 	Stack = StackTop - (StackSize >> 2);
 	if(Stack) delete[] Stack;
 	Stack = nullptr;
@@ -187,8 +204,8 @@ void Thread::Suspend()
 
 	if(IsReady)
 	{
-		// 修改了状态，需要重新整理就绪列表
-		BuildReady();
+		// 离开就绪队列
+		Dequeue(this);
 		if(this == Current) Switch();
 	}
 }
@@ -203,11 +220,56 @@ void Thread::Resume()
 
 	State = Ready;
 
-	if(DelayExpire > 0) _sleeps--;
+	if(DelayExpire > 0) RemoveSleep(this);
 	DelayExpire = 0;
 
-	// 修改了状态，需要重新整理就绪列表
-	BuildReady();
+	// 进入就绪队列
+	Enqueue(this);
+	Switch();
+}
+
+uint Thread::StackUsed() const
+{
+	auto bottom = StackTop - (StackSize >> 2);
+
+	return StackWatch::Used(bottom, StackTop);
+}
+
+// 建议大小扣除寄存器保存区，就是构造函数的stackSize参数
+void Thread::ShowStack() const
+{
+	uint used = StackUsed();
+	uint stk = STACK_Size;
+	uint rec = StackWatch::Recommend(used);
+	rec = rec > stk ? rec - stk : 0;
+	debug_printf("Thread %d %s \t栈 %d/%d 字节 \t建议 stackSize=0x%x", ID, Name, used, StackSize, rec);
+	if(used >= StackSize) debug_printf(" 溢出");
+	debug_printf("\r\n");
+}
+
+void Thread::ShowStacks()
+{
+	SmartIRQ irq;
+
+	for(auto th = _All; th; th = th->_NextAll) th->ShowStack();
+}
+
+void Thread::SetPriority(Priorities pri)
+{
+	SmartIRQ irq;	// 关闭全局中断
+
+	assert(pri < MaxPriority, "Priority");
+
+	if(!IsReady)
+	{
+		Priority = pri;
+		return;
+	}
+
+	// 换到新优先级的就绪队列
+	Dequeue(this);
+	Priority = pri;
+	Enqueue(this);
 	Switch();
 }
 
@@ -224,55 +286,24 @@ void Thread::Sleep(uint ms)
 #endif
 
 	State = Suspended;
-	_sleeps++;
-
-	if(IsReady)
-	{
-		// 修改了状态，需要重新整理就绪列表
-		BuildReady();
-		if(this == Current) Switch();
-	}
-}
 
-// 检查Sleep是否过期
-bool Thread::CheckExpire()
-{
-	if(State == Suspended && DelayExpire > 0 && DelayExpire <= Sys.Ms())
-	{
-		//Resume();
-		State = Ready;
-		DelayExpire = 0;
-		_sleeps--;
+	if(IsReady) Dequeue(this);
+	AddSleep(this);
 
-		return true;
-	}
-	return false;
+	if(this == Current) Switch();
 }
 
 void Thread::Add(Thread* thread)
 {
 	assert(thread, "thread");
+	assert(thread->Priority < MaxPriority, "Priority");
 
 	SmartIRQ irq;
 
-	// 如果任务列表为空，则直接作为开头
-	if(!Free)
-	{
-		Free = thread;
-
-		thread->Prev = nullptr;
-		thread->Next = nullptr;
-	}
-	else
-	{
-		// 把线程加到列表最后面
-		thread->LinkAfter(Free->Last());
-	}
-
 	Count++;
 
-	// 如果就绪队列为空或优先级更高，重建就绪队列
-	if(!Busy || thread->Priority >= Busy->Priority) BuildReady();
+	// 更高优先级的线程将在下一次切换时得到调度
+	if(thread->State == Ready) Enqueue(thread);
 }
 
 void Thread::Remove(Thread* thread)
@@ -281,110 +312,109 @@ void Thread::Remove(Thread* thread)
 
 	SmartIRQ irq;
 
-	// 如果其为头部，注意修改头部指针
-	if(thread->Prev == nullptr)
+	if(thread->IsReady)
+		Dequeue(thread);
+	else if(thread->DelayExpire > 0)
 	{
-		if(thread == Free)
-			Free = thread->Next;
-		else if(thread == Busy)
-			Busy = thread->Next;
-		else
-		{
-			assert(false, "thread->Prev");	// 如果不是两个头部，不可能前一个节点为空
-			return;
-		}
+		RemoveSleep(thread);
+		thread->DelayExpire = 0;
 	}
 
-	// 直接从链表中移除
-	thread->Unlink();
-
 	Count--;
 
 	// 如果刚好是当前线程，则放弃时间片，重新调度。因为PendSV优先级的原因，不会马上调度
 	if(thread == Current) Switch();
-	// 如果就绪队列为空，重新调度。这里其实不用操心，Switch里面会准备好Busy
-	if(Busy == nullptr) BuildReady();
 }
 
-// 查找最高优先级
-byte FindMax(Thread* first, byte pri)
+// 进入就绪队列尾部，并标记就绪位图
+void Thread::Enqueue(Thread* thread)
 {
-	for(auto th = first; th; th = th->Next)
-	{
-		if(th->State == Thread::Ready || th->State == Thread::Running)
-		{
-			if(th->Priority > pri) pri = th->Priority;
-		}
-	}
-	return pri;
+	byte pri = thread->Priority;
+
+	thread->Next = nullptr;
+	thread->Prev = nullptr;
+
+	auto tail = _Tail[pri];
+	if(tail)
+		tail->Append(thread);
+	else
+		_Ready[pri] = thread;
+	_Tail[pri] = thread;
+
+	_ReadyMap |= 1u << pri;
+	thread->IsReady = true;
 }
 
-// 建立指定优先级的线程列表
-byte BuildList(Thread*& list, Thread*& head, Thread*& tail, byte pri)
+// 离开就绪队列，队列为空时清除就绪位图
+void Thread::Dequeue(Thread* thread)
 {
-	byte count = 0;
-	for(auto th = list; th; th = th->Next)
-	{
-		if(th->State == Thread::Ready || th->State == Thread::Running)
-		{
-			if(th->Priority == pri)
-			{
-				// 如果是开头，则重置开头
-				if(th == list) list = th->Next;
+	byte pri = thread->Priority;
+
+	if(_Ready[pri] == thread) _Ready[pri] = thread->Next;
+	if(_Tail[pri] == thread) _Tail[pri] = thread->Prev;
+	thread->Unlink();
 
-				// 从原队列出列
-				th->Unlink();
+	if(!_Ready[pri]) _ReadyMap &= ~(1u << pri);
+	thread->IsReady = false;
+}
 
-				// 加入队列
-				if(!head)
-					head = tail = th;
-				else
-					th->LinkAfter(tail);
+// 按到期时间插入睡眠队列，到期时间相同的按先后顺序
+void Thread::AddSleep(Thread* thread)
+{
+	thread->Next = nullptr;
+	thread->Prev = nullptr;
 
-				count++;
+	auto expire = thread->DelayExpire;
+	Thread* prev = nullptr;
+	for(auto th = _Sleeping; th && th->DelayExpire <= expire; th = th->Next) prev = th;
 
-				th->IsReady = true;
-				continue;
-			}
-		}
-		th->IsReady = false;
+	if(prev)
+	{
+		auto next = prev->Next;
+		prev->Append(thread);
+		if(next) thread->Append(next);
+	}
+	else
+	{
+		if(_Sleeping) thread->Append(_Sleeping);
+		_Sleeping = thread;
 	}
-	return count;
 }
 
-// 准备最高优先级的就绪队列。时间片将在该队列中分配
-byte Thread::BuildReady()
+void Thread::RemoveSleep(Thread* thread)
 {
-	SmartIRQ irq;
-
-	// 为了让算法简单易懂，采用两次循环，一次获取最高优先级，第二次才构建就绪列表
-
-	// 找出所有已就绪线程的最高优先级
-	byte pri = Lowest;
-	pri = FindMax(Free, pri);
-	pri = FindMax(Busy, pri);
+	if(_Sleeping == thread) _Sleeping = thread->Next;
+	thread->Unlink();
+}
 
-	// 根据最高优先级重构线程就绪队列
-	Thread* head = nullptr;
-	Thread* tail = nullptr;
-	byte count = 0;
-	count += BuildList(Free, head, tail, pri);
-	count += BuildList(Busy, head, tail, pri);
-	_running = count;
+// 取最高位。Cortex-M3/M4有CLZ指令，M0没有，采用二分查找
+static inline byte HighBit(uint map)
+{
+#if defined(__CC_ARM) && !defined(STM32F0)
+	return 31 - __clz(map);
+#else
+	byte n = 0;
+	if(map & 0xFFFF0000) { n += 16; map >>= 16; }
+	if(map & 0xFF00) { n += 8; map >>= 8; }
+	if(map & 0xF0) { n += 4; map >>= 4; }
+	if(map & 0x0C) { n += 2; map >>= 2; }
+	if(map & 0x02) { n += 1; }
+	return n;
+#endif
+}
 
-	// 原就绪队列余下节点回到自由队列
-	if(Busy)
-	{
-		if(Free)
-			Busy->LinkAfter(Free->Last());
-		else
-			Free = Busy;
-	}
+// 睡眠队列有序，头部就是最早到期的线程
+UInt64 Thread::NextExpire()
+{
+	return _Sleeping ? _Sleeping->DelayExpire : 0;
+}
 
-	// 新的就绪队列
-	Busy = head;
+// 最高优先级就绪队列的头部
+Thread* Thread::FindReady()
+{
+	if(!_ReadyMap) return nullptr;
 
-	return count;
+	return _Ready[HighBit(_ReadyMap)];
 }
 
 static void OnSleep(int ms)
@@ -405,6 +435,8 @@ void Thread::Schedule()
 
 	//Sys.OnTick = OnTick;
 	((TSys&)Sys).OnSleep = OnSleep;
+	// 任务调度器计算睡眠时长时考虑睡眠线程，确保按时唤醒
+	Task::Scheduler()->NextDeadline = NextExpire;
 
 	// 先切换好了才换栈，因为里面有很多层调用，不确定新栈空间是否足够
 	Switch();
@@ -441,21 +473,17 @@ void Thread::Switch()
 		Current->CheckStack();
 
 		curStack = &Current->Stack;
-
-		// 下一个获得时间片的线程
-		Current = Current->Next;
 	}
-	// 如果下一个线程为空
-	if(!Current)
-	{
-		// 如果就绪队列也为空，则重建就绪队列
-		if(!Busy) BuildReady();
 
-		// 重新取就绪队列头部
-		Current = Busy;
-		if(!Current) debug_printf("没有可调度线程，可能是挂起或睡眠了Idle线程\r\n");
-		assert(Current, "Current");
-	}
+	// 当前线程仍然属于最高优先级就绪队列时，时间片交给它的下一个节点，否则从最高优先级队列头部开始
+	auto head = FindReady();
+	if(!head) debug_printf("没有可调度线程，可能是挂起或睡眠了Idle线程\r\n");
+	assert(head, "Current");
+
+	auto next = head;
+	if(Current && Current->IsReady && Current->Priority == head->Priority && Current->Next) next = Current->Next;
+	Current = next;
+
 	newStack = Current->Stack;
 
 	// 如果栈相同，说明是同一个线程，不需要切换
@@ -471,19 +499,21 @@ void Thread::Switch()
 
 void Thread::OnTick()
 {
-	if(_sleeps > 0)
+	// 睡眠队列有序，只需要检查头部，唤醒到期的线程
+	if(_Sleeping)
 	{
-		// 检查睡眠到期的线程
-		bool flag = false;
-		for(Thread* th = Free; th; th = th->Next)
+		auto now = Sys.Ms();
+		while(_Sleeping && _Sleeping->DelayExpire <= now)
 		{
-			flag |= th->CheckExpire();
+			auto th = _Sleeping;
+			RemoveSleep(th);
+
+			th->State = Ready;
+			th->DelayExpire = 0;
+			Enqueue(th);
 		}
-		if(flag) BuildReady();
 	}
 
-	/*// 单一任务不调度
-	if(_running > 1) Switch();*/
 	Switch();
 }
 
@@ -491,11 +521,12 @@ void Idle_Handler(void* param) { while(1); }
 void Main_Handler(void* param) { Task::Scheduler()->Start(); while(1); }
 
 bool Thread::Inited = false;
+Thread* Thread::_All = nullptr;
 uint Thread::g_ID = 0;
-byte Thread::_running = 0;
-byte Thread::_sleeps = 0;
-Thread* Thread::Free = nullptr;
-Thread* Thread::Busy = nullptr;
+uint Thread::_ReadyMap = 0;
+Thread* Thread::_Ready[Thread::MaxPriority];
+Thread* Thread::_Tail[Thread::MaxPriority];
+Thread* Thread::_Sleeping = nullptr;
 Thread* Thread::Current = nullptr;
 byte Thread::Count = 0;
 Thread* Thread::Idle = nullptr;
@@ -510,8 +541,13 @@ void Thread::Init()
 
 	Inited = true;
 
-	Free = nullptr;
-	Busy = nullptr;
+	_ReadyMap = 0;
+	for(int i = 0; i < MaxPriority; i++)
+	{
+		_Ready[i] = nullptr;
+		_Tail[i] = nullptr;
+	}
+	_Sleeping = nullptr;
 	Current = nullptr;
 
 	// 创建一个空闲线程，确保队列不为空
@@ -546,52 +582,8 @@ void Thread::OnEnd()
 }
 
 /*************************************************************************/
-// 线程池任务型
-class ThreadItem
-{
-private:
-	Thread*	_thread;
-
-public:
-	Action	Callback;	// 委托
-	void*	Param;		// 参数
-
-	ThreadItem()
-	{
-		_thread = new Thread(OnWork);
-	}
-
-	~ThreadItem()
-	{
-		delete _thread;
-		_thread = nullptr;
-	}
-
-	static void OnWork(void* param)
-	{
-		((ThreadItem*)param)->Work();
-	}
-
-	void Work()
-	{
-		while(true)
-		{
-			if(Callback) Callback(Param);
-
-			_thread->Suspend();
-		}
-	}
-
-	void Resume()
-	{
-		_thread->Resume();
-	}
-};
-
-/*void QueueUserWorkItem(Func func)
-{
-}*/
-
-void QueueUserWorkItem(Action func, void* param)
+// 线程池。交给默认线程池的工作线程执行，不阻塞Main线程上的定时任务
+void Thread::QueueUserWorkItem(Action func, void* param)
 {
+	if(!ThreadPool::Default()->Post(func, param)) debug_printf("Thread::QueueUserWorkItem 线程池队列已满\r\n");
 }
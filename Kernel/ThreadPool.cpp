@@ -0,0 +1,232 @@
+﻿#include "ThreadPool.h"
+#include "Interrupt.h"
+
+/******************************** WorkItem ********************************/
+
+WorkItem::WorkItem(Action func, void* param)
+{
+	Callback	= func;
+	Param		= param;
+	Result		= nullptr;
+	AutoDelete	= false;
+}
+
+/******************************** Worker ********************************/
+
+// 工作线程。单核上关中断即可保护双端队列，主人从尾部进出，窃取者从头部取
+class ThreadPool::Worker
+{
+public:
+	ThreadPool*	Pool;
+	Thread*	Host;	// 所在线程
+	bool	Idle;	// 队列为空，已挂起
+
+	WorkItem*	Items[QueueSize];
+	uint	Top;	// 头部，窃取者取走
+	uint	Bottom;	// 尾部，主人进出
+
+	int Count() const { return Bottom - Top; }
+
+	// 压入尾部。调用者负责关中断
+	bool Push(WorkItem* item)
+	{
+		if(Count() >= QueueSize) return false;
+
+		Items[Bottom++ % QueueSize]	= item;
+		return true;
+	}
+
+	// 从尾部弹出，后进先出，刚投递的数据还在缓存里
+	WorkItem* Pop()
+	{
+		SmartIRQ irq;
+
+		if(Bottom == Top) return nullptr;
+		return Items[--Bottom % QueueSize];
+	}
+
+	// 从头部窃取，先进先出，取走最早排队的工作
+	WorkItem* Take()
+	{
+		SmartIRQ irq;
+
+		if(Bottom == Top) return nullptr;
+		return Items[Top++ % QueueSize];
+	}
+};
+
+/******************************** ThreadPool ********************************/
+
+ThreadPool::ThreadPool(int workers, uint stackSize, Thread::Priorities pri)
+{
+	assert(workers > 0 && workers <= MaxWorkers, "workers");
+
+	Posts		= 0;
+	Steals		= 0;
+	Executed	= 0;
+	_Count		= workers;
+	_Next		= 0;
+
+	for(int i=0; i<MaxWorkers; i++) _Workers[i]	= nullptr;
+
+	for(int i=0; i<workers; i++)
+	{
+		auto wk	= new Worker();
+		wk->Pool	= this;
+		wk->Idle	= false;
+		wk->Top		= 0;
+		wk->Bottom	= 0;
+
+		auto th	= new Thread(OnWork, wk, stackSize);
+		th->Name	= "Worker";
+		th->Priority	= pri;
+		wk->Host	= th;
+
+		_Workers[i]	= wk;
+	}
+	for(int i=0; i<workers; i++) _Workers[i]->Host->Start();
+}
+
+ThreadPool::~ThreadPool()
+{
+	for(int i=0; i<_Count; i++)
+	{
+		auto wk	= _Workers[i];
+		delete wk->Host;
+		delete wk;
+		_Workers[i]	= nullptr;
+	}
+}
+
+bool ThreadPool::Post(WorkItem* item)
+{
+	assert(item && item->Callback, "item");
+
+	item->Handle.Reset();
+
+	SmartIRQ irq;
+
+	// 工作线程里投递的子任务进入自己的队列，其余轮流分配
+	int idx	= -1;
+	for(int i=0; i<_Count; i++)
+	{
+		if(_Workers[i]->Host == Thread::Current) { idx = i; break; }
+	}
+	if(idx < 0)
+	{
+		idx	= _Next;
+		_Next	= (_Next + 1) % _Count;
+	}
+
+	// 目标队列满时换下一个
+	for(int i=0; i<_Count; i++)
+	{
+		auto wk	= _Workers[(idx + i) % _Count];
+		if(!wk->Push(item)) continue;
+
+		AtomicAdd((volatile int*)&Posts, 1);
+		if(wk->Idle)
+		{
+			wk->Idle	= false;
+			wk->Host->Resume();
+		}
+		// 其它空闲线程也叫醒，让它们来窃取
+		for(int k=0; k<_Count; k++)
+		{
+			auto other	= _Workers[k];
+			if(other->Idle && wk->Count() > 1)
+			{
+				other->Idle	= false;
+				other->Host->Resume();
+			}
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool ThreadPool::Post(Action func, void* param)
+{
+	auto item	= new WorkItem(func, param);
+	item->AutoDelete	= true;
+
+	if(Post(item)) return true;
+
+	delete item;
+	return false;
+}
+
+int ThreadPool::Count() const
+{
+	SmartIRQ irq;
+
+	int n	= 0;
+	for(int i=0; i<_Count; i++) n	+= _Workers[i]->Count();
+
+	return n;
+}
+
+WorkItem* ThreadPool::Steal(Worker* self)
+{
+	// 从队列最长的工作线程窃取
+	Worker* victim	= nullptr;
+	for(int i=0; i<_Count; i++)
+	{
+		auto wk	= _Workers[i];
+		if(wk != self && wk->Count() > 0 && (!victim || wk->Count() > victim->Count())) victim	= wk;
+	}
+	if(!victim) return nullptr;
+
+	auto item	= victim->Take();
+	if(item) AtomicAdd((volatile int*)&Steals, 1);
+
+	return item;
+}
+
+void ThreadPool::OnWork(void* param)
+{
+	auto wk		= (Worker*)param;
+	auto pool	= wk->Pool;
+
+	while(true)
+	{
+		auto item	= wk->Pop();
+		if(!item) item	= pool->Steal(wk);
+
+		if(item)
+		{
+			item->Callback(item->Param);
+			AtomicAdd((volatile int*)&pool->Executed, 1);
+
+			if(item->AutoDelete)
+				delete item;
+			else
+				// 在线程里完成，与调度器并发，经延迟信号队列唤醒等待的任务
+				item->Handle.SetISR();
+
+			continue;
+		}
+
+		// 没有工作时挂起，投递时恢复。检查与挂起之间不能被投递打断
+		SmartIRQ irq;
+		if(wk->Count() == 0)
+		{
+			wk->Idle	= true;
+			wk->Host->Suspend();
+		}
+	}
+}
+
+void ThreadPool::ShowStatus() const
+{
+	debug_printf("ThreadPool 线程=%d 投递=%d 完成=%d 窃取=%d 排队=%d\r\n", _Count, Posts, Executed, Steals, Count());
+}
+
+ThreadPool* ThreadPool::Default()
+{
+	static ThreadPool* _pool	= nullptr;
+	if(!_pool) _pool	= new ThreadPool();
+
+	return _pool;
+}
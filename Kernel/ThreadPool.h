@@ -0,0 +1,61 @@
+﻿#ifndef __ThreadPool_H__
+#define __ThreadPool_H__
+
+#include "Kernel\Sys.h"
+#include "Kernel\Thread.h"
+#include "Kernel\WaitHandle.h"
+
+// 工作项。投递到线程池后台执行，完成时设置Handle，相当于future
+// 任务里可以Handle.WaitOne等待，协程里CO_WAIT(item.Handle, ms)等待，完成时马上唤醒
+class WorkItem
+{
+public:
+	Action	Callback;	// 委托
+	void*	Param;		// 参数
+	void*	Result;		// 结果，由委托写入
+	WaitHandle	Handle;	// 完成时被设置
+	bool	AutoDelete;	// 完成后自动销毁。用于不关心结果的投递
+
+	WorkItem(Action func = nullptr, void* param = nullptr);
+
+	bool Completed() const { return Handle.Result; }
+	bool Wait(int ms = -1) { return Handle.WaitOne(ms); }
+};
+
+// 线程池。固定数量的工作线程，每个线程一个双端队列
+// 工作线程从自己队列尾部取任务，空闲时从其它线程队列头部窃取
+class ThreadPool
+{
+public:
+	static const int MaxWorkers	= 4;	// 最大工作线程数
+	static const int QueueSize	= 8;	// 每个工作线程的队列容量
+
+	// 统计。工作线程之间会抢占，原子递增
+	uint	Posts;	// 投递数
+	uint	Steals;	// 窃取数
+	uint	Executed;	// 完成数
+
+	ThreadPool(int workers = 2, uint stackSize = 0x400, Thread::Priorities pri = Thread::BelowNormal);
+	~ThreadPool();
+
+	// 投递工作项，所有队列都满时返回false
+	bool Post(WorkItem* item);
+	// 投递不关心结果的工作
+	bool Post(Action func, void* param);
+
+	int Count() const;	// 排队中的工作项数
+	void ShowStatus() const;
+
+	static ThreadPool* Default();	// 默认线程池，首次使用时创建
+
+private:
+	class Worker;
+	Worker*	_Workers[MaxWorkers];
+	int		_Count;
+	int		_Next;	// 轮流投递的下一个工作线程
+
+	WorkItem* Steal(Worker* self);
+	static void OnWork(void* param);
+};
+
+#endif
@@ -38,6 +38,7 @@ TTime::TTime()
 	OnLoad = nullptr;
 	OnSave = nullptr;
 	OnSleep = nullptr;
+	Wakeups = 0;
 }
 
 void TTime::SetTime(UInt64 sec)
@@ -71,6 +72,7 @@ INROOT void TTime::Sleep(int ms, bool* running) const
 		while (ms >= 10)
 		{
 			OnSleep(ms);
+			((TTime*)this)->Wakeups++;
 
 			// 判断是否需要继续
 			if (running != nullptr && !*running) break;
@@ -1,12 +1,19 @@
 ﻿#include "Task.h"
 
 #include "WaitHandle.h"
+#include "TaskTrace.h"
+
+// 延迟信号队列。中断里设置的句柄先放这里，由调度器在任务上下文唤醒等待者
+static WaitHandle*	_Pending[8];
+static volatile byte	_PendingCount	= 0;
 
 WaitHandle::WaitHandle()
 {
 	Result		= false;
 
-	TaskID = Task::Current().ID;
+	auto task	= Task::Scheduler()->Current;
+	TaskID	= task ? task->ID : 0;
+	Waiter	= 0;
 	State = nullptr;
 }
 
@@ -20,7 +27,239 @@ bool WaitHandle::WaitOne(int ms)
 	return Result;
 }
 
+bool WaitHandle::CanWait()
+{
+	auto sc	= Task::Scheduler();
+
+	return sc->Deepth < sc->MaxDeepth;
+}
+
+void WaitHandle::Reset()
+{
+	Result	= false;
+}
+
 void WaitHandle::Set()
 {
 	Result	= true;
+	TaskTrace::Record(TaskTrace::WaitSet, TaskID);
+
+	Wake(this);
+}
+
+void WaitHandle::Wake(WaitHandle* handle)
+{
+	// 登记的等待任务马上调度，同时会打断调度器睡眠
+	if(handle->Waiter)
+		Sys.SetTask(handle->Waiter, true, 0);
+	// 阻塞等待者在ExecuteForWait里，打断睡眠后马上检查结果
+	else
+		Task::Scheduler()->SkipSleep();
+}
+
+void WaitHandle::SetISR()
+{
+	Result	= true;
+	TaskTrace::Record(TaskTrace::WaitSet, TaskID);
+
+	{
+		SmartIRQ irq;
+		// 队列满时放弃唤醒，等待者仍然会在下一轮调度发现结果
+		if(_PendingCount < ArrayLength(_Pending)) _Pending[_PendingCount++]	= this;
+	}
+
+	// 打断调度器睡眠，尽快处理延迟信号
+	Task::Scheduler()->Sleeping	= false;
+}
+
+void WaitHandle::Flush()
+{
+	if(!_PendingCount) return;
+
+	WaitHandle* hs[ArrayLength(_Pending)];
+	int count	= 0;
+	{
+		SmartIRQ irq;
+		count	= _PendingCount;
+		for(int i=0; i<count; i++) hs[i]	= _Pending[i];
+		_PendingCount	= 0;
+	}
+
+	for(int i=0; i<count; i++) Wake(hs[i]);
+}
+
+/******************************** AutoResetEvent ********************************/
+
+bool AutoResetEvent::WaitOne(int ms)
+{
+	if(!WaitHandle::WaitOne(ms)) return false;
+
+	Result	= false;
+
+	return true;
+}
+
+bool AutoResetEvent::TryWait()
+{
+	if(!Result) return false;
+
+	Result	= false;
+
+	return true;
+}
+
+/******************************** Semaphore ********************************/
+
+Semaphore::Semaphore(int count, int max)
+{
+	Count	= count;
+	Max		= max;
+}
+
+bool Semaphore::TryWait()
+{
+	SmartIRQ irq;
+
+	if(Count <= 0) return false;
+
+	Count--;
+
+	return true;
+}
+
+bool Semaphore::Wait(int ms)
+{
+	if(TryWait()) return true;
+	if(ms == 0) return false;
+
+	// 实际可用时间，-1表示无限等待
+	if(ms == -1) ms	= 0x7FFFFFFF;
+	auto end	= Sys.Ms() + ms;
+
+	// 可能有多个等待者，被唤醒后重新争抢
+	while(true)
+	{
+		// 先清除再检查，避免检查之后到等待之前的信号丢失
+		Handle.Reset();
+		if(TryWait()) return true;
+		// 无法调度其它任务时没有人会释放，直接失败，避免空转到超时
+		if(!WaitHandle::CanWait()) return false;
+
+		Handle.WaitOne(ms);
+
+		ms	= (int)(end - Sys.Ms());
+		if(ms <= 0) return TryWait();
+	}
+}
+
+int Semaphore::Release(int count)
+{
+	int old	= 0;
+	{
+		SmartIRQ irq;
+
+		old	= Count;
+		Count	+= count;
+		if(Count > Max) Count	= Max;
+	}
+
+	Handle.Set();
+
+	return old;
+}
+
+/******************************** IChannel ********************************/
+
+IChannel::IChannel(int capacity)
+{
+	assert(capacity > 0, "capacity");
+
+	_Arr		= new void*[capacity];
+	_Capacity	= capacity;
+	_Head		= 0;
+	_Count		= 0;
+}
+
+IChannel::~IChannel()
+{
+	delete[] _Arr;
+}
+
+bool IChannel::TryWrite(void* item)
+{
+	{
+		SmartIRQ irq;
+
+		if(_Count >= _Capacity) return false;
+
+		int p	= _Head + _Count;
+		if(p >= _Capacity) p	-= _Capacity;
+		_Arr[p]	= item;
+		_Count++;
+	}
+
+	CanRead.Set();
+
+	return true;
+}
+
+bool IChannel::TryRead(void*& item)
+{
+	{
+		SmartIRQ irq;
+
+		if(_Count <= 0) return false;
+
+		item	= _Arr[_Head];
+		if(++_Head >= _Capacity) _Head	= 0;
+		_Count--;
+	}
+
+	CanWrite.Set();
+
+	return true;
+}
+
+bool IChannel::Write(void* item, int ms)
+{
+	if(TryWrite(item)) return true;
+	if(ms == 0) return false;
+
+	if(ms == -1) ms	= 0x7FFFFFFF;
+	auto end	= Sys.Ms() + ms;
+
+	while(true)
+	{
+		// 先清除再检查，避免检查之后到等待之前的信号丢失
+		CanWrite.Reset();
+		if(TryWrite(item)) return true;
+		if(!WaitHandle::CanWait()) return false;
+
+		CanWrite.WaitOne(ms);
+
+		ms	= (int)(end - Sys.Ms());
+		if(ms <= 0) return TryWrite(item);
+	}
+}
+
+bool IChannel::Read(void*& item, int ms)
+{
+	if(TryRead(item)) return true;
+	if(ms == 0) return false;
+
+	if(ms == -1) ms	= 0x7FFFFFFF;
+	auto end	= Sys.Ms() + ms;
+
+	while(true)
+	{
+		// 先清除再检查，避免检查之后到等待之前的信号丢失
+		CanRead.Reset();
+		if(TryRead(item)) return true;
+		if(!WaitHandle::CanWait()) return false;
+
+		CanRead.WaitOne(ms);
+
+		ms	= (int)(end - Sys.Ms());
+		if(ms <= 0) return TryRead(item);
+	}
 }
@@ -2,21 +2,98 @@
 #define __WaitHandle_H__
 
 // 等待句柄
+// 阻塞等待者在ExecuteForWait里调度其它任务，设置时打断调度器睡眠，让等待者马上发现结果
+// 协程等待者登记Waiter，设置时直接唤醒所在任务
 class WaitHandle
 {
 public:
 	uint	TaskID;	// 句柄所在任务
+	uint	Waiter;	// 登记的等待任务，设置时马上调度。0表示没有
 	void*	State;	// 用户数据
 	bool	Result;	// 结果
 
 	WaitHandle();
 	
 	bool WaitOne(int ms);	// 等待一个
+	// 能否阻塞等待。调度器已达最大深度时无法再调度其它任务，等待不会有结果
+	static bool CanWait();
 	
-	//void Reset();
+	void Reset();	// 清除结果
 	void Set();	// 设置结果
-	
+	// 中断里设置结果。唤醒动作放入延迟信号队列，由调度器在任务上下文完成
+	void SetISR();
+
+	// 处理延迟信号队列。调度器每轮调用
+	static void Flush();
+
 private:
+	static void Wake(WaitHandle* handle);
+};
+
+// 自动重置事件。每次设置只放行一个等待者，等待成功后自动清除
+class AutoResetEvent : public WaitHandle
+{
+public:
+	bool WaitOne(int ms);
+	// 不等待，已设置时取走信号并返回true
+	bool TryWait();
+};
+
+// 信号量。计数大于0时等待者取走一个，否则等待释放
+class Semaphore
+{
+public:
+	int		Count;	// 当前计数
+	int		Max;	// 最大计数
+	WaitHandle	Handle;	// 释放时被设置，用于唤醒等待者
+
+	Semaphore(int count = 0, int max = 0x7FFF);
+
+	bool Wait(int ms);
+	// 不等待，计数大于0时取走一个并返回true
+	bool TryWait();
+	// 释放若干个，返回释放前的计数
+	int Release(int count = 1);
+};
+
+// 有界通道。固定容量的指针队列，满时写入者等待，空时读取者等待
+class IChannel
+{
+public:
+	WaitHandle	CanRead;	// 写入数据后被设置
+	WaitHandle	CanWrite;	// 读走数据后被设置
+
+	IChannel(int capacity);
+	virtual ~IChannel();
+
+	int Count() const { return _Count; }
+	int Capacity() const { return _Capacity; }
+
+	bool TryWrite(void* item);
+	bool TryRead(void*& item);
+	// 在超时时间内写入，满时等待读取者
+	bool Write(void* item, int ms = -1);
+	// 在超时时间内读取，空时等待写入者
+	bool Read(void*& item, int ms = -1);
+
+private:
+	void**	_Arr;
+	int		_Capacity;
+	int		_Head;
+	int		_Count;
+};
+
+template<typename T>
+class Channel : public IChannel
+{
+	static_assert(sizeof(T) <= 4, "Channel only support pointer or int");
+public:
+	Channel(int capacity) : IChannel(capacity) { }
+
+	bool TryWrite(T item) { return IChannel::TryWrite((void*)item); }
+	bool TryRead(T& item) { return IChannel::TryRead((void*&)item); }
+	bool Write(T item, int ms = -1) { return IChannel::Write((void*)item, ms); }
+	bool Read(T& item, int ms = -1) { return IChannel::Read((void*&)item, ms); }
 };
 
 #endif
@@ -1,5 +1,7 @@
 ﻿#include "Kernel\TTime.h"
 #include "Kernel\WaitHandle.h"
+#include "Core\Intern.h"
+#include "Core\MemoryArena.h"
 
 #include "Net\Socket.h"
 #include "Net\NetworkInterface.h"
@@ -147,6 +149,11 @@ uint LinkClient::Dispatch(ITransport* port, Buffer& bs, void* param, void* param
 		return 0;
 	}
 
+	// 处理期间的临时对象从栈上内存区分配，处理完整体释放
+	byte abuf[0x100];
+	MemoryArena arena(abuf, sizeof(abuf));
+	ArenaScope scope(arena);
+
 	client.OnReceive(msg);
 
 	return 0;
@@ -221,15 +228,24 @@ void LinkClient::OnReceive(LinkMessage& msg)
 	}
 
 	auto act = js["action"].AsString();
-	if (act == "Device/Login")
-		OnLogin(msg);
-	else if (act == "Device/Ping")
-		OnPing(msg);
-	else if (act == "Read")
-		OnRead(msg);
-	else if (act == "Write")
-		OnWrite(msg);
-	else if (!msg.Reply) {
+	// 内置动作按编译期哈希分派，哈希相同再比较一次内容
+	switch (Intern::Hash(act.GetBuffer(), act.Length()))
+	{
+		case HashOf("Device/Login"):
+			if (act == "Device/Login") { OnLogin(msg); return; }
+			break;
+		case HashOf("Device/Ping"):
+			if (act == "Device/Ping") { OnPing(msg); return; }
+			break;
+		case HashOf("Read"):
+			if (act == "Read") { OnRead(msg); return; }
+			break;
+		case HashOf("Write"):
+			if (act == "Write") { OnWrite(msg); return; }
+			break;
+	}
+
+	if (!msg.Reply) {
 		// 调用全局动作
 		auto act2 = act;
 		String rs;
@@ -62,8 +62,8 @@ LinkConfig* LinkConfig::Create(cstring server)
 		tc.Show();
 
 		// 注册全局动作
-		Api.Register("SetServer", &LinkConfig::SetServer, &tc);
-		Api.Register("GetServer", &LinkConfig::GetServer, &tc);
+		Api.Register("SetServer", MethodOf(&LinkConfig::SetServer), &tc);
+		Api.Register("GetServer", MethodOf(&LinkConfig::GetServer), &tc);
 	}
 
 	return &tc;
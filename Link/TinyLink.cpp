@@ -126,9 +126,12 @@ bool TinyLink::Send(LinkMessage& msg, const String& data) {
 	str.Show(true);
 #endif
 
-	// 发送
-	Port->Write(Buffer(&msg, sizeof(msg)));
-	return Port->Write(str);
+	// 头部和数据作为同一帧分段发送
+	BufferChain bc;
+	bc.Add(&msg, sizeof(msg));
+	bc.Add(str);
+
+	return Port->Write(bc);
 }
 
 bool TinyLink::Invoke(const String& action, const Json& args) {
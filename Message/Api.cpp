@@ -1,29 +1,39 @@
-﻿#include "Api.h"
+﻿#include "Core\Intern.h"
+
+#include "Api.h"
 
 // 全局对象
 TApi Api;
 
-TApi::TApi() :Routes(String::Compare), Params(String::Compare) {
+TApi::TApi() {
 
 }
 
 // 注册远程调用处理器
 void TApi::Register(cstring action, ApiHandler handler, void* param) {
-	Routes.Add(action, handler);
-	Params.Add(action, param);
+	// 名称驻留后作为键，调用时按指针匹配
+	auto key = Intern::Static(action);
+	Routes.Add(key, handler);
+	Params.Add(key, param);
 }
 
 // 是否包含指定动作
 bool TApi::Contain(cstring action) {
-	return Routes.ContainKey(action);
+	auto key = Intern::Find(action);
+
+	return key && Routes.ContainKey(key);
 }
 
 // 执行接口
 int TApi::Invoke(cstring action, const String& args, String& result) {
+	// 未驻留的动作肯定没有注册
+	auto key = Intern::Find(action);
+	if (!key) return -1;
+
 	ApiHandler handler;
-	if (!Routes.TryGetValue(action, handler)) return -1;
+	if (!Routes.TryGetValue(key, handler)) return -1;
 
-	void* p = Params[action];
+	void* p = Params[key];
 
 	return handler(p, args, result);
 }
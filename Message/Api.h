@@ -13,19 +13,13 @@ typedef int(*ApiHandler)(void* param, const String& args, String& result);
 class TApi
 {
 public:
-	Dictionary<cstring, ApiHandler>	Routes;	// 路由集合
-	Dictionary<cstring, void*>		Params;	// 参数集合
+	Dictionary<cstring, ApiHandler>	Routes;	// 路由集合，键为驻留名称
+	Dictionary<cstring, void*>		Params;	// 参数集合，键为驻留名称
 
 	TApi();
 
-	// 注册远程调用处理器
+	// 注册远程调用处理器。成员函数用MethodOf(&T::Func)
 	void Register(cstring action, ApiHandler handler, void* param = nullptr);
-	// 模版支持成员函数
-	template<typename T>
-	void Register(cstring action, int(T::*func)(const String&, String&), T* target)
-	{
-		Register(action, *(ApiHandler*)&func, target);
-	}
 
 	// 是否包含指定动作
 	bool Contain(cstring action);
@@ -1,4 +1,6 @@
-﻿#include "Controller.h"
+﻿#include "Core\MemoryArena.h"
+
+#include "Controller.h"
 
 //#define MSG_DEBUG DEBUG
 #define MSG_DEBUG 0
@@ -14,6 +16,11 @@ Controller::Controller()
 	Port	= nullptr;
 	MinSize	= 0;
 	Opened	= false;
+
+	UseArena	= true;
+	ArenaMsgs	= 0;
+	ArenaBytes	= 0;
+	ArenaMax	= 0;
 }
 
 Controller::~Controller()
@@ -66,6 +73,9 @@ uint Controller::Dispatch(ITransport* port, Buffer& bs, void* param, void* param
 	// 这里使用数据流，可能多个消息粘包在一起
 	// 注意，此时指针位于0，而内容长度为缓冲区长度
 	Stream ms((const void*)buf, len);
+	// 首块在栈上，一般消息够用，不够时再串堆块
+	byte abuf[0x100];
+	MemoryArena arena(abuf, sizeof(abuf));
 	while (ms.Remain() >= control->MinSize)
 	{
 #if MSG_DEBUG
@@ -73,8 +83,25 @@ uint Controller::Dispatch(ITransport* port, Buffer& bs, void* param, void* param
 		buf = ms.Current();
 		len = ms.Remain();
 #endif
+		bool rs = false;
+		if (control->UseArena)
+		{
+			// 每条消息一个作用域，处理完整体释放
+			ArenaScope scope(arena);
+			rs = control->Dispatch(ms, nullptr, param2);
+
+			uint used = arena.Used();
+			control->ArenaMsgs++;
+			control->ArenaBytes += used;
+			if (used > control->ArenaMax) control->ArenaMax = used;
+
+			arena.Reset();
+		}
+		else
+			rs = control->Dispatch(ms, nullptr, param2);
+
 		// 如果不是有效数据包，则直接退出，避免产生死循环。当然，也可以逐字节移动测试，不过那样性能太差
-		if (!control->Dispatch(ms, nullptr, param2))
+		if (!rs)
 		{
 #if MSG_DEBUG
 			msg_printf("Controller::Error[%d] ", len);
@@ -140,8 +167,12 @@ bool Controller::SendInternal(const Message& msg)
 	// 如果没有传输口处于打开状态，则发送失败
 	if (!Port->Open()) return false;
 
+	// 头部写入预留空间，负载只引用，由传输口逐段写出
+	BufferChain bc;
+	if (msg.Write(bc)) return SendInternal(bc, msg.State);
+
 	MemoryStream ms;
-	// 带有负载数据，需要合并成为一段连续的内存
+	// 不支持分段的消息，需要合并成为一段连续的内存
 	msg.Write(ms);
 
 	Buffer bs(ms.GetBuffer(), ms.Position());
@@ -157,3 +188,13 @@ bool Controller::SendInternal(const Buffer& bs, const void* state)
 	else
 		return Port->Write(bs, state);
 }
+
+bool Controller::SendInternal(const BufferChain& bc, const void* state)
+{
+	assert(Port, "Port为空,不能发送数据");
+
+	if (state == nullptr)
+		return Port->Write(bc);
+	else
+		return Port->Write(bc, state);
+}
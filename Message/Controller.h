@@ -2,6 +2,7 @@
 #define __Controller_H__
 
 #include "Kernel\Sys.h"
+#include "Core\Event.h"
 #include "Net\ITransport.h"
 
 #include "Message.h"
@@ -28,6 +29,12 @@ public:
 	byte		MinSize;	// 最小消息大小
 	bool 		Opened;
 
+	// 处理消息时的临时内存区。处理期间作用域内的临时对象从这里分配，处理完整体释放
+	bool		UseArena;	// 是否使用内存区，默认使用
+	uint		ArenaMsgs;	// 使用内存区处理的消息数
+	uint		ArenaBytes;	// 累计分配字节数，除以消息数得到每条消息平均值
+	uint		ArenaMax;	// 单条消息最多分配字节数
+
 	Controller();
 	virtual ~Controller();
 
@@ -39,12 +46,13 @@ public:
 	// 回复对方的请求消息
 	virtual bool Reply(Message& msg);
 
-	// 收到消息时触发
-	Delegate2<Message&, Controller&>	Received;
+	// 收到消息时触发。=设置默认处理者，Add追加更多订阅者
+	Event<Message&, Controller&>	Received;
 	
 protected:
 	bool SendInternal(const Message& msg);
 	virtual bool SendInternal(const Buffer& bs, const void* state);
+	virtual bool SendInternal(const BufferChain& bc, const void* state);
 };
 
 #endif
@@ -33,6 +33,17 @@ public:
 DataStore::DataStore()
 {
 	Strict = true;
+	Version = 0;
+
+	_MaxArea = 0;
+	_Versions = nullptr;
+	_Blocks = 0;
+	_Snaps = nullptr;
+}
+
+DataStore::~DataStore()
+{
+	delete[] _Versions;
 }
 
 // 写入数据
@@ -50,10 +61,14 @@ int DataStore::Write(uint offset, const Buffer& bs)
 	// 数据越界
 	if (Strict && realOffset + size > len) size = len - realOffset;
 
+	Preserve(realOffset, size);
+
 	// 从数据区读取数据
 	uint rs = Data.Copy(realOffset, bs, 0, size);
 	if (rs == 0) return rs;
 
+	Touch(realOffset, rs);
+
 	// 执行钩子函数
 	if (!OnHook(realOffset, rs, true)) return -1;
 
@@ -86,21 +101,47 @@ int DataStore::Read(uint offset, Buffer& bs)
 
 bool DataStore::OnHook(uint offset, uint size, bool write)
 {
-	for (int i = 0; i < Areas.Count(); i++)
+	int count = Areas.Count();
+	if (count == 0) return true;
+
+	// 区域按偏移排序，二分查找第一个可能搭边的区域，即 Offset + _MaxArea > offset
+	int low = 0, high = count;
+	while (low < high)
+	{
+		int mid = (low + high) >> 1;
+		auto ar = (Area*)Areas[mid];
+		if (ar->Offset + _MaxArea <= offset)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	for (int i = low; i < count; i++)
 	{
-		auto ar = *(Area*)Areas[i];
+		auto& ar = *(Area*)Areas[i];
+		// 后面的区域都在操作范围之外
+		if (ar.Offset >= offset + size) break;
 		if (ar.Size == 0) continue;
 
 		// 数据操作口只认可完整的当前区域
 		if (ar.Port && ar.In(offset, size))
 		{
+			auto p = &Data[ar.Offset];
 			if (write)
 			{
-				if (ar.Port->Write(&Data[ar.Offset]) <= 0) return false;
+				if (ar.Port->Write(p) <= 0) return false;
 			}
 			else
 			{
-				if (ar.Port->Read(&Data[ar.Offset]) <= 0) return false;
+				// 读取数据口会刷新数据区，值有变化时同样算作修改
+				byte old[4];
+				bool small = ar.Size <= sizeof(old);
+				Preserve(ar.Offset, ar.Size);
+				if (small) Buffer::Copy(old, p, ar.Size);
+
+				if (ar.Port->Read(p) <= 0) return false;
+
+				if (!small || Buffer(old, ar.Size) != Buffer(p, ar.Size)) Touch(ar.Offset, ar.Size);
 			}
 		}
 		// 钩子函数不需要完整区域，只需要部分匹配即可
@@ -113,6 +154,23 @@ bool DataStore::OnHook(uint offset, uint size, bool write)
 	return true;
 }
 
+// 按偏移插入有序位置，偏移相同的保持注册顺序
+void DataStore::AddArea(void* item)
+{
+	auto ar = (Area*)item;
+	if (ar->Size > _MaxArea) _MaxArea = ar->Size;
+
+	Areas.Add(ar);
+	for (int i = Areas.Count() - 1; i > 0; i--)
+	{
+		auto prev = (Area*)Areas[i - 1];
+		if (prev->Offset <= ar->Offset) break;
+
+		Areas[i] = prev;
+		Areas[i - 1] = ar;
+	}
+}
+
 // 注册某一块区域的读写钩子函数
 void DataStore::Register(uint offset, uint size, Handler hook)
 {
@@ -121,7 +179,7 @@ void DataStore::Register(uint offset, uint size, Handler hook)
 	ar->Size = size;
 	ar->Hook = hook;
 
-	Areas.Add(ar);
+	AddArea(ar);
 }
 
 void DataStore::Register(uint offset, IDataPort& port)
@@ -131,7 +189,70 @@ void DataStore::Register(uint offset, IDataPort& port)
 	ar->Size = port.Size();
 	ar->Port = &port;
 
-	Areas.Add(ar);
+	AddArea(ar);
+}
+
+// 即将修改数据区，先为活动快照保存旧数据
+void DataStore::Preserve(uint offset, uint size)
+{
+	if (!_Snaps || size == 0) return;
+
+	int first = offset / BlockSize;
+	int last = (offset + size - 1) / BlockSize;
+	for (auto sn = _Snaps; sn; sn = sn->_Next)
+	{
+		for (int i = first; i <= last; i++) sn->Save(i);
+	}
+}
+
+// 数据区已修改，递增版本并记录到所在数据块
+void DataStore::Touch(uint offset, uint size)
+{
+	if (size == 0) return;
+
+	Version++;
+
+	int last = (offset + size - 1) / BlockSize;
+	if (last >= _Blocks)
+	{
+		// 数据区扩大时重新分配，新增块的版本为0
+		int count = (Data.Length() + BlockSize - 1) / BlockSize;
+		if (count <= last) count = last + 1;
+
+		auto vs = new uint[count];
+		Buffer(vs, count * sizeof(uint)).Clear();
+		if (_Versions) Buffer::Copy(vs, _Versions, _Blocks * sizeof(uint));
+		delete[] _Versions;
+
+		_Versions = vs;
+		_Blocks = count;
+	}
+
+	for (int i = offset / BlockSize; i <= last; i++) _Versions[i] = Version;
+}
+
+// 从实际偏移start开始，查找指定版本以后被修改过的下一段区域，相邻的脏块合并为一段
+int DataStore::Changed(uint version, uint start, uint& size) const
+{
+	size = 0;
+	int len = Data.Length();
+
+	int i = start / BlockSize;
+	while (i < _Blocks && _Versions[i] <= version) i++;
+	if (i >= _Blocks) return -1;
+
+	int first = i;
+	while (i < _Blocks && _Versions[i] > version) i++;
+
+	int offset = first * BlockSize;
+	if (offset < (int)start) offset = start;
+	int end = i * BlockSize;
+	if (end > len) end = len;
+	if (end <= offset) return -1;
+
+	size = end - offset;
+
+	return offset;
 }
 
 Area::Area()
@@ -161,6 +282,72 @@ bool Area::Any(uint start, uint len)
 	return !(Offset >= start + len || Offset + Size <= start);
 }
 
+/****************************** 数据快照 ************************************/
+
+DataSnapshot::DataSnapshot(DataStore& store) : _Store(store)
+{
+	Version = store.Version;
+	_Length = store.Data.Length();
+
+	// 挂到活动快照链表，之后的写入会先保存旧数据
+	_Next = store._Snaps;
+	store._Snaps = this;
+}
+
+DataSnapshot::~DataSnapshot()
+{
+	auto pp = &_Store._Snaps;
+	while (*pp && *pp != this) pp = &(*pp)->_Next;
+	if (*pp) *pp = _Next;
+}
+
+bool DataSnapshot::IsSaved(int block) const
+{
+	int idx = block >> 3;
+	if (idx >= _Saved.Length()) return false;
+
+	return _Saved[idx] & (1 << (block & 0x07));
+}
+
+// 写入者修改数据块之前调用，首次修改时保存旧数据
+void DataSnapshot::Save(int block)
+{
+	int offset = block * DataStore::BlockSize;
+	if (offset >= _Length || IsSaved(block)) return;
+
+	if (_Copy.Length() < _Length)
+	{
+		_Copy.SetLength(_Length);
+		_Saved.SetLength((_Length / DataStore::BlockSize + 8) >> 3);
+		_Saved.Clear();
+	}
+
+	int len = DataStore::BlockSize;
+	if (offset + len > _Length) len = _Length - offset;
+	_Copy.Copy(offset, _Store.Data, offset, len);
+
+	_Saved[block >> 3] |= 1 << (block & 0x07);
+}
+
+byte DataSnapshot::operator[](int i) const
+{
+	if (IsSaved(i / DataStore::BlockSize)) return _Copy[i];
+
+	return _Store.Data[i];
+}
+
+// 读取快照数据，已被覆盖的数据块取自快照，其余直接取自数据区
+int DataSnapshot::Read(uint offset, Buffer& bs) const
+{
+	int size = bs.Length();
+	if ((int)offset >= _Length) return -1;
+	if (offset + size > (uint)_Length) size = _Length - offset;
+
+	for (int i = 0; i < size; i++) bs[i] = (*this)[offset + i];
+
+	return size;
+}
+
 /****************************** 数据操作接口 ************************************/
 
 ByteDataPort::ByteDataPort()
@@ -2,6 +2,7 @@
 #define __DataStore_H__
 
 class IDataPort;
+class DataSnapshot;
 
 // 数据存储适配器
 class DataStore
@@ -10,9 +11,16 @@ public:
 	ByteArray	Data;	// 数据
 	bool		Strict;	// 是否严格限制存储区，读写不许越界。默认true
 	uint		VirAddrBase = 0;	// 虚拟地址起始位置， 可以吧Store定义到任意位置
+	uint		Version;	// 数据版本。每次修改数据区递增，0表示从未修改
+
+	static const int BlockSize = 8;	// 脏区跟踪粒度，字节
 
 	// 初始化
 	DataStore();
+	DataStore(const DataStore& store) = delete;
+	~DataStore();
+
+	DataStore& operator=(const DataStore& store) = delete;
 
 	// 写入数据 offset 为虚拟地址
 	int Write(uint offset, const Buffer& bs);
@@ -20,15 +28,58 @@ public:
 	// 读取数据 offset 为虚拟地址
 	int Read(uint offset, Buffer& bs);
 
+	// 从实际偏移start开始，查找指定版本以后被修改过的下一段区域，返回实际偏移，没有时返回-1
+	int Changed(uint version, uint start, uint& size) const;
+
 	typedef bool (*Handler)(uint offset, uint size, bool write);
 	// 注册某一块区域的读写钩子函数
 	void Register(uint offset, uint size, Handler hook);
 	void Register(uint offset, IDataPort& port);
 
 private:
-	IList	Areas;
+	friend class DataSnapshot;
+
+	IList	Areas;		// 钩子区域，按偏移排序
+	uint	_MaxArea;	// 最大钩子区域大小，用于缩小查找范围
+	uint*	_Versions;	// 每个数据块最后一次修改时的版本
+	int		_Blocks;	// 已分配的数据块数
+	DataSnapshot*	_Snaps;	// 活动快照链表
 
 	bool OnHook(uint offset, uint size, bool write);
+	void AddArea(void* ar);
+	// 即将修改数据区，先为活动快照保存旧数据
+	void Preserve(uint offset, uint size);
+	// 数据区已修改，更新版本
+	void Touch(uint offset, uint size);
+};
+
+// 数据快照。写时复制，构造时记下版本，之后写入者修改某个数据块之前先把旧数据保存到快照
+// 读取者通过快照得到构造时刻的一致视图，不会阻塞写入者
+class DataSnapshot
+{
+public:
+	uint	Version;	// 快照时刻的数据版本
+
+	DataSnapshot(DataStore& store);
+	DataSnapshot(const DataSnapshot& snap) = delete;
+	~DataSnapshot();
+
+	// 读取快照数据，offset 为实际偏移
+	int Read(uint offset, Buffer& bs) const;
+	byte operator[](int i) const;
+	int Length() const { return _Length; }
+
+private:
+	friend class DataStore;
+
+	DataStore&		_Store;
+	DataSnapshot*	_Next;
+	int				_Length;	// 快照时刻的数据长度
+	ByteArray		_Copy;		// 被写入者覆盖之前的旧数据
+	ByteArray		_Saved;		// 已保存的数据块位图
+
+	void Save(int block);
+	bool IsSaved(int block) const;
 };
 
 /****************************** 数据操作接口 ************************************/
@@ -16,8 +16,8 @@ JsonType Json::Type() const
 {
 	if (!_str) return JsonType::null;
 
-	// 快速判断对象、数组和字符串
-	auto s = _str.Trim();
+	// 快速判断对象、数组和字符串。视图修剪不构造新字符串
+	auto s = StringView(_str).Trim();
 	//auto p = s.GetBuffer();
 	int len = s.Length();
 	switch (s[0])
@@ -59,6 +59,15 @@ bool Json::IsNull() const { return !_str; }
 String Json::AsString() const {
 	if (!_str) return nullptr;
 
+	auto v = AsView();
+
+	// 没有处理转义字符
+	return String(v.GetBuffer(), v.Length());
+}
+
+StringView Json::AsView() const {
+	if (!_str) return StringView();
+
 	//if (_str[0] != '"') return nullptr;
 
 	// 去掉前后双引号
@@ -69,10 +78,9 @@ String Json::AsString() const {
 		p++;
 		n--;
 	}
-	if (p[n - 1] == '"') n--;
+	if (n > 0 && p[n - 1] == '"') n--;
 
-	// 没有处理转义字符
-	return String(p, n);
+	return StringView(p, n);
 }
 
 bool Json::AsBoolean() const {
@@ -80,7 +88,7 @@ bool Json::AsBoolean() const {
 
 	//if (_str[0] != 't' && _str[0] != 'f') return false;
 
-	return _str.Trim() == "true";
+	return StringView(_str).Trim() == "true";
 }
 
 int Json::AsInt() const {
@@ -88,7 +96,7 @@ int Json::AsInt() const {
 
 	if (Type() != JsonType::integer) return 0;
 
-	return _str.Trim().ToInt();
+	return StringView(_str).Trim().ToInt();
 }
 
 float Json::AsFloat() const {
@@ -96,7 +104,7 @@ float Json::AsFloat() const {
 
 	if (Type() != JsonType::Float) return 0;
 
-	return _str.Trim().ToFloat();
+	return StringView(_str).Trim().ToFloat();
 }
 
 double Json::AsDouble() const
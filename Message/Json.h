@@ -5,6 +5,7 @@
 #include "Core\SString.h"
 #include "Core\List.h"
 #include "Core\Dictionary.h"
+#include "Core\StringView.h"
 
 /*
 一个Json对象内部包含有一个字符串，读取成员就是截取子字符串构建新的Json对象。
@@ -36,6 +37,8 @@ public:
 
 	// 获取值
 	String	AsString()	const;
+	// 字符串值的视图，去掉前后双引号，不拷贝
+	StringView	AsView()	const;
 	bool	AsBoolean()	const;
 	int		AsInt()		const;
 	float	AsFloat()	const;
@@ -2,6 +2,7 @@
 #define __Message_H__
 
 #include "Kernel\Sys.h"
+#include "Core\BufferChain.h"
 
 // 消息基类
 class Message
@@ -28,6 +29,8 @@ public:
 	virtual bool Read(Stream& ms) = 0;
 	// 把消息写入数据流中
 	virtual void Write(Stream& ms) const = 0;
+	// 把消息写入分段缓冲区，头部拷贝，负载只引用。不支持时返回false，由调用方改用数据流
+	virtual bool Write(BufferChain& bc) const { return false; }
 
 	// 验证消息校验码是否有效
 	virtual bool Valid() const = 0;
@@ -1,4 +1,5 @@
 ﻿#include "ProxyFactory.h"
+#include "Core\Intern.h"
 #include "Message\BinaryPair.h"
 
 ProxyFactory * ProxyFactory::Current = nullptr;
@@ -11,7 +12,7 @@ error code
 0x04	关闭出错
 */
 
-ProxyFactory::ProxyFactory():Proxys(String::Compare)
+ProxyFactory::ProxyFactory()
 {
 	debug_printf("创建 ProxyFac\r\n");
 	Client	= nullptr;
@@ -24,13 +25,13 @@ bool ProxyFactory::Open(TokenClient* client)
 
 	// debug_printf("  Register");
 	Client = client;
-	Client->Register("Proxy/GetConfig", &ProxyFactory::GetConfig,	this);
-	Client->Register("Proxy/SetConfig", &ProxyFactory::SetConfig,	this);
-	Client->Register("Proxy/Open",		&ProxyFactory::PortOpen,	this);
-	Client->Register("Proxy/Close",		&ProxyFactory::PortClose,	this);
-	Client->Register("Proxy/Write",		&ProxyFactory::Write,		this);
-	Client->Register("Proxy/Read",		&ProxyFactory::Read,		this);
-	Client->Register("Proxy/QueryPorts",&ProxyFactory::QueryPorts,	this);
+	Client->Register("Proxy/GetConfig", MethodOf(&ProxyFactory::GetConfig),	this);
+	Client->Register("Proxy/SetConfig", MethodOf(&ProxyFactory::SetConfig),	this);
+	Client->Register("Proxy/Open",		MethodOf(&ProxyFactory::PortOpen),	this);
+	Client->Register("Proxy/Close",		MethodOf(&ProxyFactory::PortClose),	this);
+	Client->Register("Proxy/Write",		MethodOf(&ProxyFactory::Write),		this);
+	Client->Register("Proxy/Read",		MethodOf(&ProxyFactory::Read),		this);
+	Client->Register("Proxy/QueryPorts",MethodOf(&ProxyFactory::QueryPorts),	this);
 	debug_printf("\r\n");
 
 	return true;
@@ -41,7 +42,8 @@ bool ProxyFactory::Register(Proxy* dev)
 	// debug_printf("ProxyFac RegPort");
 	String name = dev->Name;
 	name.Show(true);
-	Proxys.Add(dev->Name, dev);
+	// 端口名驻留后作为键，查找时按指针匹配
+	Proxys.Add(Intern::Static(dev->Name), dev);
 	return true;
 }
 
@@ -359,8 +361,9 @@ Proxy* ProxyFactory::GetPort(const Pair& args)
 	debug_printf("GetPort Name = ");
 	Name.Show(true);
 
-	Proxy* port;
-	Proxys.TryGetValue(Name.GetBuffer(), port);
+	Proxy* port = nullptr;
+	auto key = Intern::Find(Name.GetBuffer(), Name.Length());
+	if (key) Proxys.TryGetValue(key, port);
 
 	return port;
 }
@@ -10,7 +10,7 @@ class ProxyFactory
 {
 public:
 
-	Dictionary<cstring, Proxy*> Proxys;
+	Dictionary<cstring, Proxy*> Proxys;	// 端口集合，键为驻留名称
 	TokenClient* Client;
 
 	ProxyFactory();
@@ -0,0 +1,112 @@
+﻿#include "ReportBatch.h"
+
+ReportBatch::ReportBatch()
+{
+	Delay	= 200;
+	MaxSize	= 32;
+	Gap		= 4;
+	Marks	= 0;
+	Flushes	= 0;
+
+	Clear();
+}
+
+void ReportBatch::Clear()
+{
+	Buffer(_Bits, sizeof(_Bits)).Clear();
+	_Count		= 0;
+	_Deadline	= 0;
+}
+
+// 标记脏区，返回距离上报还需等待的毫秒数
+int ReportBatch::Set(int offset, int len)
+{
+	if(offset < 0 || len <= 0 || offset + len > Capacity) return -1;
+
+	for(int i = offset; i < offset + len; i++)
+	{
+		uint& w	= _Bits[i >> 5];
+		uint b	= 1u << (i & 0x1F);
+		if(w & b) continue;
+
+		w |= b;
+		_Count++;
+	}
+	Marks++;
+
+	// 期限从第一个脏区开始计算，后续标记不再推迟，保证最大延迟
+	if(!_Deadline) _Deadline = Sys.Ms() + Delay;
+
+	// 攒够一条消息就不再等待
+	if(_Count >= MaxSize) return 0;
+
+	return Remain();
+}
+
+bool ReportBatch::Any() const { return _Count > 0; }
+
+int ReportBatch::Remain() const
+{
+	if(!_Deadline) return 0;
+
+	auto now = Sys.Ms();
+	if(_Deadline <= now) return 0;
+
+	return (int)(_Deadline - now);
+}
+
+// 从指定位置开始查找下一个脏字节，没有时返回-1
+int ReportBatch::Find(int start) const
+{
+	for(int i = start; i < Capacity; )
+	{
+		uint w	= _Bits[i >> 5] >> (i & 0x1F);
+		if(!w)
+		{
+			// 整个字为空时直接跳到下一个字
+			i = (i & ~0x1F) + 32;
+			continue;
+		}
+		while(!(w & 1)) { w >>= 1; i++; }
+
+		return i;
+	}
+
+	return -1;
+}
+
+// 取出下一段合并后的区间
+bool ReportBatch::Next(int& offset, int& len)
+{
+	int start	= Find(0);
+	if(start < 0)
+	{
+		_Deadline	= 0;
+		return false;
+	}
+
+	// 向后吸收间隔不超过Gap的脏字节，合并后长度不超过MaxSize
+	// 间隔里的干净字节随同上报，数据取自数据区当前值，对端多写一次相同的值
+	int end	= start;
+	while(true)
+	{
+		int p	= Find(end + 1);
+		if(p < 0 || p - end - 1 > Gap || p - start + 1 > MaxSize) break;
+		end	= p;
+	}
+
+	for(int i = start; i <= end; i++)
+	{
+		if(!Get(i)) continue;
+
+		_Bits[i >> 5] &= ~(1u << (i & 0x1F));
+		_Count--;
+	}
+	if(!_Count) _Deadline = 0;
+
+	offset	= start;
+	len		= end - start + 1;
+	Flushes++;
+
+	return true;
+}
@@ -0,0 +1,39 @@
+﻿#ifndef __ReportBatch_H__
+#define __ReportBatch_H__
+
+#include "Kernel\Sys.h"
+
+// 上报批次。用位图收集数据区的脏字节，合并相邻或重叠的区间，到达延迟预算或攒够一条消息时一起上报
+class ReportBatch
+{
+public:
+	static const int Capacity = 256;	// 位图覆盖的数据区字节数
+
+	ushort	Delay;		// 延迟预算ms。第一个脏区到来后最多等待这么久，默认200
+	ushort	MaxSize;	// 单条消息最大数据长度，受MTU限制，默认32
+	byte	Gap;		// 两段脏区间隔不超过该字节数时合并为一段，默认4
+	uint	Marks;		// 累计标记次数
+	uint	Flushes;	// 累计上报消息数
+
+	ReportBatch();
+
+	// 标记脏区，返回距离上报还需等待的毫秒数，0表示应马上上报，-1表示越界
+	int Set(int offset, int len);
+	// 是否有待上报的脏区
+	bool Any() const;
+	// 距离上报还需等待的毫秒数，0表示已到期
+	int Remain() const;
+	// 取出下一段合并后的区间并清除对应脏位，没有时返回false
+	bool Next(int& offset, int& len);
+	void Clear();
+
+private:
+	uint	_Bits[Capacity >> 5];	// 脏字节位图
+	ushort	_Count;		// 脏字节数
+	UInt64	_Deadline;	// 上报期限，0表示没有脏区
+
+	bool Get(int i) const { return _Bits[i >> 5] & (1u << (i & 0x1F)); }
+	int Find(int start) const;
+};
+
+#endif
@@ -0,0 +1,399 @@
+﻿#include "Schema.h"
+#include "BinaryPair.h"
+
+// 各类型的最小长度，变长类型按1字节算
+static byte MinOf(const FieldInfo& fi)
+{
+	switch(fi.Type)
+	{
+		case Schema::Byte:		return 1;
+		case Schema::UInt16:	return 2;
+		case Schema::UInt32:	return 4;
+		case Schema::UInt64:	return 8;
+		case Schema::Bytes:		return fi.Size;
+		default:				return 1;
+	}
+}
+
+static inline bool IsFixed(byte type) { return type <= Schema::UInt64 || type == Schema::Bytes; }
+
+// 整数字段取值，按字段大小
+static uint GetInt(const byte* p, int size)
+{
+	if(size == 1) return *p;
+	if(size == 2) return *(const ushort*)p;
+	return *(const uint*)p;
+}
+
+static void SetInt(byte* p, int size, uint value)
+{
+	if(size == 1)
+		*p	= value;
+	else if(size == 2)
+		*(ushort*)p	= value;
+	else
+		*(uint*)p	= value;
+}
+
+// 是否为零或为空，可选字段不写
+static bool IsEmpty(const FieldInfo& fi, const byte* p)
+{
+	switch(fi.Type)
+	{
+		case Schema::Array:	return ((const Buffer*)p)->Length() == 0;
+		case Schema::UInt64:	return *(const UInt64*)p == 0;
+		case Schema::Bytes:
+			for(int i = 0; i < fi.Size; i++) if(p[i]) return false;
+			return true;
+		default:	return GetInt(p, fi.Size) == 0;
+	}
+}
+
+// 按字节序拷贝定长字段
+static void CopyFixed(byte* dst, const byte* src, int size, bool swap)
+{
+	if(!swap || size == 1)
+		Buffer::Copy(dst, src, size);
+	else
+		for(int i = 0; i < size; i++) dst[i]	= src[size - 1 - i];
+}
+
+static int EncodeSize(uint value)
+{
+	int n	= 1;
+	while(value >= 0x80 && n < 5) { value >>= 7; n++; }
+	return n;
+}
+
+/******************************** Schema ********************************/
+
+Schema::Schema(const FieldInfo* fields, int count)
+{
+	_Fields	= fields;
+	_Count	= count;
+	_Optional	= false;
+
+	// 必选字段最小长度，连续bool只占一个字节
+	int min	= 0;
+	int bits	= 0;
+	for(int i = 0; i < count; i++)
+	{
+		auto& fi	= fields[i];
+		if(fi.Flags & Optional)
+		{
+			_Optional	= true;
+			continue;
+		}
+
+		if(fi.Type == Bool)
+		{
+			if(bits++ % 8 == 0) min++;
+			continue;
+		}
+		bits	= 0;
+		min	+= MinOf(fi);
+	}
+	_MinSize	= min;
+}
+
+// 读取一个字段的值，定长字段已经确保长度足够
+static bool ReadField(Stream& ms, const FieldInfo& fi, byte* p)
+{
+	switch(fi.Type)
+	{
+		case Schema::EncodeInt:
+			SetInt(p, fi.Size, ms.ReadEncodeInt());
+			return true;
+		case Schema::Array:
+		{
+			// 放不下时跳过内容，保持后面的字段对齐
+			auto& bs	= *(Buffer*)p;
+			int len	= ms.ReadEncodeInt();
+			if(len > ms.Remain()) return false;
+			if(!bs.SetLength(len))
+			{
+				ms.Seek(len);
+				return false;
+			}
+			if(len) ms.Read(bs);
+			return true;
+		}
+		case Schema::Bool:
+			*(bool*)p	= ms.ReadByte() > 0;
+			return true;
+		default:
+		{
+			int size	= fi.Type == Schema::Bytes ? fi.Size : MinOf(fi);
+			if(ms.Remain() < size) return false;
+
+			CopyFixed(p, ms.Current(), size, !ms.Little && fi.Type != Schema::Bytes);
+			ms.Seek(size);
+			return true;
+		}
+	}
+}
+
+bool Schema::Read(Stream& ms, void* obj) const
+{
+	TS("Schema::Read");
+
+	// 一次检查必选字段的最小长度
+	int need	= _MinSize;
+	if(ms.Remain() < need) return false;
+
+	bool swap	= !ms.Little;
+	byte bits	= 0;
+	int nbit	= 8;
+	int i	= 0;
+	for(; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		if(fi.Flags & Optional) continue;
+
+		if(fi.Type == Bool)
+		{
+			if(nbit == 8)
+			{
+				bits	= ms.ReadByte();
+				nbit	= 0;
+				need--;
+			}
+			*(bool*)p	= (bits >> nbit++) & 1;
+			continue;
+		}
+		nbit	= 8;
+
+		int min	= MinOf(fi);
+		need	-= min;
+		if(IsFixed(fi.Type))
+		{
+			// 前面已经检查过，直接取值
+			auto cur	= ms.Current();
+			CopyFixed(p, cur, min, swap && fi.Type != Bytes);
+			ms.Seek(min);
+		}
+		else
+		{
+			if(!ReadField(ms, fi, p)) return false;
+			// 变长字段可能超出最小长度，重新检查后面的必选字段
+			if(ms.Remain() < need) return false;
+		}
+	}
+
+	// 可选字段，序号+长度+数据，不认识的跳过。没有可选字段时不管尾部数据，兼容带填充的消息
+	while(_Optional && ms.Remain() > 0)
+	{
+		int idx	= ms.ReadByte();
+		int len	= ms.ReadEncodeInt();
+		// 尾部不是可选字段格式，停止解析，必选字段已经读完
+		if(len > ms.Remain()) break;
+
+		if(idx < _Count && (_Fields[idx].Flags & Optional))
+		{
+			Stream sub(ms.Current(), len);
+			sub.Little	= ms.Little;
+			ReadField(sub, _Fields[idx], _Fields[idx].Of(obj));
+		}
+		ms.Seek(len);
+	}
+
+	return true;
+}
+
+// 字段写入后的长度，不含可选字段头部
+static int SizeOf(const FieldInfo& fi, const byte* p)
+{
+	switch(fi.Type)
+	{
+		case Schema::EncodeInt:	return EncodeSize(GetInt(p, fi.Size));
+		case Schema::Array:
+		{
+			int len	= ((const Buffer*)p)->Length();
+			return EncodeSize(len) + len;
+		}
+		case Schema::Bool:	return 1;
+		default:	return MinOf(fi);
+	}
+}
+
+static void WriteField(Stream& ms, const FieldInfo& fi, const byte* p)
+{
+	switch(fi.Type)
+	{
+		case Schema::EncodeInt:	ms.WriteEncodeInt(GetInt(p, fi.Size)); break;
+		case Schema::Array:		ms.WriteArray(*(const Buffer*)p); break;
+		case Schema::Bool:		ms.Write((byte)(*(const bool*)p ? 1 : 0)); break;
+		default:
+		{
+			byte buf[8];
+			int size	= MinOf(fi);
+			if(fi.Type == Schema::Bytes)
+				ms.Write(Buffer((void*)p, size));
+			else
+			{
+				CopyFixed(buf, p, size, !ms.Little);
+				ms.Write(Buffer(buf, size));
+			}
+			break;
+		}
+	}
+}
+
+void Schema::Write(Stream& ms, const void* obj) const
+{
+	TS("Schema::Write");
+
+	bool swap	= !ms.Little;
+
+	// 定长字段先攒到缓冲区，再一次写入
+	byte buf[32];
+	int n	= 0;
+	int nbit	= 8;
+	int bitpos	= 0;
+	for(int i = 0; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		if(fi.Flags & Optional) continue;
+
+		if(fi.Type == Bool)
+		{
+			// 每8个bool占一个字节
+			if(nbit == 8)
+			{
+				if(n + 1 > (int)sizeof(buf)) { ms.Write(Buffer(buf, n)); n = 0; }
+				bitpos	= n;
+				buf[n++]	= 0;
+				nbit	= 0;
+			}
+			if(*(const bool*)p) buf[bitpos]	|= 1 << nbit;
+			nbit++;
+			continue;
+		}
+		nbit	= 8;
+
+		int size	= MinOf(fi);
+		// 超过缓冲区的定长字节数组直接写入
+		if(IsFixed(fi.Type) && size <= (int)sizeof(buf))
+		{
+			if(n + size > (int)sizeof(buf)) { ms.Write(Buffer(buf, n)); n = 0; }
+			CopyFixed(buf + n, p, size, swap && fi.Type != Bytes);
+			n	+= size;
+		}
+		else
+		{
+			if(n) { ms.Write(Buffer(buf, n)); n = 0; }
+			WriteField(ms, fi, p);
+		}
+	}
+	if(n) ms.Write(Buffer(buf, n));
+
+	// 可选字段，为零或为空不写
+	for(int i = 0; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		if(!(fi.Flags & Optional) || IsEmpty(fi, p)) continue;
+
+		ms.Write((byte)i);
+		ms.WriteEncodeInt(SizeOf(fi, p));
+		WriteField(ms, fi, p);
+	}
+}
+
+int Schema::Size(const void* obj) const
+{
+	int size	= 0;
+	int bits	= 0;
+	for(int i = 0; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		if(fi.Flags & Optional)
+		{
+			if(IsEmpty(fi, p)) continue;
+
+			int len	= SizeOf(fi, p);
+			size	+= 1 + EncodeSize(len) + len;
+			continue;
+		}
+
+		if(fi.Type == Bool)
+		{
+			if(bits++ % 8 == 0) size++;
+			continue;
+		}
+		bits	= 0;
+		size	+= SizeOf(fi, p);
+	}
+
+	return size;
+}
+
+/******************************** 名值对 ********************************/
+
+void Schema::ReadPair(Stream& ms, void* obj) const
+{
+	BinaryPair bp(ms);
+
+	for(int i = 0; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		switch(fi.Type)
+		{
+			case UInt16:	bp.Get(fi.Name, *(ushort*)p); break;
+			case UInt32:	bp.Get(fi.Name, *(uint*)p); break;
+			case UInt64:	bp.Get(fi.Name, *(::UInt64*)p); break;
+			case Array:		bp.Get(fi.Name, *(Buffer*)p); break;
+			case Bytes:
+			{
+				Buffer bs(p, fi.Size);
+				bp.Get(fi.Name, bs);
+				break;
+			}
+			case Bool:
+			{
+				byte v	= 0;
+				if(bp.Get(fi.Name, v)) *(bool*)p	= v > 0;
+				break;
+			}
+			default:
+			{
+				uint v	= 0;
+				if(fi.Size == 1 ? bp.Get(fi.Name, *(byte*)&v) : bp.Get(fi.Name, v)) SetInt(p, fi.Size, v);
+				break;
+			}
+		}
+	}
+}
+
+void Schema::WritePair(Stream& ms, const void* obj) const
+{
+	BinaryPair bp(ms);
+
+	for(int i = 0; i < _Count; i++)
+	{
+		auto& fi	= _Fields[i];
+		auto p	= fi.Of(obj);
+		if((fi.Flags & Optional) && IsEmpty(fi, p)) continue;
+
+		switch(fi.Type)
+		{
+			case Byte:		bp.Set(fi.Name, *p); break;
+			case UInt16:	bp.Set(fi.Name, *(const ushort*)p); break;
+			case UInt32:	bp.Set(fi.Name, *(const uint*)p); break;
+			case UInt64:	bp.Set(fi.Name, *(const ::UInt64*)p); break;
+			case Array:		bp.Set(fi.Name, *(const Buffer*)p); break;
+			case Bytes:		bp.Set(fi.Name, Buffer((void*)p, fi.Size)); break;
+			case Bool:		bp.Set(fi.Name, (byte)(*(const bool*)p ? 1 : 0)); break;
+			default:
+				if(fi.Size == 1)
+					bp.Set(fi.Name, *p);
+				else
+					bp.Set(fi.Name, GetInt(p, fi.Size));
+				break;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+﻿#ifndef __Schema_H__
+#define __Schema_H__
+
+#include "Kernel\Sys.h"
+
+// 字段描述。一个对象的全部字段组成一张静态表，编译时确定，放在Flash
+struct FieldInfo
+{
+	void*	(*Member)(void* obj);	// 取字段地址，由成员指针编译时生成
+	byte	Type;	// 类型，见Schema::Types
+	byte	Size;	// 字段大小
+	byte	Flags;	// 标记，见Schema::Optional
+	cstring	Name;	// 名值对模式下的名称
+
+	// 字段在对象中的地址
+	inline byte* Of(const void* obj) const { return (byte*)Member((void*)obj); }
+};
+
+// 序列化描述。按字段表生成Read/Write/Size，代替手写的逐字段读写
+// 二进制模式：必选字段按顺序紧凑排列，连续的bool按位打包，整数可选7位压缩编码
+//   可选字段排在最后，按 序号+长度+数据 写入，旧版本读到不认识的序号直接跳过，新增字段不破坏兼容
+//   读取时先对必选字段的最小长度做一次边界检查，定长字段直接取值，只有变长字段后面才再检查
+// 名值对模式：按名称读写BinaryPair，兼容令牌协议里原有的消息格式
+class Schema
+{
+public:
+	// 字段类型
+	typedef enum
+	{
+		Byte = 0,	// 1字节
+		UInt16,		// 2字节
+		UInt32,		// 4字节
+		UInt64,		// 8字节
+		EncodeInt,	// 7位压缩整数，字段可以是1/2/4字节
+		Bool,		// 连续的bool合并为一个字节
+		Bytes,		// 定长字节数组
+		Array,		// 变长数组，ByteArray或String，压缩整数长度开头
+	} Types;
+
+	// 可选字段。二进制模式下写入尾部，名值对模式下为零或为空时不写
+	static const byte Optional	= 0x01;
+
+	Schema(const FieldInfo* fields, int count);
+
+	inline int Count() const { return _Count; }
+	// 必选字段的最小长度
+	inline int MinSize() const { return _MinSize; }
+
+	// 从数据流读取对象，数据不足返回false
+	bool Read(Stream& ms, void* obj) const;
+	// 把对象写入数据流
+	void Write(Stream& ms, const void* obj) const;
+	// 写入对象需要的字节数
+	int Size(const void* obj) const;
+
+	// 名值对模式
+	void ReadPair(Stream& ms, void* obj) const;
+	void WritePair(Stream& ms, const void* obj) const;
+
+private:
+	const FieldInfo*	_Fields;
+	int		_Count;
+	int		_MinSize;
+	bool	_Optional;	// 是否有可选字段，没有时不解析尾部
+};
+
+// 字段类型推导
+template<typename T> struct SchemaType;
+template<> struct SchemaType<byte> { static const byte Value = Schema::Byte; };
+template<> struct SchemaType<ushort> { static const byte Value = Schema::UInt16; };
+template<> struct SchemaType<short> { static const byte Value = Schema::UInt16; };
+template<> struct SchemaType<uint> { static const byte Value = Schema::UInt32; };
+template<> struct SchemaType<int> { static const byte Value = Schema::UInt32; };
+template<> struct SchemaType<UInt64> { static const byte Value = Schema::UInt64; };
+template<> struct SchemaType<bool> { static const byte Value = Schema::Bool; };
+template<> struct SchemaType<ByteArray> { static const byte Value = Schema::Array; };
+template<> struct SchemaType<String> { static const byte Value = Schema::Array; };
+template<int N> struct SchemaType<byte[N]> { static const byte Value = Schema::Bytes; };
+
+// 字段访问。消息类带虚函数，不能用offsetof，改用成员指针，基类的成员也可以
+template<typename C, typename P, P Member>
+struct SchemaMember
+{
+	static void* Get(void* obj) { return &(((C*)obj)->*Member); }
+};
+
+#define SCHEMA_MEMBER(cls, name) decltype(((cls*)0)->name)
+#define SCHEMA_GET(cls, name) &SchemaMember<cls, decltype(&cls::name), &cls::name>::Get
+
+// 定义字段，类型由成员推导
+#define FIELD(cls, name) { SCHEMA_GET(cls, name), SchemaType<SCHEMA_MEMBER(cls, name)>::Value, sizeof(SCHEMA_MEMBER(cls, name)), 0, #name }
+// 定义字段，指定名值对名称和标记
+#define FIELD_EX(cls, name, key, flags) { SCHEMA_GET(cls, name), SchemaType<SCHEMA_MEMBER(cls, name)>::Value, sizeof(SCHEMA_MEMBER(cls, name)), flags, key }
+// 压缩整数字段
+#define FIELD_VAR(cls, name) { SCHEMA_GET(cls, name), Schema::EncodeInt, sizeof(SCHEMA_MEMBER(cls, name)), 0, #name }
+
+#endif
@@ -30,7 +30,7 @@ bool UTPacket::Set(TokenClient * client)
 {
 	// 设置迟了会直接启用
 	if (client)Client = client;
-	if (Ports.Count() && Client)Client->Register("UTPacket", &UTPacket::PressTMsg, this);
+	if (Ports.Count() && Client)Client->Register("UTPacket", MethodOf(&UTPacket::PressTMsg), this);
 
 	return true;
 }
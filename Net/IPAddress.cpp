@@ -42,6 +42,11 @@ uint IPAddress::GetSubNet(const IPAddress& mask) const
 
 // 把字符串IP地址解析为IPAddress
 IPAddress IPAddress::Parse(const String& ipstr)
+{
+	return Parse(StringView(ipstr));
+}
+
+IPAddress IPAddress::Parse(const StringView& ipstr)
 {
 	auto ip	= IPAddress::Any();
 	if(!ipstr) return ip;
@@ -49,21 +54,20 @@ IPAddress IPAddress::Parse(const String& ipstr)
 	// 最大长度判断 255.255.255.255
 	if(ipstr.Length() > 3 + 1 + 3 + 1 + 3 + 1 + 3) return ip;
 
-	if(ipstr.Contains("."))
+	if(ipstr.IndexOf('.') >= 0)
 	{
 		// 特殊处理 0.0.0.0 和 255.255.255.255
 		if(ipstr == "0.0.0.0") return ip;
 		if(ipstr == "255.255.255.255") return IPAddress::Broadcast();
 
-		// 这里不能在Split参数直接使用字符指针，隐式构造的字符串对象在这个函数之后将会被销毁
-		auto sp	= ipstr.Split(".");
-		for(int i=0; i<4 && sp; i++)
+		auto sp	= ipstr;
+		StringView item;
+		for(int i=0; i<4 && sp.Split(".", item); i++)
 		{
-			auto item	= sp.Next();
 			if(item.Length() == 0 || item.Length() > 3) break;
 
 			// 标准地址第一个不能是0，唯一的Any例外已经在前面处理
-			int v	= item.ToInt();
+			int v	= item.ToInt(-1);
 			if(v < 0 || v > 255 || (i == 0 && v == 0)) break;
 
 			ip[i]	= (byte)v;
@@ -74,7 +78,9 @@ IPAddress IPAddress::Parse(const String& ipstr)
 	}
 #if NET_DEBUG
 	// 只显示失败
-	net_printf("IPAddress::Parse %s => %08X \r\n", ipstr.GetBuffer(), ip.Value);
+	net_printf("IPAddress::Parse ");
+	ipstr.Show();
+	net_printf(" => %08X \r\n", ip.Value);
 #endif
 
 	return IPAddress::Any();
@@ -3,6 +3,7 @@
 
 #include "Core\ByteArray.h"
 #include "Core\SString.h"
+#include "Core\StringView.h"
 
 // IP协议类型
 enum class ProtocolType
@@ -56,6 +57,7 @@ public:
 
 	// 把字符串IP地址解析为IPAddress
 	static IPAddress Parse(const String& ipstr);
+	static IPAddress Parse(const StringView& ipstr);
 };
 
 #endif
@@ -64,6 +64,22 @@ bool ITransport::Write(const Buffer& bs, const void* opt)
 	return OnWriteEx(bs, opt);
 }
 
+// 分段发送数据
+bool ITransport::Write(const BufferChain& bc)
+{
+	if(!Opened && !Open()) return false;
+
+	return OnWriteEx(bc, nullptr);
+}
+
+// 分段发送数据
+bool ITransport::Write(const BufferChain& bc, const void* opt)
+{
+	if(!Opened && !Open()) return false;
+
+	return OnWriteEx(bc, opt);
+}
+
 // 接收数据
 uint ITransport::Read(Buffer& bs)
 {
@@ -100,6 +116,22 @@ bool ITransport::OnWriteEx(const Buffer& bs, const void* opt)
 	return OnWrite(bs);
 }
 
+// 单段直接发送，多段合并成连续内存后发送
+bool ITransport::OnWriteEx(const BufferChain& bc, const void* opt)
+{
+	if(bc.Count() == 1)
+	{
+		if(!opt) return OnWrite(bc[0]);
+		return OnWriteEx(bc[0], opt);
+	}
+
+	ByteArray bs(bc.Length());
+	bc.CopyTo(bs);
+
+	if(!opt) return OnWrite(bs);
+	return OnWriteEx(bs, opt);
+}
+
 /******************************** PackPort ********************************/
 
 PackPort::PackPort(){ Port = nullptr; }
@@ -127,6 +159,13 @@ bool PackPort::OnOpen() { return Port->Open(); }
 void PackPort::OnClose() { Port->Close(); }
 
 bool PackPort::OnWrite(const Buffer& bs) { return Port->Write(bs); }
+bool PackPort::OnWriteEx(const BufferChain& bc, const void* opt)
+{
+	// 附加参数由子类的OnWriteEx(Buffer, opt)处理，合并后交给它
+	if(opt) return ITransport::OnWriteEx(bc, opt);
+
+	return Port->Write(bc);
+}
 uint PackPort::OnRead(Buffer& bs) { return Port->Read(bs); }
 
 uint PackPort::OnPortReceive(ITransport* sender, Buffer& bs, void* param, void* param2)
@@ -2,6 +2,7 @@
 #define __ITransport_H__
 
 #include "Kernel\Sys.h"
+#include "Core\BufferChain.h"
 
 class ITransport;
 
@@ -36,6 +37,9 @@ public:
 	// 发送数据
 	bool Write(const Buffer& bs);
 	bool Write(const Buffer& bs, const void* opt);
+	// 分段发送数据，头部和负载不必合并
+	bool Write(const BufferChain& bc);
+	bool Write(const BufferChain& bc, const void* opt);
 	// 接收数据
 	uint Read(Buffer& bs);
 
@@ -47,6 +51,8 @@ protected:
 	virtual void OnClose() { }
 	virtual bool OnWrite(const Buffer& bs) = 0;
 	virtual bool OnWriteEx(const Buffer& bs, const void* opt);
+	// 分段发送。默认合并成一段再发送，能逐段写入硬件的驱动重载它以免拷贝
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 	virtual uint OnRead(Buffer& bs) = 0;
 
 	// 是否有回调函数
@@ -76,6 +82,7 @@ protected:
     virtual void OnClose();
 
     virtual bool OnWrite(const Buffer& bs);
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt);
 	virtual uint OnRead(Buffer& bs);
 
 	static uint OnPortReceive(ITransport* sender, Buffer& bs, void* param, void* param2);
@@ -12,29 +12,28 @@ NetUri::NetUri()
 
 NetUri::NetUri(const String& uri) : NetUri()
 {
-	auto t = uri.Substring(0, 3);
+	StringView s(uri);
+	auto t = s.Sub(0, 3);
 	if(t.EqualsIgnoreCase("Tcp"))
 		Type = NetType::Tcp;
 	else if(t.EqualsIgnoreCase("Udp"))
 		Type = NetType::Udp;
-	else if(uri.Substring(0, 4).EqualsIgnoreCase("Http"))
+	else if(s.Sub(0, 4).EqualsIgnoreCase("Http"))
 		Type = NetType::Http;
 
-	int p	= uri.LastIndexOf("/");
-	int end	= uri.LastIndexOf(":");
+	int p	= s.LastIndexOf('/');
+	int end	= s.LastIndexOf(':');
 	auto hlent = end - p - 1;
 	if (hlent > 0 && p > 0)
 	{
-		Host = uri.Substring(p+1, hlent);
+		Host = s.Sub(p+1, hlent).ToString();
 	}
 
-	String port;
-	auto plent = uri.Length() - end-1;
+	auto plent = s.Length() - end-1;
 
 	if (plent > 0 && end > 0)
 	{
-		port = uri.Substring(end+1, plent);
-		Port = port.ToInt();
+		Port = s.Sub(end+1, plent).ToInt();
 	}
 }
 
@@ -9,6 +9,7 @@
 
 #include "Core\List.h"
 #include "Core\Delegate.h"
+#include "Core\Event.h"
 
 class Socket;
 
@@ -48,7 +49,7 @@ public:
 	IPAddress	DNSServer;
 	IPAddress	DNSServer2;
 
-	Delegate<NetworkInterface&>	Changed;	// 网络改变
+	Event<NetworkInterface&>	Changed;	// 网络改变，可多个订阅者
 
 	NetworkInterface();
 	// 加上虚析构函数，因为应用层可能要释放该接口
@@ -11,6 +11,17 @@
 	#define net_printf(format, ...)
 #endif
 
+// 单段直接发送，多段合并成连续内存后发送
+bool Socket::Send(const BufferChain& bc)
+{
+	if(bc.Count() == 1) return Send(bc[0]);
+
+	ByteArray bs(bc.Length());
+	bc.CopyTo(bs);
+
+	return Send(bs);
+}
+
 Socket* Socket::CreateClient(const NetUri& uri)
 {
 	auto& list	= NetworkInterface::All;
@@ -7,6 +7,7 @@
 #include "NetUri.h"
 
 #include "Core\Delegate.h"
+#include "Core\BufferChain.h"
 
 class NetworkInterface;
 
@@ -30,6 +31,8 @@ public:
 	// 发送数据
 	virtual bool Send(const Buffer& bs) = 0;
 	virtual bool SendTo(const Buffer& bs, const IPEndPoint& remote) { return Send(bs); }
+	// 分段发送数据。默认合并成一段，硬件协议栈可重载后逐段写入
+	virtual bool Send(const BufferChain& bc);
 	// 接收数据
 	virtual uint Receive(Buffer& bs) = 0;
 
@@ -93,6 +93,17 @@ INROOT void operator delete[](void* p) noexcept
 INROOT void operator delete(void* p, uint size) noexcept { operator delete(p); }
 INROOT void operator delete[](void* p, uint size) noexcept { operator delete[](p); }
 
+// 原地调整堆上内存块的大小，给Array/List/MemoryStream扩容用
+INROOT bool ResizeInPlace(void* p, int size)
+{
+#if MEM_DEBUG
+	// 调试时内存块前面有标记头，不做原地调整
+	return false;
+#else
+	return _Heap && _Heap->Resize(p, size);
+#endif
+}
+
 void assert_failed2(cstring msg, cstring file, unsigned int line)
 {
     debug_printf("%s Line %d, %s\r\n", msg, line, file);
@@ -123,7 +123,8 @@ int SerialPort::SendData(byte data, int times)
 	USART_SendData(st, (ushort)data);
 	// 等待发送完毕
 	while (USART_GetFlagStatus(st, USART_FLAG_TXE) == RESET && --times > 0);
-	if (!times) Error++;
+	// 发送在任务里，溢出在中断里，都会修改错误计数
+	if (!times) AtomicAdd(&Error, 1);
 
 	return times;
 }
@@ -182,7 +183,7 @@ INROOT void SerialPort::OnHandler(ushort num, void* param)
 		//USART_ClearFlag(st, USART_FLAG_ORE);	// ST 库文件 ClearFlag 不许动 USART_FLAG_ORE 寄存器
 		// 读取并扔到错误数据
 		USART_ReceiveData(st);
-		sp->Error++;
+		AtomicAdd(&sp->Error, 1);
 		//debug_printf("Serial%d 溢出 \r\n", sp->Index + 1);
 	}
 	/*if(USART_GetFlagStatus(st, USART_FLAG_NE) != RESET) USART_ClearFlag(st, USART_FLAG_NE);
@@ -325,6 +325,63 @@ void TSys::OnStart()
 INROOT void EnterCritical() { __disable_irq(); }
 INROOT void ExitCritical() { __enable_irq(); }
 
+/******************************** 原子操作 ********************************/
+
+#if defined(STM32F0) || defined(GD32F150)
+// M0没有独占访问指令，关中断完成读改写，只有几条指令
+INROOT int AtomicAdd(volatile int* ptr, int value)
+{
+	uint pri	= __get_PRIMASK();
+	__disable_irq();
+	int v	= *ptr + value;
+	*ptr	= v;
+	__set_PRIMASK(pri);
+
+	return v;
+}
+
+INROOT bool AtomicCompareExchange(volatile int* ptr, int old, int value)
+{
+	uint pri	= __get_PRIMASK();
+	__disable_irq();
+	bool rs	= *ptr == old;
+	if(rs) *ptr	= value;
+	__set_PRIMASK(pri);
+
+	return rs;
+}
+#else
+// 独占读后独占写，期间发生中断则写入失败并重试，全程不关中断
+INROOT int AtomicAdd(volatile int* ptr, int value)
+{
+	int v;
+	do
+	{
+		v	= (int)__LDREXW((volatile uint*)ptr) + value;
+	}
+	while(__STREXW((uint)v, (volatile uint*)ptr));
+
+	return v;
+}
+
+INROOT bool AtomicCompareExchange(volatile int* ptr, int old, int value)
+{
+	do
+	{
+		if((int)__LDREXW((volatile uint*)ptr) != old)
+		{
+			__CLREX();
+			return false;
+		}
+	}
+	while(__STREXW((uint)value, (volatile uint*)ptr));
+
+	return true;
+}
+#endif
+
+INROOT void MemoryBarrier() { __DMB(); }
+
 /******************************** REV ********************************/
 
 INROOT uint	_REV(uint value) { return __REV(value); }
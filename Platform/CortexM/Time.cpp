@@ -131,5 +131,36 @@ INROOT UInt64 TTime::Current() const
 	return Milliseconds + cnt;
 }
 
+// 暂停毫秒定时器。计数停止也就不会产生更新中断
+void TTime::Pause()
+{
+	TIM_Cmd(g_Timers[Index], DISABLE);
+}
+
+// 恢复毫秒定时器，把睡眠期间经过的毫秒数补偿到计数器和全局秒数
+void TTime::Resume(uint ms)
+{
+	auto tim	= g_Timers[Index];
+	uint cnt	= tim->CNT;
+#if ! (defined(STM32F0) || defined(GD32F150))
+	if(Div) cnt >>= Div;
+#endif
+	cnt	+= ms;
+
+	uint sec	= cnt / 1000;
+	if(sec)
+	{
+		Seconds	+= sec;
+		Milliseconds	+= sec * 1000;
+		cnt	%= 1000;
+	}
+#if ! (defined(STM32F0) || defined(GD32F150))
+	if(Div) cnt <<= Div;
+#endif
+	tim->CNT	= cnt;
+
+	TIM_Cmd(tim, ENABLE);
+}
+
 INROOT uint TTime::TicksToUs(uint ticks) const	{ return !ticks ? 0 : (ticks / gTicks); }
 INROOT uint TTime::UsToTicks(uint us) const	{ return !us ? 0 : (us * gTicks); }
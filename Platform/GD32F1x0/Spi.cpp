@@ -106,7 +106,7 @@ byte Spi::Write(byte data)
 	int retry = Retry;
     while (SPI_I2S_GetFlagStatus(si, SPI_I2S_FLAG_TXE) == RESET)
     {
-        if(--retry <= 0) return ++Error; // 超时处理
+        if(--retry <= 0) return AtomicAdd(&Error, 1); // 超时处理
     }
 
 #ifndef STM32F0
@@ -118,7 +118,7 @@ byte Spi::Write(byte data)
 	retry = Retry;
 	while (SPI_I2S_GetFlagStatus(si, SPI_I2S_FLAG_RXNE) == RESET) //是否发送成功
     {
-        if(--retry <= 0) return ++Error; // 超时处理
+        if(--retry <= 0) return AtomicAdd(&Error, 1); // 超时处理
     }
 #ifndef STM32F0
 	return SPI_I2S_ReceiveData(si);
@@ -136,7 +136,7 @@ ushort Spi::Write16(ushort data)
 	int retry = Retry << 1;
 	while (SPI_I2S_GetFlagStatus(si, SPI_I2S_FLAG_TXE) == RESET)
 	{
-        if(--retry <= 0) return ++Error; // 超时处理
+        if(--retry <= 0) return AtomicAdd(&Error, 1); // 超时处理
 	}
 
 #ifndef STM32F0
@@ -148,7 +148,7 @@ ushort Spi::Write16(ushort data)
     retry = Retry << 1;
 	while (SPI_I2S_GetFlagStatus(si, SPI_I2S_FLAG_RXNE) == RESET)
 	{
-        if(--retry <= 0) return ++Error; // 超时处理
+        if(--retry <= 0) return AtomicAdd(&Error, 1); // 超时处理
 	}
 
 #ifndef STM32F0
@@ -83,7 +83,7 @@ bool DMA::WaitForStop()
 	{
 		if(--retry <= 0)
 		{
-			Error++;
+			AtomicAdd(&Error, 1);
 			return false;
 		}
 	}
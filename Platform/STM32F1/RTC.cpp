@@ -202,10 +202,16 @@ int HardRTC::Sleep(int ms)
     RTC_WaitForLastTask2();
 
 	Sys.Trace(1);
+	// 无滴答睡眠，暂停毫秒定时器，只由RTC闹钟或外设中断唤醒
+	// RTC计数器按毫秒计数，唤醒后用它补偿系统时间
+	auto& time	= (TTime&)Time;
+	uint start	= RTC_GetCounter();
+	time.Pause();
 	// 进入低功耗模式
 	//PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
 	// 直接进入低功耗，不去控制电源，唤醒以后不需要配置系统时钟
 	__WFI();
+	time.Resume(RTC_GetCounter() - start);
 
 	//debug_printf("离开低功耗模式\r\n");
 
@@ -124,7 +124,7 @@ bool HardI2C::WaitAck(bool ack)
 	int retry = Retry;
 	while(!I2C_CheckEvent((I2C_TypeDef*)_IIC, _Event))
     {
-        if(--retry <= 0) return ++Error; // 超时处理
+        if(--retry <= 0) return AtomicAdd(&Error, 1); // 超时处理
     }
 	return retry > 0;
 }
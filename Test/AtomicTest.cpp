@@ -0,0 +1,88 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Kernel\Atomic.h"
+#include "Kernel\Interrupt.h"
+
+#if DEBUG
+
+struct TestStat
+{
+	uint	Count;
+	uint	Bytes;
+	uint	Last;
+};
+
+static void TestLock()
+{
+	int ref	= 0;
+	{
+		Lock lk(ref);
+		assert(lk.Success && ref == 1, "Lock");
+
+		// 已被锁定，再次加锁失败，等待超时
+		Lock lk2(ref);
+		assert(!lk2.Success, "Lock2");
+		assert(!lk2.Wait(2), "Wait");
+	}
+	assert(ref == 0, "~Lock");
+
+	Lock lk3(ref);
+	assert(lk3.Success, "Lock3");
+}
+
+void TestAtomic()
+{
+	TS("TestAtomic");
+
+	debug_printf("\r\n");
+	debug_printf("TestAtomic Start......\r\n");
+
+	AtomicInt n;
+	assert(++n == 1 && ++n == 2 && --n == 1, "++");
+	assert(n.Add(10) == 11 && n == 11, "Add");
+	assert(!n.CompareExchange(0, 5) && n == 11, "CompareExchange");
+	assert(n.CompareExchange(11, 5) && n == 5, "CompareExchange");
+	assert(n.Exchange(0) == 5 && n == 0, "Exchange");
+
+	TestLock();
+
+	// 顺序锁。写入后读取到一致的快照
+	SeqLock sl;
+	TestStat st	= { 0, 0, 0 };
+	sl.BeginWrite();
+	assert(sl.Sequence() & 1, "BeginWrite");
+	st.Count++;
+	st.Bytes	+= 64;
+	st.Last		= 64;
+	sl.EndWrite();
+
+	TestStat copy;
+	uint seq	= sl.BeginRead();
+	copy	= st;
+	assert(!sl.Retry(seq), "Retry");
+	assert(copy.Count == 1 && copy.Bytes == 64, "Snapshot");
+
+	// 读取期间有写入需要重试
+	seq	= sl.BeginRead();
+	sl.BeginWrite();
+	sl.EndWrite();
+	assert(sl.Retry(seq), "Retry2");
+
+	// 原子加与关中断加的开销对比
+	volatile int v	= 0;
+	TimeCost tc;
+	for(int i=0; i<1000; i++) AtomicAdd(&v, 1);
+	int c1	= tc.Elapsed();
+	tc.Reset();
+	for(int i=0; i<1000; i++)
+	{
+		SmartIRQ irq;
+		v++;
+	}
+	int c2	= tc.Elapsed();
+	assert(v == 2000, "AtomicAdd");
+	debug_printf("1000次 原子加 %dus 关中断加 %dus\r\n", c1, c2);
+
+	debug_printf("\r\n TestAtomic Finish!\r\n");
+}
+#endif
@@ -0,0 +1,54 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Kernel\BinLog.h"
+
+#if DEBUG
+
+// 单次调用耗时，换算成时钟周期
+static uint ToCycles(int us, int times)
+{
+	return (uint)((UInt64)us * (Sys.Clock / 1000000) / times);
+}
+
+void TestBinLog()
+{
+	TS("TestBinLog");
+
+	debug_printf("\r\n");
+	debug_printf("TestBinLog Start......\r\n");
+
+	const int times	= 16;
+	int ct	= 0;
+
+	// 文本日志，同步格式化并发送
+	TimeCost tc;
+	for(int i=0; i<times; i++)
+		log_printf("TinyController::Send 0x%02X => 0x%02X Code=0x%02X Seq=%d Len=%d %s\r\n", 1, 2, 0x15, i, 32, "ShunCom");
+	int t1	= tc.Elapsed();
+
+	// 二进制日志，只写环形缓冲区
+	BinLog::Start();
+	tc.Reset();
+	for(int i=0; i<times; i++)
+		log_printf("TinyController::Send 0x%02X => 0x%02X Code=0x%02X Seq=%d Len=%d %s\r\n", 1, 2, 0x15, i, 32, "ShunCom");
+	int t2	= tc.Elapsed();
+	assert(BinLog::Records == times && BinLog::Drops == 0, "Records");
+
+	// 发送积压记录
+	tc.Reset();
+	BinLog::Flush();
+	int t3	= tc.Elapsed();
+
+	// 写满缓冲区，多出的丢弃而不是覆盖
+	for(int i=0; i<BinLog::Size / 8; i++) log_printf("Flood %d %d\r\n", i, ct++);
+	assert(BinLog::Drops > 0, "Drops");
+	BinLog::Flush();
+
+	BinLog::Stop();
+	assert(!BinLog::Running(), "Stop");
+
+	debug_printf("每次日志 文本=%d周期 二进制=%d周期 发送=%d周期 丢弃=%d\r\n", ToCycles(t1, times), ToCycles(t2, times), ToCycles(t3, times), BinLog::Drops);
+
+	debug_printf("\r\n TestBinLog Finish!\r\n");
+}
+#endif
@@ -0,0 +1,182 @@
+﻿#include "Kernel\Sys.h"
+#include "Core\BufferChain.h"
+#include "Net\ITransport.h"
+
+#include "TokenNet\TokenMessage.h"
+#include "TinyNet\TinyMessage.h"
+
+#if DEBUG
+
+// 只实现OnWrite，分段数据走默认的合并路径
+class MergePort : public ITransport
+{
+public:
+	ByteArray	Last;	// 最后一帧
+	int			Frames;	// 帧数
+
+	MergePort() { Frames = 0; }
+
+protected:
+	virtual bool OnWrite(const Buffer& bs) { Last = bs; Frames++; return true; }
+	virtual uint OnRead(Buffer& bs) { return 0; }
+};
+
+// 逐段写出，模拟W5500/Enc28j60直接写入芯片缓冲区
+class ChainPort : public MergePort
+{
+public:
+	int		Segments;	// 收到的段数
+
+	ChainPort() { Segments = 0; }
+
+protected:
+	virtual bool OnWriteEx(const BufferChain& bc, const void* opt)
+	{
+		Last.SetLength(0);
+		for(int i=0; i<bc.Count(); i++)
+		{
+			auto& seg	= bc[i];
+			Last.Copy(Last.Length(), seg, 0, seg.Length());
+		}
+		Segments	+= bc.Count();
+		Frames++;
+
+		return true;
+	}
+};
+
+// 发送时在前面加上地址，模拟ShunCom
+class AddrPort : public PackPort
+{
+protected:
+	virtual bool OnWriteEx(const Buffer& bs, const void* opt)
+	{
+		if(!opt) return OnWrite(bs);
+
+		ByteArray bs2;
+		bs2.Copy(0, Buffer((void*)opt, 2), 0, 2);
+		bs2.Copy(2, bs, 0, -1);
+
+		return OnWrite(bs2);
+	}
+};
+
+static void TestChain()
+{
+	byte payload[]	= { 0x10, 0x11, 0x12, 0x13, 0x14 };
+	byte inner[]	= { 0x20, 0x21 };
+	byte outer[]	= { 0x30, 0x31, 0x32 };
+
+	// 负载在先，协议头逐层往前追加
+	BufferChain bc;
+	bc.Add(Buffer(payload, sizeof(payload)));
+	bc.Prepend(Buffer(inner, sizeof(inner)));
+	bc.Prepend(Buffer(outer, sizeof(outer)));
+	assert(bc.Count() == 2 && bc.Length() == 10 && bc.HeadLength() == 5, "BufferChain");
+	assert(bc[1].GetBuffer() == payload, "负载只引用");
+
+	byte buf[16];
+	Buffer bs(buf, sizeof(buf));
+	assert(bc.CopyTo(bs) == 10, "CopyTo");
+	byte rs[]	= { 0x30, 0x31, 0x32, 0x20, 0x21, 0x10, 0x11, 0x12, 0x13, 0x14 };
+	assert(Buffer(buf, 10) == Buffer(rs, sizeof(rs)), "CopyTo");
+
+	// 偏移和目标长度不足
+	Buffer bs2(buf, 4);
+	assert(bc.CopyTo(bs2, 4) == 4 && buf[0] == 0x21 && buf[3] == 0x12, "CopyTo(offset)");
+
+	// 空段忽略
+	bc.Add(nullptr, 0);
+	assert(bc.Count() == 2, "Add(empty)");
+
+	// 默认合并与逐段写出收到相同数据
+	MergePort mp;
+	ChainPort cp;
+	mp.Write(bc);
+	cp.Write(bc);
+	assert(mp.Last == Buffer(rs, sizeof(rs)) && cp.Last == mp.Last, "Write(BufferChain)");
+	assert(cp.Segments == 2, "Segments");
+
+	// 包装口带参数发送时交给子类处理，不能丢掉地址
+	auto cp2	= new ChainPort();
+	AddrPort ap;
+	ap.Set(cp2);
+	byte addr[]	= { 0x55, 0xAA };
+	ap.Write(bc, addr);
+	assert(cp2->Last.Length() == 12 && cp2->Last[0] == 0x55 && cp2->Last[1] == 0xAA && cp2->Last[2] == 0x30, "PackPort opt");
+	ap.Write(bc);
+	assert(cp2->Last == mp.Last && cp2->Segments == 2, "PackPort");
+}
+
+// 分段与数据流两种写法的结果必须一致
+static void TestMessage()
+{
+	TokenMessage tm(0x15);
+	tm.Seq		= 0x23;
+	tm.Length	= 200;
+	for(int i=0; i<tm.Length; i++) tm.Data[i]	= i;
+
+	MemoryStream ms;
+	tm.Write(ms);
+	BufferChain bc;
+	assert(tm.Write(bc), "TokenMessage::Write(BufferChain)");
+
+	ByteArray bs(bc.Length());
+	bc.CopyTo(bs);
+	assert(bs == Buffer(ms.GetBuffer(), ms.Position()), "TokenMessage");
+
+	TinyMessage ty(0x10);
+	ty.Src		= 0x01;
+	ty.Dest		= 0x02;
+	ty.Seq		= 0x33;
+	ty.Retry	= 3;
+	ty.Length	= 20;
+	for(int i=0; i<ty.Length; i++) ty.Data[i]	= i * 3;
+
+	MemoryStream ms2;
+	ty.Write(ms2);
+	BufferChain bc2;
+	assert(ty.Write(bc2), "TinyMessage::Write(BufferChain)");
+
+	ByteArray bs2(bc2.Length());
+	bc2.CopyTo(bs2);
+	assert(bs2 == Buffer(ms2.GetBuffer(), ms2.Position()), "TinyMessage");
+}
+
+// 每条消息发送前在内存里拷贝的字节数
+static void TestCopied()
+{
+	int sizes[]	= { 16, 64, 256, 500 };
+	for(int k=0; k<ArrayLength(sizes); k++)
+	{
+		TokenMessage msg(0x15);
+		msg.Length	= sizes[k];
+
+		// 原来：头部和负载写入数据流合并
+		MemoryStream ms;
+		msg.Write(ms);
+		int before	= ms.Position();
+
+		// 现在：只有头部拷贝到预留空间
+		BufferChain bc;
+		msg.Write(bc);
+		int after	= bc.HeadLength();
+
+		debug_printf("负载%d字节 拷贝 合并=%d 分段=%d\r\n", sizes[k], before, after);
+	}
+}
+
+void TestBufferChain()
+{
+	TS("TestBufferChain");
+
+	debug_printf("\r\n");
+	debug_printf("TestBufferChain Start......\r\n");
+
+	TestChain();
+	TestMessage();
+	TestCopied();
+
+	debug_printf("\r\n TestBufferChain Finish!\r\n");
+}
+#endif
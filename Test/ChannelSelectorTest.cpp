@@ -0,0 +1,101 @@
+﻿#include "Kernel\Sys.h"
+#include "Core\Random.h"
+
+#include "TokenNet\ChannelSelector.h"
+
+#if DEBUG
+
+// 模拟通道。固定往返时间加随机抖动，按丢包率丢失心跳
+class SimChannel
+{
+public:
+	cstring		Name;
+	int			Latency;	// 往返时间ms
+	int			Loss;		// 丢包率，百分比
+	int			Used;		// 被选中的心跳数
+	ChannelStat	Stat;
+
+	void Set(cstring name, int latency, int loss)
+	{
+		Name	= name;
+		Latency	= latency;
+		Loss	= loss;
+		Used	= 0;
+		Stat.Up	= true;
+	}
+
+	void Heartbeat(const Random& rnd)
+	{
+		if(!Stat.Up) return;
+
+		Stat.OnHeartbeat();
+		if(rnd.Next(100) >= Loss) Stat.OnPing(Latency + rnd.Next(Latency / 4 + 1));
+	}
+};
+
+static void ShowUsage(SimChannel* chs, int count)
+{
+	for(int i=0; i<count; i++)
+	{
+		auto& ch	= chs[i];
+		debug_printf("\t%s 延迟=%dms 丢包=%d%% 平滑延迟=%dms 平滑丢包=%d%% 评分=%d 选中=%d\r\n", ch.Name, ch.Latency, ch.Loss, ch.Stat.Rtt, ch.Stat.Loss, ch.Stat.Score(), ch.Used);
+	}
+}
+
+void TestChannelSelector()
+{
+	TS("TestChannelSelector");
+
+	debug_printf("\r\n");
+	debug_printf("TestChannelSelector Start......\r\n");
+
+	// 以太网、WiFi、GPRS三条上行通道
+	SimChannel chs[3];
+	chs[0].Set("W5500", 20, 1);
+	chs[1].Set("Esp8266", 60, 5);
+	chs[2].Set("GSM07", 400, 10);
+
+	ChannelStat* stats[]	= { &chs[0].Stat, &chs[1].Stat, &chs[2].Stat };
+
+	Random rnd;
+	ChannelSelector sel;
+
+	// 稳定运行，应当选择以太网
+	for(int i=0; i<50; i++)
+	{
+		for(int k=0; k<3; k++) chs[k].Heartbeat(rnd);
+		int idx	= sel.Select(stats, 3);
+		if(idx >= 0) chs[idx].Used++;
+	}
+	ShowUsage(chs, 3);
+	assert(sel.Current == 0, "稳定时应选择最快通道");
+
+	// 以太网断线，必须在一个心跳内切换
+	chs[0].Stat.Up	= false;
+	for(int k=0; k<3; k++) chs[k].Heartbeat(rnd);
+	int idx	= sel.Select(stats, 3);
+	assert(idx == 1, "主通道断开后应在一个心跳内切换到次优通道");
+
+	// 以太网还在但是完全不通，连续丢失一个心跳即切换
+	chs[0].Stat.Up	= true;
+	sel.Current		= 0;
+	chs[0].Loss		= 100;
+	for(int k=0; k<3; k++) chs[k].Heartbeat(rnd);
+	chs[0].Stat.OnHeartbeat();
+	idx	= sel.Select(stats, 3);
+	assert(idx != 0, "主通道丢失心跳后应切换");
+
+	// 以太网恢复，若干心跳后切回
+	chs[0].Loss		= 0;
+	int back	= -1;
+	for(int i=0; i<50 && back < 0; i++)
+	{
+		for(int k=0; k<3; k++) chs[k].Heartbeat(rnd);
+		if(sel.Select(stats, 3) == 0) back = i + 1;
+	}
+	debug_printf("以太网恢复后 %d 个心跳切回，共切换 %d 次\r\n", back, sel.Switches);
+	assert(back > 0, "主通道恢复后应切回");
+
+	debug_printf("\r\n TestChannelSelector Finish!\r\n");
+}
+#endif
@@ -0,0 +1,150 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Core\Convert.h"
+
+#if DEBUG
+
+static void TestDecimal()
+{
+	char buf[Convert::MaxFixed];
+	int n	= Convert::ToDecimal(0U, buf);
+	assert(n == 1 && buf[0] == '0', "ToDecimal(0)");
+
+	String str;
+	str	+= 1234567890U;
+	str	+= ',';
+	str	+= -2147483647 - 1;
+	str	+= ',';
+	str	+= (UInt64)18446744073709551615ULL;
+	str	+= ',';
+	str	+= (Int64)-9000000000000000001LL;
+	str	+= ',';
+	str	+= (byte)7;
+	str	+= ',';
+	str	+= (short)-99;
+	assert(str == "1234567890,-2147483648,18446744073709551615,-9000000000000000001,7,-99", "ToDecimal");
+
+	// 十六进制固定长度
+	String hex;
+	hex.Concat((ushort)0xBEEF, -16);
+	hex.Concat((uint)0x1234ABCD, 16);
+	hex.Concat((UInt64)0x0102030405060708ULL, -16);
+	assert(hex == "BEEF1234abcd0102030405060708", "Concat(radix 16)");
+}
+
+static void TestFixed()
+{
+	String str;
+	str.Concat(3.14159f, 2);
+	str	+= ',';
+	str.Concat(-0.5f, 4);
+	str	+= ',';
+	str.Concat(2.999996f, 4);
+	str	+= ',';
+	str.Concat(-0.00001f, 2);
+	str	+= ',';
+	str.Concat(100.0, 8);
+	str	+= ',';
+	str.Concat(0.05, 3);
+	str	+= ',';
+	str.Concat(12345678.875, 2);
+	assert(str == "3.14,-0.5,3,0,100,0.05,12345678.88", "ToFixed");
+
+	char buf[Convert::MaxFixed];
+	// 超出64位整数按科学计数法
+	int n	= Convert::ToFixed(-1.5e30, 2, buf);
+	assert(String((cstring)buf, n) == "-1.5e30", "ToFixed(1e30)");
+	n	= Convert::ToFixed(1.7e308, 9, buf);
+	assert(n <= Convert::MaxFixed && String((cstring)buf, n) == "1.7e308", "ToFixed(1.7e308)");
+}
+
+static void TestHexBase64()
+{
+	byte bs[]	= { 0x00, 0x12, 0xAB, 0xFF, 'M', 'a', 'n' };
+	Buffer buf(bs, sizeof(bs));
+
+	assert(buf.ToHex() == "0012ABFF4D616E", "ToHex");
+	assert(buf.ToHex('-') == "00-12-AB-FF-4D-61-6E", "ToHex('-')");
+	assert(buf.ToHex(' ', 3) == "00 12 AB\r\nFF 4D 61\r\n6E", "ToHex(' ', 3)");
+
+	// 追加到已有内容之后
+	String str	= "Data=";
+	buf.Sub(4, 3).ToHex(str);
+	assert(str == "Data=4D616E", "ToHex(str)");
+
+	assert(buf.Sub(4, 3).ToBase64() == "TWFu", "ToBase64");
+	assert(buf.Sub(4, 2).ToBase64() == "TWE=", "ToBase64");
+	assert(buf.Sub(4, 1).ToBase64() == "TQ==", "ToBase64");
+	assert(buf.ToBase64() == "ABKr/01hbg==", "ToBase64");
+
+	// 一次预留到位，不会再按1.5倍扩容
+	byte big[102];
+	for(int i=0; i<ArrayLength(big); i++) big[i]	= i;
+	auto hex	= Buffer(big, sizeof(big)).ToHex('-');
+	assert(hex.Length() == 305 && hex.Capacity() == 306, "ToHex Capacity");
+
+	byte rs[16];
+	int n	= Convert::FromBase64("ABKr/01h\r\nbg==", 14, rs, sizeof(rs));
+	assert(n == sizeof(bs) && Buffer(rs, n) == buf, "FromBase64");
+	assert(Convert::FromBase64("AB*=", 4, rs, sizeof(rs)) == -1, "FromBase64 非法字符");
+	assert(Convert::FromBase64("ABKr/01hbg==", 12, rs, 4) == -1, "FromBase64 缓冲区不足");
+}
+
+// 格式化256字节缓冲区和1000个整数的耗时，对比逐字节追加和sprintf
+static void TestBench()
+{
+	byte bs[256];
+	for(int i=0; i<sizeof(bs); i++) bs[i]	= i * 7;
+	Buffer buf(bs, sizeof(bs));
+
+	TimeCost tc;
+	String s1;
+	for(int i=0; i<sizeof(bs); i++)
+	{
+		if(i) s1	+= ' ';
+		s1.Concat(bs[i], -16);
+	}
+	int t1	= tc.Elapsed();
+
+	tc.Reset();
+	String s2;
+	buf.ToHex(s2, ' ');
+	int t2	= tc.Elapsed();
+	assert(s1 == s2, "ToHex");
+
+	debug_printf("十六进制 256字节 逐字节=%dus 查表=%dus\r\n", t1, t2);
+
+	tc.Reset();
+	String s3;
+	char tmp[16];
+	for(int i=0; i<1000; i++)
+	{
+		sprintf(tmp, "%d", i * 9973 - 4000000);
+		s3	+= tmp;
+	}
+	t1	= tc.Elapsed();
+
+	tc.Reset();
+	String s4;
+	for(int i=0; i<1000; i++) s4	+= i * 9973 - 4000000;
+	t2	= tc.Elapsed();
+	assert(s3 == s4, "ToDecimal");
+
+	debug_printf("十进制 1000个整数 sprintf=%dus 查表=%dus\r\n", t1, t2);
+}
+
+void TestConvert()
+{
+	TS("TestConvert");
+
+	debug_printf("\r\n");
+	debug_printf("TestConvert Start......\r\n");
+
+	TestDecimal();
+	TestFixed();
+	TestHexBase64();
+	TestBench();
+
+	debug_printf("\r\n TestConvert Finish!\r\n");
+}
+#endif
@@ -0,0 +1,158 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Task.h"
+#include "Kernel\TTime.h"
+#include "Kernel\WaitHandle.h"
+#include "Kernel\Coroutine.h"
+
+#if DEBUG
+static uint _Low;		// 观察到的最深栈地址
+static int _Count;		// 睡眠次数
+static TimeCost* _Set;	// 设置句柄的时刻
+static int _Latency;	// 从设置句柄到等待者醒来的时间us
+
+// 记录当前栈深度
+static void Probe(void* param)
+{
+	int x;
+	uint sp	= (uint)&x;
+	if(!_Low || sp < _Low) _Low	= sp;
+}
+
+// 传统写法，Sys.Sleep内部嵌套调度其它任务
+static void SleepTask(void* param)
+{
+	_Count++;
+	Sys.Sleep(5);
+}
+
+// 协程写法，睡眠时返回调度器
+class SleepRoutine : public Coroutine
+{
+public:
+	int	Index;
+
+protected:
+	virtual bool Run()
+	{
+		CO_BEGIN
+
+		for(Index = 0; Index < 5; Index++)
+		{
+			_Count++;
+			CO_SLEEP(5);
+		}
+
+		CO_END
+	}
+};
+
+// 在顶层运行调度器一段时间。ExecuteForWait里不会调度从未执行过的任务
+static void RunFor(int ms)
+{
+	bool cancel	= false;
+	auto end	= Sys.Ms() + ms;
+	while(Sys.Ms() < end) Task::Scheduler()->Execute(0xFFFFFFFF, cancel);
+}
+
+static void TestStack()
+{
+	int x;
+	uint top	= (uint)&x;
+
+	// 三个任务互相嵌套睡眠
+	_Low	= 0;
+	_Count	= 0;
+	uint ids[4];
+	for(int i=0; i<3; i++) ids[i]	= Sys.AddTask(SleepTask, nullptr, 0, 1, "嵌套睡眠");
+	ids[3]	= Sys.AddTask(Probe, nullptr, 0, 1, "栈深度");
+	RunFor(200);
+	int nest	= top - _Low;
+	int n1	= _Count;
+	for(int i=0; i<4; i++) Sys.RemoveTask(ids[i]);
+
+	// 三个协程轮流睡眠
+	_Low	= 0;
+	_Count	= 0;
+	SleepRoutine cs[3];
+	for(int i=0; i<3; i++) cs[i].Start();
+	ids[3]	= Sys.AddTask(Probe, nullptr, 0, 1, "栈深度");
+	RunFor(200);
+	int co	= top - _Low;
+	Sys.RemoveTask(ids[3]);
+
+	assert(cs[0].Finished && cs[1].Finished && cs[2].Finished, "CO_SLEEP(ms)");
+	debug_printf("栈深度 嵌套=%d 字节 睡眠%d次 协程=%d 字节 睡眠%d次\r\n", nest, n1, co, _Count);
+}
+
+static WaitHandle* _Handle;
+
+// 50ms后设置句柄
+static void SetTask(void* param)
+{
+	_Set->Reset();
+	_Handle->Set();
+}
+
+static void WaitTask(void* param)
+{
+	_Handle->WaitOne(1000);
+	_Latency	= _Set->Elapsed();
+}
+
+class WaitRoutine : public Coroutine
+{
+public:
+	WaitHandle	Handle;
+
+protected:
+	virtual bool Run()
+	{
+		CO_BEGIN
+
+		CO_WAIT(Handle, 1000);
+		_Latency	= _Set->Elapsed();
+
+		CO_END
+	}
+};
+
+static void TestLatency()
+{
+	TimeCost tc;
+	_Set	= &tc;
+
+	// 传统写法，等待者在ExecuteForWait轮询中发现结果
+	WaitHandle handle;
+	_Handle	= &handle;
+	_Latency	= -1;
+	Sys.AddTask(WaitTask, nullptr, 0, -1, "句柄等待");
+	Sys.AddTask(SetTask, nullptr, 50, -1, "设置句柄");
+	RunFor(200);
+	int nest	= _Latency;
+
+	// 协程写法，句柄登记了等待任务，设置后马上唤醒
+	WaitRoutine wr;
+	_Handle	= &wr.Handle;
+	_Latency	= -1;
+	wr.Start();
+	Sys.AddTask(SetTask, nullptr, 50, -1, "设置句柄");
+	RunFor(200);
+	int co	= _Latency;
+
+	assert(wr.Finished && wr.Handle.Result, "CO_WAIT(handle, ms)");
+	debug_printf("唤醒延迟 嵌套=%dus 协程=%dus\r\n", nest, co);
+}
+
+void TestCoroutine()
+{
+	TS("TestCoroutine");
+
+	debug_printf("\r\n");
+	debug_printf("TestCoroutine Start......\r\n");
+
+	TestStack();
+	TestLatency();
+
+	debug_printf("\r\n TestCoroutine Finish!\r\n");
+}
+#endif
@@ -0,0 +1,111 @@
+﻿#include "Kernel\Sys.h"
+
+#include "Message\DataStore.h"
+
+#if DEBUG
+static int _Hooks;
+static bool OnHook(uint offset, uint size, bool write)
+{
+	_Hooks++;
+	return true;
+}
+
+static void TestDirty()
+{
+	DataStore ds;
+	ds.Data.SetLength(64);
+	ds.Data.Clear();
+
+	auto err	= "int Changed(uint version, uint start, uint& size)";
+
+	uint ver	= ds.Version;
+	uint size;
+	assert(ds.Changed(ver, 0, size) < 0, err);
+
+	// 写入第1块和第4、5块，相邻的脏块合并为一段
+	ds.Write(3, 0x11);
+	byte buf[]	= { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	ds.Write(30, Buffer(buf, sizeof(buf)));
+
+	int offset	= ds.Changed(ver, 0, size);
+	assert(offset == 0 && size == 8, err);
+	offset	= ds.Changed(ver, offset + size, size);
+	assert(offset == 24 && size == 16, err);
+	assert(ds.Changed(ver, offset + size, size) < 0, err);
+
+	// 新版本之后没有修改
+	assert(ds.Changed(ds.Version, 0, size) < 0, err);
+}
+
+static void TestSnapshot()
+{
+	DataStore ds;
+	ds.Data.SetLength(32);
+	ds.Data.Clear();
+	ds.Write(5, 0x55);
+
+	auto err	= "DataSnapshot(DataStore& store)";
+
+	DataSnapshot sn(ds);
+	assert(sn.Version == ds.Version && sn.Length() == 32, err);
+
+	// 写入者修改以后，快照仍然看到旧值
+	ds.Write(5, 0x66);
+	ds.Write(20, 0x77);
+	assert(ds.Data[5] == 0x66 && sn[5] == 0x55, err);
+	assert(ds.Data[20] == 0x77 && sn[20] == 0, err);
+
+	byte buf[4];
+	Buffer bs(buf, sizeof(buf));
+	assert(sn.Read(4, bs) == 4 && buf[1] == 0x55, "int Read(uint offset, Buffer& bs)");
+
+	// 快照销毁后从链表移除，不影响其它快照
+	{
+		DataSnapshot sn2(ds);
+	}
+	ds.Write(6, 0x01);
+	assert(sn[6] == 0 && ds.Data[6] == 0x01, err);
+}
+
+static void TestHook()
+{
+	DataStore ds;
+	ds.Data.SetLength(64);
+	ds.Data.Clear();
+
+	// 乱序注册，查找时按区间定位
+	ds.Register(40, 4, OnHook);
+	ds.Register(8, 8, OnHook);
+	ds.Register(0, 2, OnHook);
+	ds.Register(20, 16, OnHook);
+
+	auto err	= "bool OnHook(uint offset, uint size, bool write)";
+
+	_Hooks	= 0;
+	ds.Write(1, 0x01);
+	assert(_Hooks == 1, err);
+
+	byte buf[8];
+	_Hooks	= 0;
+	ds.Write(34, Buffer(buf, sizeof(buf)));
+	assert(_Hooks == 2, err);
+
+	_Hooks	= 0;
+	ds.Write(17, 0x01);
+	assert(_Hooks == 0, err);
+}
+
+void TestDataStore()
+{
+	TS("TestDataStore");
+
+	debug_printf("\r\n");
+	debug_printf("TestDataStore Start......\r\n");
+
+	TestDirty();
+	TestSnapshot();
+	TestHook();
+
+	debug_printf("\r\n TestDataStore Finish!\r\n");
+}
+#endif
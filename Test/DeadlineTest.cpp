@@ -0,0 +1,71 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Task.h"
+
+#if DEBUG
+
+// 模拟网关任务集。Delay占用CPU，不会嵌套调度其它任务
+static void LoopTask(void* param)	{ Sys.Delay(1000); }	// TinyController循环，10ms周期耗时1ms
+static void ReportTask(void* param)	{ Sys.Delay(3000); }	// Json上报，50ms周期耗时3ms
+static void FlashTask(void* param)	{ Sys.Delay(6000); }	// Flash写入，200ms周期耗时6ms
+
+// 在顶层运行调度器一段时间
+static void RunFor(int ms)
+{
+	bool cancel	= false;
+	auto end	= Sys.Ms() + ms;
+	while(Sys.Ms() < end) Task::Scheduler()->Execute(0xFFFFFFFF, cancel);
+}
+
+// 运行任务集，返回循环任务的错过次数
+static uint RunSet(bool edf)
+{
+	auto sc	= Task::Scheduler();
+
+	uint ids[3];
+	ids[0]	= Sys.AddTask(LoopTask, nullptr, 0, 10, "循环");
+	ids[1]	= Sys.AddTask(ReportTask, nullptr, 0, 50, "上报");
+	ids[2]	= Sys.AddTask(FlashTask, nullptr, 0, 200, "闪存");
+
+	// 不启用EDF时也统计错过次数
+	auto loop	= Task::Get(ids[0]);
+	if(edf)
+	{
+		// 还没有执行过，没有实测耗时，必须给出预计耗时
+		assert(!sc->SetDeadline(ids[0], 3), "SetDeadline");
+		assert(sc->SetDeadline(ids[0], 3, 1000), "SetDeadline");
+	}
+	else
+		loop->Deadline	= 3;
+
+	RunFor(2000);
+
+	uint miss	= loop->Misses;
+	debug_printf("%s 循环 %d 次 错过 %d 次 上报 %d 次 闪存 %d 次\r\n", edf ? "EDF " : "轮询", loop->Times, miss, Task::Get(ids[1])->Times, Task::Get(ids[2])->Times);
+
+	if(!edf) loop->Deadline	= 0;
+	for(int i=0; i<3; i++) Sys.RemoveTask(ids[i]);
+
+	return miss;
+}
+
+void TestDeadline()
+{
+	TS("TestDeadline");
+
+	debug_printf("\r\n");
+	debug_printf("TestDeadline Start......\r\n");
+
+	uint m1	= RunSet(false);
+	uint m2	= RunSet(true);
+	assert(m2 <= m1, "EDF");
+
+	// 准入检查。实测耗时3ms的任务，截止时间1ms周期2ms，利用率超过100%
+	auto sc	= Task::Scheduler();
+	uint id	= Sys.AddTask(ReportTask, nullptr, 0, 2, "超载");
+	RunFor(20);
+	assert(!sc->SetDeadline(id, 1), "Admission");
+	Sys.RemoveTask(id);
+
+	debug_printf("\r\n TestDeadline Finish!\r\n");
+}
+#endif
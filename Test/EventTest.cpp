@@ -0,0 +1,161 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Kernel\Heap.h"
+#include "Core\Event.h"
+
+#if DEBUG
+
+static int _Sum	= 0;
+
+static void OnStatic(int v)	{ _Sum	+= v; }
+
+class Listener
+{
+public:
+	int		Total;
+	EventNode<int>	Node;	// 订阅节点放在订阅者内部
+
+	Listener()	{ Total = 0; Node.Bind<Listener, &Listener::OnValue>(this); }
+
+	void OnValue(int v)	{ Total	+= v; }
+	// 重载的成员函数也能按参数选对
+	void OnValue()		{ Total	= 0; }
+	void OnPair(int v, int v2)	{ Total	+= v * v2; }
+};
+
+static void TestMulticast()
+{
+	_Sum	= 0;
+
+	Event<int> evt;
+	assert(!evt && evt.Count() == 0, "Event");
+
+	// 默认处理者，兼容单播写法
+	evt	= OnStatic;
+	evt(1);
+	assert(_Sum == 1 && evt.Count() == 1, "Default");
+
+	Listener a, b;
+	evt.Add(a.Node);
+	{
+		// 订阅者销毁时自动退订
+		Listener c;
+		evt.Add(c.Node);
+		evt.Add(b.Node);
+		assert(evt.Count() == 4, "Add");
+		evt(2);
+		assert(c.Total == 2, "Add");
+	}
+	assert(evt.Count() == 3, "Auto unlink");
+
+	evt.Remove(a.Node);
+	evt(3);
+	assert(_Sum == 6 && a.Total == 2 && b.Total == 5, "Remove");
+
+	evt	= nullptr;
+	evt(4);
+	assert(_Sum == 6 && b.Total == 9 && evt.Count() == 1, "Clear default");
+
+	// 事件先销毁，节点脱离链表
+	auto pe	= new Event<int>();
+	pe->Add(a.Node);
+	delete pe;
+	assert(!a.Node.Linked(), "Event dtor");
+}
+
+// 处理函数里退订别的订阅者
+class Remover
+{
+public:
+	int		Total;
+	EventNode<int>	Node;
+	EventNode<int>*	Target;		// 要退订的节点
+	Listener*	Victim;			// 要销毁的订阅者
+
+	Remover()	{ Total = 0; Target = nullptr; Victim = nullptr; Node.Bind<Remover, &Remover::OnValue>(this); }
+
+	void OnValue(int v)
+	{
+		Total	+= v;
+		if(Target) Target->Unlink();
+		if(Victim) { delete Victim; Victim = nullptr; }
+	}
+};
+
+static void TestRemove()
+{
+	Event<int> evt;
+	Listener a, b;
+	Remover r;
+
+	// 退订紧跟着的下一个订阅者，它不再被调用，遍历也不会停在它身上
+	evt.Add(r.Node);
+	evt.Add(a.Node);
+	evt.Add(b.Node);
+	r.Target	= &a.Node;
+	evt(1);
+	assert(r.Total == 1 && a.Total == 0 && b.Total == 1 && evt.Count() == 2, "Unlink next");
+
+	// 销毁下一个订阅者
+	auto c	= new Listener();
+	evt.Add(c->Node);
+	evt.Remove(b.Node);
+	evt.Add(b.Node);
+	r.Target	= nullptr;
+	r.Victim	= c;
+	evt(2);
+	assert(r.Total == 3 && b.Total == 3 && evt.Count() == 2, "Delete next");
+
+	// 退订自己
+	r.Target	= &r.Node;
+	evt(3);
+	evt(4);
+	assert(r.Total == 6 && b.Total == 10 && evt.Count() == 1, "Unlink self");
+}
+
+static void TestMethod()
+{
+	Listener a;
+
+	// 编译时绑定成员函数，不需要强转成员函数指针
+	Delegate2<int, int> dlg;
+	dlg.Bind<Listener, &Listener::OnPair>(&a);
+	dlg(3, 4);
+	assert(a.Total == 12, "Bind");
+
+	Delegate2<int, int> dlg2(MethodOf(&Listener::OnPair), &a);
+	dlg2(1, 2);
+	assert(a.Total == 14, "MethodOf");
+}
+
+void TestEvent()
+{
+	TS("TestEvent");
+
+	debug_printf("\r\n");
+	debug_printf("TestEvent Start......\r\n");
+
+	TestMulticast();
+	TestRemove();
+	TestMethod();
+
+	// 8个订阅者的分发耗时，全程没有堆分配
+	const int count	= 8;
+	const int times	= 1000;
+	Listener ls[count];
+	Event<int> evt;
+
+	auto hp	= Heap::Current;
+	uint n	= hp ? hp->Allocs() : 0;
+	for(int i=0; i<count; i++) evt.Add(ls[i].Node);
+	assert(!hp || hp->Allocs() == n, "Heap");
+
+	TimeCost tc;
+	for(int i=0; i<times; i++) evt(i);
+	int us	= tc.Elapsed();
+
+	debug_printf("订阅者=%d 每次分发=%d周期\r\n", count, (uint)((UInt64)us * (Sys.Clock / 1000000) / times));
+
+	debug_printf("\r\n TestEvent Finish!\r\n");
+}
+#endif
@@ -0,0 +1,102 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Core\Intern.h"
+
+#if DEBUG
+
+static void TestPool()
+{
+	// 编译期哈希与运行期一致
+	static_assert(HashOf("") == 2166136261U, "HashOf");
+	assert(HashOf("Device/Login") == Intern::Hash("Device/Login"), "HashOf");
+	assert(Intern::Hash("Device/Login!", 12) == Intern::Hash("Device/Login"), "Hash(len)");
+
+	cstring name	= "Test/Intern";
+	assert(Intern::Find(name) == nullptr, "Find");
+
+	// 静态字符串直接引用
+	int n	= Intern::Count();
+	assert(Intern::Static(name) == name, "Static");
+	assert(Intern::Count() == n + 1, "Count");
+
+	// 相同内容得到同一个指针
+	char buf[]	= "Test/Intern";
+	assert(Intern::Find(buf) == name, "Find");
+	assert(Intern::Add(buf) == name, "Add");
+	assert(INTERN("Test/Intern") == name, "INTERN");
+	assert(Intern::Count() == n + 1, "Count");
+
+	// 非静态字符串拷贝一份
+	String str	= "Test/Intern2";
+	auto p	= Intern::Add(str.GetBuffer(), str.Length());
+	assert(p != str.GetBuffer() && String(p) == str, "Add");
+	str	= "Test/Intern3";
+	assert(Intern::Find("Test/Intern2") == p, "Find");
+
+	// 按长度截取
+	assert(Intern::Find("Test/Intern2xyz", 12) == p, "Find(len)");
+}
+
+// 32个路由，按字符串比较查找与按驻留指针查找的耗时
+static void TestBench()
+{
+	static cstring names[]	=
+	{
+		"Device/Query", "Device/Read", "Device/Write", "Device/Reset", "Device/Restart", "Device/Info", "Device/Time", "Device/Config",
+		"Proxy/GetConfig", "Proxy/SetConfig", "Proxy/Open", "Proxy/Close", "Proxy/Write", "Proxy/Read", "Proxy/QueryPorts", "Proxy/Upload",
+		"Gateway/Restart", "Gateway/Reset", "Gateway/SetRemote", "Gateway/GetRemote", "Gateway/Query", "Gateway/Bind", "Gateway/Unbind", "Gateway/Scan",
+		"Api/All", "Api/Info", "Node/Add", "Node/Remove", "Node/Query", "Node/Read", "Node/Write", "Node/Config",
+	};
+	int count	= ArrayLength(names);
+
+	Dictionary<cstring, int> dic1(String::Compare);
+	Dictionary<cstring, int> dic2;
+	for(int i=0; i<count; i++)
+	{
+		dic1.Add(names[i], i);
+		dic2.Add(Intern::Static(names[i]), i);
+	}
+
+	// 模拟收到的消息，动作名称在接收缓冲区里
+	String acts[8];
+	for(int i=0; i<ArrayLength(acts); i++) acts[i]	= names[count - 1 - i * 3];
+
+	TimeCost tc;
+	int sum1	= 0;
+	for(int i=0; i<1000; i++)
+	{
+		int v	= -1;
+		dic1.TryGetValue(acts[i & 7].GetBuffer(), v);
+		sum1	+= v;
+	}
+	int t1	= tc.Elapsed();
+
+	tc.Reset();
+	int sum2	= 0;
+	for(int i=0; i<1000; i++)
+	{
+		auto& act	= acts[i & 7];
+		int v	= -1;
+		auto key	= Intern::Find(act.GetBuffer(), act.Length());
+		if(key) dic2.TryGetValue(key, v);
+		sum2	+= v;
+	}
+	int t2	= tc.Elapsed();
+	assert(sum1 == sum2, "Route");
+
+	debug_printf("路由%d个 查找1000次 字符串比较=%dus 驻留指针=%dus\r\n", count, t1, t2);
+}
+
+void TestIntern()
+{
+	TS("TestIntern");
+
+	debug_printf("\r\n");
+	debug_printf("TestIntern Start......\r\n");
+
+	TestPool();
+	TestBench();
+
+	debug_printf("\r\n TestIntern Finish!\r\n");
+}
+#endif
@@ -0,0 +1,64 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Kernel\Interrupt.h"
+
+#if DEBUG
+
+// 使用不存在的中断号，直接在任务里模拟中断投递
+#define TEST_IRQ	100
+
+static int _Count;
+static uint _Sum;
+
+static void OnDeferred(ushort num, void* param, uint data)
+{
+	_Count++;
+	_Sum	+= data;
+	*(int*)param	= num;
+}
+
+void TestInterrupt()
+{
+	TS("TestInterrupt");
+
+	debug_printf("\r\n");
+	debug_printf("TestInterrupt Start......\r\n");
+
+	int num	= 0;
+	_Count	= 0;
+	_Sum	= 0;
+	assert(Interrupt.ActivateDeferred(TEST_IRQ, OnDeferred, &num), "ActivateDeferred");
+
+	// 投递耗时，中断上半部只剩这些开销
+	TimeCost tc;
+	for(int i=1; i<=10; i++) TInterrupt::Post(TEST_IRQ, i);
+	int cost	= tc.Elapsed();
+
+	TInterrupt::Drain();
+	assert(_Count == 10 && _Sum == 55, "Drain");
+	assert(num == TEST_IRQ, "num");
+
+	// 超过队列容量的事件被丢弃，不影响已排队的事件
+	int ok	= 0;
+	for(int i=0; i<40; i++)
+	{
+		if(TInterrupt::Post(TEST_IRQ, 1)) ok++;
+	}
+	assert(ok < 40, "Drops");
+	// 每批最多处理一圈
+	TInterrupt::Drain();
+	assert(_Count == 10 + ok, "Batch");
+
+	// 未注册下半部的事件直接忽略
+	TInterrupt::Post(TEST_IRQ + 1, 1);
+	TInterrupt::Drain();
+	assert(_Count == 10 + ok, "Unknown");
+
+	debug_printf("投递10次 %dus\r\n", cost);
+	TInterrupt::ShowDeferred();
+
+	Interrupt.DeactivateDeferred(TEST_IRQ);
+
+	debug_printf("\r\n TestInterrupt Finish!\r\n");
+}
+#endif
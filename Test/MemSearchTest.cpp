@@ -0,0 +1,99 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Core\MemSearch.h"
+#include "Core\StringView.h"
+
+#if DEBUG
+
+// 模拟Esp8266/GSM模块的一段接收数据
+static cstring _Trace	=
+	"AT+CIPSEND=0,64\r\n\r\nOK\r\n> \r\nRecv 64 bytes\r\n\r\nSEND OK\r\n"
+	"\r\n+IPD,0,48,192.168.1.100,3377:{\"id\":12,\"action\":\"Device/Ping\",\"data\":1}\r\n"
+	"+CSQ: 23,99\r\n\r\nOK\r\n+CREG: 0,1\r\n\r\nOK\r\n+CIPSTATUS:0,\"TCP\",\"192.168.1.100\",3377,0\r\n"
+	"\r\n+IPD,1,16,10.0.0.2,80:HTTP/1.1 200 OK\r\n\r\nbusy p...\r\nOK\r\n";
+
+// 逐字节查找，作为对照
+static int NaiveIndexOf(cstring s, int len, cstring key, int klen)
+{
+	for(int i = 0; i + klen <= len; i++)
+	{
+		int k = 0;
+		while(k < klen && s[i + k] == key[k]) k++;
+		if(k == klen) return i;
+	}
+	return -1;
+}
+
+static void TestCorrect(cstring s, int len)
+{
+	cstring keys[]	= { "OK", "+IPD", "\r\n", "SEND OK", "busy ", "ERROR", "3377:", "}" };
+	for(int i = 0; i < ArrayLength(keys); i++)
+	{
+		cstring key	= keys[i];
+		int klen	= StringView(key).Length();
+		SearchPattern sp(key);
+		// 每个起点都查一次，覆盖各种对齐
+		for(int k = 0; k < len; k += 7)
+		{
+			int p	= NaiveIndexOf(s + k, len - k, key, klen);
+			if(p >= 0) p	+= k;
+			assert(MemSearch::IndexOf(s + k, len - k, key, klen) == (p >= 0 ? p - k : -1), "IndexOf");
+			assert(sp.IndexOf(s, len, k) == p, "SearchPattern");
+		}
+	}
+
+	assert(MemSearch::IndexOf(s, len, '{') == NaiveIndexOf(s, len, "{", 1), "IndexOf(byte)");
+	assert(MemSearch::LastIndexOf(s, len, '\n') == len - 1, "LastIndexOf(byte)");
+	assert(MemSearch::LastIndexOf(s, len, "+IPD", 4) > MemSearch::IndexOf(s, len, "+IPD", 4), "LastIndexOf");
+	assert(MemSearch::Compare(s, s, len) == 0, "Compare");
+	assert(MemSearch::Compare("abcdefgh1", "abcdefgh2", 9) < 0, "Compare");
+	assert(MemSearch::Compare("\xF0", "\x10", 1) > 0, "Compare unsigned");
+}
+
+static void TestSpeed(cstring s, int len)
+{
+	const int times	= 100;
+	int n	= 0;
+	SearchPattern sp("SEND OK");
+
+	TimeCost tc;
+	for(int i = 0; i < times; i++) n	+= NaiveIndexOf(s, len, "SEND OK", 7);
+	int t1	= tc.Elapsed();
+
+	tc.Reset();
+	for(int i = 0; i < times; i++) n	+= MemSearch::IndexOf(s, len, "SEND OK", 7);
+	int t2	= tc.Elapsed();
+
+	tc.Reset();
+	for(int i = 0; i < times; i++) n	+= sp.IndexOf(s, len);
+	int t3	= tc.Elapsed();
+
+	tc.Reset();
+	for(int i = 0; i < times; i++) n	+= NaiveIndexOf(s, len, "}", 1);
+	int t4	= tc.Elapsed();
+
+	tc.Reset();
+	for(int i = 0; i < times; i++) n	+= MemSearch::IndexOf(s, len, '}');
+	int t5	= tc.Elapsed();
+
+	debug_printf("%d字节 查找\"SEND OK\" 逐字节=%dus 并行=%dus 模式=%dus 查找'}' 逐字节=%dus 并行=%dus (%d)\r\n", len, t1, t2, t3, t4, t5, n);
+}
+
+void TestMemSearch()
+{
+	TS("TestMemSearch");
+
+	debug_printf("\r\n");
+	debug_printf("TestMemSearch Start......\r\n");
+
+	int len	= StringView(_Trace).Length();
+	TestCorrect(_Trace, len);
+	// 非对齐起点
+	TestCorrect(_Trace + 1, len - 1);
+	TestCorrect(_Trace + 3, len - 3);
+
+	TestSpeed(_Trace, len);
+
+	debug_printf("\r\n TestMemSearch Finish!\r\n");
+}
+#endif
@@ -0,0 +1,155 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Heap.h"
+#include "Kernel\TTime.h"
+#include "Core\MemoryArena.h"
+
+#include "Message\BinaryPair.h"
+
+#if DEBUG
+
+// 模拟一次TokenMessage调用：解析Action，生成较大的结果，再打包成回复
+static void Invoke(MemoryArena* arena)
+{
+	byte req[]	= { 6, 'A', 'c', 't', 'i', 'o', 'n', 12, 'D', 'e', 'v', 'i', 'c', 'e', '/', 'Q', 'u', 'e', 'r', 'y' };
+	MemoryStream rq(req, sizeof(req));
+	BinaryPair bp(rq);
+
+	String action;
+	action.Arena	= arena;
+	bp.Get("Action", action);
+
+	MemoryStream result;
+	result.Arena	= arena;
+	for(int i=0; i<24; i++) result.Write((uint)i);
+
+	String msg;
+	msg.Arena	= arena;
+	for(int i=0; i<20; i++) msg += "Name=Value;";
+
+	MemoryStream ms;
+	ms.Arena	= arena;
+	BinaryPair rs(ms);
+	rs.Set("Result", Buffer(result.GetBuffer(), result.Position()));
+	rs.Set("Message", msg);
+}
+
+static void TestGrowth()
+{
+	auto hp	= Heap::Current;
+
+	// 1.5倍扩容，连续追加时的堆分配次数
+	uint n	= hp->Allocs();
+	String str;
+	for(int i=0; i<100; i++) str += "abcd";
+	debug_printf("追加400字节 分配=%d 容量=%d\r\n", hp->Allocs() - n, str.Capacity());
+	assert(str.Length() == 400, "Append");
+
+	// 预留后不再分配
+	String str2;
+	str2.Reserve(400);
+	n	= hp->Allocs();
+	for(int i=0; i<100; i++) str2 += "abcd";
+	assert(hp->Allocs() == n, "Reserve");
+	assert(str2 == str, "Reserve");
+
+	// 缩小后搬回内部缓冲区，数据和结尾0都在
+	str.SetLength(8);
+	str.ShrinkToFit();
+	assert(str.Capacity() == 8 && str == "abcdabcd" && str.GetBuffer()[8] == 0, "ShrinkToFit");
+
+	ByteArray bs;
+	bs.SetLength(0x100);
+	bs[0]	= 0x55;
+	bs.SetLength(4);
+	bs.ShrinkToFit();
+	assert(bs.Length() == 4 && bs[0] == 0x55, "ShrinkToFit");
+
+	List<int> list;
+	for(int i=0; i<100; i++) list.Add(i);
+	assert(list.Count() == 100 && list[99] == 99, "List");
+	while(list.Count() > 2) list.RemoveAt(list.Count() - 1);
+	list.ShrinkToFit();
+	assert(list[0] == 0 && list[1] == 1, "List ShrinkToFit");
+}
+
+static void TestArena()
+{
+	byte buf[0x80];
+	MemoryArena arena(buf, sizeof(buf), 0x80);
+
+	// 首块用外部缓冲区
+	auto p	= arena.Alloc(0x10);
+	assert(arena.Contains(p) && arena.Chunks() == 0, "Alloc");
+
+	// 最后一次分配可以原地调整
+	assert(arena.Resize(p, 0x10, 0x20), "Resize");
+	auto p2	= arena.Alloc(0x10);
+	assert(!arena.Resize(p, 0x20, 0x30), "Resize not last");
+
+	// 不够时串新块
+	arena.Alloc(0x100);
+	assert(arena.Chunks() == 1 && arena.Used() == 0x130, "Chunk");
+
+	arena.Reset();
+	assert(arena.Chunks() == 0 && arena.Used() == 0 && arena.Alloc(0x10) == p, "Reset");
+	assert(p2, "Alloc");
+}
+
+// 内存区里的临时数组移交给外面的对象时，数据要拷出内存区
+static void TestMove()
+{
+	byte buf[0x100];
+	MemoryArena arena(buf, sizeof(buf));
+	auto keep	= new Array((void*)nullptr, 0);
+
+	Array tmp((void*)nullptr, 0);
+	tmp.Arena	= &arena;
+	tmp.SetLength(0x10);
+	tmp[0]	= 0x5A;
+	assert(arena.Contains(tmp.GetBuffer()), "Arena");
+
+	*keep	= (Array&&)tmp;
+	arena.Reset();
+	assert(!arena.Contains(keep->GetBuffer()) && keep->Length() == 0x10 && (*keep)[0] == 0x5A, "move");
+	delete keep;
+}
+
+void TestMemoryArena()
+{
+	TS("TestMemoryArena");
+
+	debug_printf("\r\n");
+	debug_printf("TestMemoryArena Start......\r\n");
+
+	TestArena();
+	TestMove();
+	TestGrowth();
+
+	auto hp	= Heap::Current;
+	const int times	= 20;
+
+	// 逐个new/delete
+	uint n	= hp->Allocs();
+	TimeCost tc;
+	for(int i=0; i<times; i++) Invoke(nullptr);
+	int t1	= tc.Elapsed();
+	uint a1	= hp->Allocs() - n;
+
+	// 每条消息一个栈上内存区，用完整体释放
+	n	= hp->Allocs();
+	tc.Reset();
+	for(int i=0; i<times; i++)
+	{
+		byte buf[0x200];
+		MemoryArena arena(buf, sizeof(buf));
+		Invoke(&arena);
+	}
+	int t2	= tc.Elapsed();
+	uint a2	= hp->Allocs() - n;
+
+	debug_printf("每条消息 堆分配 %d.%02d => %d.%02d 次 耗时 %dus => %dus\r\n", a1 / times, a1 * 100 / times % 100, a2 / times, a2 * 100 / times % 100, t1 / times, t2 / times);
+	assert(a2 < a1, "Arena");
+
+	debug_printf("\r\n TestMemoryArena Finish!\r\n");
+}
+#endif
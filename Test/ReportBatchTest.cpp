@@ -0,0 +1,76 @@
+﻿#include "Kernel\Sys.h"
+
+#include "Message\ReportBatch.h"
+
+#if DEBUG
+static void TestMerge()
+{
+	ReportBatch rp;
+	rp.Gap	= 2;
+
+	auto err	= "bool Next(int& offset, int& len)";
+
+	// 重叠、相邻和小间隔的区间合并为一段
+	rp.Set(1, 2);
+	rp.Set(2, 2);
+	rp.Set(4, 1);
+	rp.Set(7, 1);
+	// 间隔超过Gap，单独一段
+	rp.Set(20, 3);
+
+	int offset, len;
+	assert(rp.Next(offset, len), err);
+	assert(offset == 1 && len == 7, err);
+	assert(rp.Next(offset, len), err);
+	assert(offset == 20 && len == 3, err);
+	assert(!rp.Next(offset, len), err);
+	assert(!rp.Any(), "bool Any() const");
+}
+
+static void TestMaxSize()
+{
+	ReportBatch rp;
+	rp.MaxSize	= 8;
+
+	auto err	= "int Set(int offset, int len)";
+
+	// 未攒够一条消息时等待延迟预算，攒够以后马上上报
+	assert(rp.Set(0, 4) > 0, err);
+	assert(rp.Set(4, 4) == 0, err);
+	assert(rp.Set(250, 10) < 0, err);
+
+	// 合并长度不超过MaxSize
+	rp.Set(8, 4);
+	int offset, len;
+	assert(rp.Next(offset, len) && offset == 0 && len == 8, "bool Next(int& offset, int& len)");
+	assert(rp.Next(offset, len) && offset == 8 && len == 4, "bool Next(int& offset, int& len)");
+}
+
+static void TestBurst()
+{
+	ReportBatch rp;
+
+	// 16路开关逐个变化，原来每次变化一条消息，合并后只有一条
+	for(int i=0; i<16; i++) rp.Set(1 + i, 1);
+
+	int offset, len, count = 0;
+	while(rp.Next(offset, len)) count++;
+
+	assert(count == 1 && rp.Marks == 16 && rp.Flushes == 1, "Burst");
+	debug_printf("标记 %d 次，上报 %d 条 \r\n", rp.Marks, rp.Flushes);
+}
+
+void TestReportBatch()
+{
+	TS("TestReportBatch");
+
+	debug_printf("\r\n");
+	debug_printf("TestReportBatch Start......\r\n");
+
+	TestMerge();
+	TestMaxSize();
+	TestBurst();
+
+	debug_printf("\r\n TestReportBatch Finish!\r\n");
+}
+#endif
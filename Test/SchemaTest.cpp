@@ -0,0 +1,191 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Message\Schema.h"
+
+#include "TinyNet\JoinMessage.h"
+#include "TinyNet\TinyConfig.h"
+#include "TokenNet\LoginMessage.h"
+
+#if DEBUG
+
+// 原来手写的组网请求编码，用于对照格式和速度
+static void WriteJoin(Stream& ms, const JoinMessage& msg)
+{
+	ms.Write(msg.Version);
+	ms.Write(msg.Kind);
+	ms.Write(msg.TranID);
+	ms.WriteArray(msg.HardID);
+}
+
+static void ReadJoin(Stream& ms, JoinMessage& msg)
+{
+	msg.Version	= ms.ReadByte();
+	msg.Kind	= ms.ReadUInt16();
+	msg.TranID	= ms.ReadUInt32();
+	msg.HardID	= ms.ReadArray();
+}
+
+static void TestJoin()
+{
+	JoinMessage msg;
+	msg.Kind	= 0x0201;
+	msg.TranID	= 0x12345678;
+	msg.HardID.SetLength(12);
+	for(int i=0; i<12; i++) msg.HardID[i]	= i;
+
+	// 格式必须与手写的完全一致
+	MemoryStream ms1;
+	MemoryStream ms2;
+	WriteJoin(ms1, msg);
+	msg.Write(ms2);
+	assert(ms1.Position() == ms2.Position(), "Join Size");
+	assert(Buffer(ms1.GetBuffer(), ms1.Position()) == Buffer(ms2.GetBuffer(), ms2.Position()), "Join Write");
+
+	JoinMessage msg2;
+	Stream ms3(ms2.GetBuffer(), ms2.Position());
+	assert(msg2.Read(ms3), "Join Read");
+	assert(msg2.Kind == msg.Kind && msg2.TranID == msg.TranID && msg2.HardID == msg.HardID, "Join Read");
+
+	// 数据不足时一次检查就返回
+	Stream ms4(ms2.GetBuffer(), 5);
+	assert(!msg2.Read(ms4), "Join Short");
+
+	// 编解码吞吐
+	const int times	= 200;
+	byte buf[64];
+	TimeCost tc;
+	for(int i=0; i<times; i++)
+	{
+		Stream ms(buf, sizeof(buf));
+		WriteJoin(ms, msg);
+		ms.SetPosition(0);
+		ReadJoin(ms, msg2);
+	}
+	int t1	= tc.Elapsed();
+
+	tc.Reset();
+	for(int i=0; i<times; i++)
+	{
+		Stream ms(buf, sizeof(buf));
+		msg.Write(ms);
+		ms.SetPosition(0);
+		msg2.Read(ms);
+	}
+	int t2	= tc.Elapsed();
+
+	debug_printf("JoinMessage %d次编解码 手写=%dus 描述=%dus\r\n", times, t1, t2);
+}
+
+static void TestLogin()
+{
+	LoginMessage msg;
+	msg.User	= "stone";
+	msg.Pass	= "123456";
+	msg.Salt.SetLength(4);
+
+	MemoryStream ms;
+	msg.Write(ms);
+
+	LoginMessage msg2;
+	ms.SetPosition(0);
+	msg2.Read(ms);
+	assert(msg2.User == msg.User && msg2.Pass == msg.Pass && msg2.Salt.Length() == 4, "Login");
+	// 空的可选字段不写
+	assert(msg2.Cookie.Length() == 0, "Login Optional");
+
+	const int times	= 50;
+	TimeCost tc;
+	for(int i=0; i<times; i++)
+	{
+		MemoryStream ms2;
+		msg.Write(ms2);
+		ms2.SetPosition(0);
+		msg2.Read(ms2);
+	}
+	debug_printf("LoginMessage %d次编解码 %dus %d字节\r\n", times, tc.Elapsed(), ms.Position());
+}
+
+// 新版本多出可选字段，旧版本跳过
+struct SchemaV1 { byte A; ushort B; };
+struct SchemaV2 { byte A; ushort B; uint C; byte D; };
+
+static void TestCompatible()
+{
+	static const FieldInfo f1[]	= { FIELD(SchemaV1, A), FIELD(SchemaV1, B) };
+	static const FieldInfo f2[]	= { FIELD(SchemaV2, A), FIELD(SchemaV2, B), FIELD_EX(SchemaV2, C, "C", Schema::Optional), FIELD_EX(SchemaV2, D, "D", Schema::Optional) };
+	Schema s1(f1, ArrayLength(f1));
+	Schema s2(f2, ArrayLength(f2));
+
+	SchemaV2 v2	= { 1, 0x0203, 0x04050607, 8 };
+	MemoryStream ms;
+	s2.Write(ms, &v2);
+	assert(ms.Position() == s2.Size(&v2), "Size");
+
+	// 旧版本读新数据
+	SchemaV1 v1	= { 0, 0 };
+	Stream ms1(ms.GetBuffer(), ms.Position());
+	assert(s1.Read(ms1, &v1) && v1.A == 1 && v1.B == 0x0203, "Forward");
+
+	// 新版本读旧数据，可选字段保持默认值
+	MemoryStream ms2;
+	s1.Write(ms2, &v1);
+	SchemaV2 v3	= { 0, 0, 99, 99 };
+	Stream ms3(ms2.GetBuffer(), ms2.Position());
+	assert(s2.Read(ms3, &v3) && v3.B == 0x0203 && v3.C == 99, "Backward");
+}
+
+// 大字段、尾部填充和截断的变长字段
+struct SchemaBig { byte A; byte Key[40]; ushort B; ByteArray Data; };
+
+static void TestEdge()
+{
+	static const FieldInfo fs[]	= { FIELD(SchemaBig, A), FIELD(SchemaBig, Key), FIELD(SchemaBig, B), FIELD(SchemaBig, Data) };
+	Schema sc(fs, ArrayLength(fs));
+
+	SchemaBig v1;
+	v1.A	= 1;
+	for(int i=0; i<ArrayLength(v1.Key); i++) v1.Key[i]	= i;
+	v1.B	= 0x0203;
+	v1.Data.SetLength(3);
+
+	// 超过暂存缓冲区的定长字段
+	MemoryStream ms;
+	sc.Write(ms, &v1);
+	assert(ms.Position() == sc.Size(&v1), "Big Size");
+
+	// 没有可选字段时，尾部填充不影响解析
+	ms.Write((byte)0xFF);
+	ms.Write((byte)0x7F);
+	SchemaBig v2;
+	Stream ms1(ms.GetBuffer(), ms.Position());
+	assert(sc.Read(ms1, &v2) && v2.B == v1.B && Buffer(v2.Key, 40) == Buffer(v1.Key, 40) && v2.Data.Length() == 3, "Big Read");
+
+	// 变长字段声明的长度超出数据
+	Stream ms2(ms.GetBuffer(), sc.Size(&v1) - 1);
+	assert(!sc.Read(ms2, &v2), "Array Short");
+}
+
+static void TestConfig()
+{
+	auto tc	= TinyConfig::Create();
+	MemoryStream ms;
+	tc->Write(ms);
+	debug_printf("TinyConfig 原始 %d 字节，描述编码 %d 字节\r\n", tc->Size(), ms.Position());
+}
+
+void TestSchema()
+{
+	TS("TestSchema");
+
+	debug_printf("\r\n");
+	debug_printf("TestSchema Start......\r\n");
+
+	TestJoin();
+	TestLogin();
+	TestCompatible();
+	TestEdge();
+	TestConfig();
+
+	debug_printf("\r\n TestSchema Finish!\r\n");
+}
+#endif
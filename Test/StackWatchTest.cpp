@@ -0,0 +1,67 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Thread.h"
+#include "Kernel\StackWatch.h"
+
+#if DEBUG
+
+// 递归消耗指定字节的栈
+static int Deep(int n)
+{
+	volatile byte buf[64];
+	buf[0]	= (byte)n;
+	if(n <= 1) return buf[0];
+
+	return Deep(n - 1) + buf[0];
+}
+
+static volatile bool _Done;
+static void DeepTask(void* param)
+{
+	Deep((int)param);
+	_Done	= true;
+	// 等待主线程统计完成再退出，线程结束后自行销毁
+	while(_Done) Sys.Sleep(10);
+}
+
+void TestStackWatch()
+{
+	TS("TestStackWatch");
+
+	debug_printf("\r\n");
+	debug_printf("TestStackWatch Start......\r\n");
+
+	// 填充后只有被改写的部分计入用量
+	uint buf[32];
+	StackWatch::Paint(buf, buf + 32);
+	assert(StackWatch::Used(buf, buf + 32) == 0, "Paint");
+	buf[24]	= 0;
+	assert(StackWatch::Used(buf, buf + 32) == 8 * 4, "Used");
+	assert(StackWatch::Recommend(100) == 128, "Recommend");
+
+	// 主栈水位随调用加深
+	StackWatch::PaintMain(0x400);
+	if(StackWatch::MainPainted())
+	{
+		uint u1	= StackWatch::MainUsed();
+		Deep(4);
+		uint u2	= StackWatch::MainUsed();
+		assert(u2 >= u1 + 4 * 64, "MainUsed");
+		StackWatch::ShowMain();
+	}
+
+	// 线程栈水位
+	_Done	= false;
+	auto th	= new Thread(DeepTask, (void*)4, 0x200);
+	th->Name	= "Deep";
+	// 未运行时只有初始寄存器帧
+	uint u0	= th->StackUsed();
+	th->Start();
+	while(!_Done) Sys.Sleep(10);
+
+	assert(th->StackUsed() >= u0 + 4 * 64, "StackUsed");
+	Thread::ShowStacks();
+	_Done	= false;
+
+	debug_printf("\r\n TestStackWatch Finish!\r\n");
+}
+#endif
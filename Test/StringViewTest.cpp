@@ -0,0 +1,127 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Kernel\StackWatch.h"
+#include "Core\StringView.h"
+
+#include "Net\IPAddress.h"
+
+#if DEBUG
+
+static void TestBasic()
+{
+	StringView s	= "  +IPD,0,12,192.168.1.10,8080:hello world!\r\n";
+	auto t	= s.Trim();
+	assert(t.Length() == s.Length() - 4, "Trim");
+	assert(t.StartsWith("+IPD,") && t.EndsWith("world!"), "StartsWith");
+	assert(t.IndexOf(',') == 4 && t.IndexOf("192") == 11, "IndexOf");
+	assert(t.LastIndexOf(':') == t.IndexOf(':'), "LastIndexOf");
+	assert(t.Sub(0, 4) == "+IPD" && t.Sub(100) == "", "Sub");
+	assert(StringView("Tcp").EqualsIgnoreCase("tcp"), "EqualsIgnoreCase");
+
+	StringView item;
+	auto sp	= t;
+	assert(sp.Split(",", item) && item == "+IPD", "Split1");
+	assert(sp.Split(",", item) && item.ToInt() == 0, "Split2");
+	assert(sp.Split(",", item) && item.ToInt() == 12, "Split3");
+	assert(sp.Split(",", item) && IPAddress::Parse(item) == IPAddress(192, 168, 1, 10), "Split4");
+	assert(sp.Split(":", item) && item.ToInt() == 8080, "Split5");
+	assert(sp == "hello world!", "Remain");
+	assert(sp.Split(",", item) && item == "hello world!" && !sp.Split(",", item), "SplitEnd");
+
+	assert(StringView("-123x").ToInt() == -123 && StringView("x").ToInt(-1) == -1, "ToInt");
+	assert(StringView("0x1F").ToHex() == 0x1F, "ToHex");
+	float f	= StringView("3.25").ToFloat();
+	assert(f > 3.24f && f < 3.26f, "ToFloat");
+
+	byte buf[]	= { 0x12, 0x34, 0x56, 0x78 };
+	BufferView bv(buf, sizeof(buf));
+	assert(bv.ToUInt16() == 0x3412 && bv.ToUInt32(0, false) == 0x12345678, "ToUInt");
+	assert(bv.IndexOf(0x56) == 2 && bv.Sub(1, 2).Length() == 2, "BufferView");
+
+	String str	= "abc";
+	StringView("def").AppendTo(str);
+	assert(str == "abcdef", "AppendTo");
+}
+
+/******************************** +IPD解析 ********************************/
+
+static cstring _Ipd	= "+IPD,0,10,192.168.1.100,3377:0123456789";
+static int _Port;
+
+// 旧写法，每一段都构造字符串对象
+static void ParseString(void* param)
+{
+	String str	= _Ipd;
+	StringSplit sp(str, ",");
+	auto rs	= sp.Next();
+	rs	= sp.Next();
+	int idx	= rs.ToInt();
+	rs	= sp.Next();
+	int len	= rs.ToInt();
+	rs	= sp.Next();
+	auto ip	= IPAddress::Parse(rs);
+	sp.Sep	= ":";
+	rs	= sp.Next();
+	_Port	= rs.ToInt() + idx + len + ip[0];
+}
+
+// 视图写法
+static void ParseView(void* param)
+{
+	StringView sp	= _Ipd;
+	StringView rs;
+	sp.Split(",", rs);
+	sp.Split(",", rs);
+	int idx	= rs.ToInt();
+	sp.Split(",", rs);
+	int len	= rs.ToInt();
+	sp.Split(",", rs);
+	auto ip	= IPAddress::Parse(rs);
+	sp.Split(":", rs);
+	_Port	= rs.ToInt() + idx + len + ip[0];
+}
+
+// 在当前栈指针以下填充一段，执行后统计最大用量
+static uint StackCost(Action func)
+{
+	uint local	= 0;
+	auto top	= &local - 16;
+	auto bottom	= top - 0x100;
+	StackWatch::Paint(bottom, top);
+
+	func(nullptr);
+
+	return (top - StackWatch::Mark(bottom, top)) << 2;
+}
+
+static int TimeCostOf(Action func)
+{
+	TimeCost tc;
+	for(int i=0; i<100; i++) func(nullptr);
+
+	return tc.Elapsed();
+}
+
+void TestStringView()
+{
+	TS("TestStringView");
+
+	debug_printf("\r\n");
+	debug_printf("TestStringView Start......\r\n");
+
+	TestBasic();
+
+	ParseString(nullptr);
+	int p1	= _Port;
+	ParseView(nullptr);
+	assert(_Port == p1, "Parse");
+
+	uint s1	= StackCost(ParseString);
+	uint s2	= StackCost(ParseView);
+	int t1	= TimeCostOf(ParseString);
+	int t2	= TimeCostOf(ParseView);
+	debug_printf("解析+IPD 字符串：栈 %d 字节 100次 %dus 视图：栈 %d 字节 100次 %dus\r\n", s1, t1, s2, t2);
+
+	debug_printf("\r\n TestStringView Finish!\r\n");
+}
+#endif
@@ -0,0 +1,64 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Task.h"
+#include "Kernel\TaskTrace.h"
+#include "Kernel\WaitHandle.h"
+
+#if DEBUG
+
+static WaitHandle* _Handle;
+
+// 模拟一个耗时任务，饿死其它任务
+static void BusyTask(void* param)
+{
+	Sys.Delay(3000);
+}
+
+static void SetTask(void* param)
+{
+	if(_Handle) _Handle->Set();
+}
+
+void TestTaskTrace()
+{
+	TS("TestTaskTrace");
+
+	debug_printf("\r\n");
+	debug_printf("TestTaskTrace Start......\r\n");
+
+	TaskTrace::Start(64);
+	assert(TaskTrace::Running() && TaskTrace::Count() == 0, "Start");
+
+	WaitHandle handle;
+	_Handle	= &handle;
+
+	uint busy	= Sys.AddTask(BusyTask, nullptr, 0, 2, "忙碌");
+	Sys.AddTask(SetTask, nullptr, 20, -1, "设置");
+
+	// 新任务只在剩余时间超过500ms的等待里得到首次调度
+	bool rs	= handle.WaitOne(1000);
+	assert(rs, "WaitOne");
+	_Handle	= nullptr;
+
+	// 每次任务执行有开始和结束两条记录
+	int count	= TaskTrace::Count();
+	assert(count >= 5, "Count");
+
+	// 忙碌任务的调度延迟直方图
+	auto task	= Task::Get(busy);
+	if(task) task->ShowStatus();
+	Sys.RemoveTask(busy);
+
+	TaskTrace::Export();
+	assert(TaskTrace::Count() == 0, "Export");
+	TaskTrace::Stop();
+	assert(!TaskTrace::Running(), "Stop");
+
+	// 关闭后不再记录
+	TaskTrace::Record(TaskTrace::TaskBegin, 1);
+	assert(TaskTrace::Count() == 0, "Record");
+
+	debug_printf("记录 %d 条 丢弃 %d 条\r\n", count, TaskTrace::Drops);
+
+	debug_printf("\r\n TestTaskTrace Finish!\r\n");
+}
+#endif
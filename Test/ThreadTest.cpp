@@ -1,6 +1,14 @@
 ﻿#include "Kernel\Sys.h"
 #include "Device\Port.h"
 #include "Kernel\Thread.h"
+#include "Kernel\ThreadPool.h"
+#include "Kernel\TTime.h"
+
+// Cortex-M3/M4使用DWT周期计数器，M0没有DWT，使用系统时钟滴答
+#if defined(STM32F1) || defined(STM32F4)
+#include "Platform\stm32.h"
+#define USE_DWT 1
+#endif
 
 Thread* th;
 
@@ -33,3 +41,136 @@ void TestThread(OutputPort& leds)
 
     debug_printf("\r\n TestThread Finish!\r\n");
 }
+
+/******************************** 切换耗时 ********************************/
+
+static volatile byte _Done;
+static volatile int _Switches;
+static uint _Start;
+static uint _Cost;
+
+static uint Cycles()
+{
+#if USE_DWT
+	return DWT->CYCCNT;
+#else
+	return Time.CurrentTicks();
+#endif
+}
+
+// 两个最高优先级线程轮流让出时间片
+static void SwitchTask(void* param)
+{
+	int n = (int)param;
+	if(!_Start) _Start = Cycles();
+	for(int i = 0; i < n; i++)
+	{
+		_Switches++;
+		Thread::Switch();
+	}
+	if(++_Done == 2) _Cost = Cycles() - _Start;
+}
+
+// 陪跑线程，周期性睡眠，占据睡眠队列
+static void SleepTask(void* param)
+{
+	while(_Done < 2) Sys.Sleep(5);
+}
+
+static void BenchSwitch(int others)
+{
+	_Done = 0;
+	_Switches = 0;
+	_Start = 0;
+	_Cost = 0;
+
+	for(int i = 0; i < others; i++)
+	{
+		auto th = new Thread(SleepTask, nullptr, 0x100);
+		th->Name = "Sleep";
+		th->Start();
+	}
+
+	for(int i = 0; i < 2; i++)
+	{
+		auto th = new Thread(SwitchTask, (void*)500, 0x100);
+		th->Name = "Switch";
+		th->Priority = Thread::Highest;
+		th->Start();
+	}
+
+	while(_Done < 2) Sys.Sleep(10);
+
+#if USE_DWT
+	debug_printf("线程 %d 个，切换 %d 次，平均 %d 周期\r\n", Thread::Count, _Switches, _Cost / _Switches);
+#else
+	debug_printf("线程 %d 个，切换 %d 次，平均 %dns\r\n", Thread::Count, _Switches, Time.TicksToUs(_Cost) * 1000 / _Switches);
+#endif
+}
+
+// 测量上下文切换耗时，线程数增加时应当保持不变
+void TestThreadSwitch()
+{
+	debug_printf("\r\n");
+	debug_printf("TestThreadSwitch Start......\r\n");
+
+#if USE_DWT
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+	BenchSwitch(0);
+	BenchSwitch(8);
+
+	debug_printf("\r\n TestThreadSwitch Finish!\r\n");
+}
+
+/******************************** 线程池 ********************************/
+
+// 模拟耗时计算，结果写回工作项
+static void HeavyWork(void* param)
+{
+	auto item = (WorkItem*)param;
+	uint sum = 0;
+	for(int i = 0; i < 20000; i++) sum += i ^ (sum >> 3);
+	item->Result = (void*)sum;
+}
+
+static volatile int _Fires;
+static void FireWork(void* param) { _Fires++; }
+
+// 多个工作项同时投递，完成后逐个等待结果。空闲工作线程应当窃取其它队列的工作
+void TestThreadPool()
+{
+	debug_printf("\r\n");
+	debug_printf("TestThreadPool Start......\r\n");
+
+	ThreadPool pool(2);
+
+	WorkItem items[6];
+	for(int i = 0; i < 6; i++)
+	{
+		items[i].Callback = HeavyWork;
+		items[i].Param = &items[i];
+		bool rs = pool.Post(&items[i]);
+		assert(rs, "Post");
+	}
+
+	for(int i = 0; i < 6; i++)
+	{
+		bool rs = items[i].Wait(1000);
+		assert(rs, "Wait");
+		assert(items[i].Result, "Result");
+	}
+	assert(pool.Executed == 6, "Executed");
+
+	_Fires = 0;
+	for(int i = 0; i < 4; i++) Thread::QueueUserWorkItem(FireWork, nullptr);
+	while(_Fires < 4) Sys.Sleep(10);
+
+	pool.ShowStatus();
+	ThreadPool::Default()->ShowStatus();
+
+	debug_printf("\r\n TestThreadPool Finish!\r\n");
+}
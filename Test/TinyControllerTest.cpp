@@ -0,0 +1,206 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\TTime.h"
+#include "Core\Random.h"
+#include "Net\ITransport.h"
+#include "Message\BinaryPair.h"
+
+#include "TinyNet\TinyController.h"
+
+#if DEBUG
+
+// 模拟有损链路。按丢包率随机丢弃数据包，用于模拟NRF24L01/ShunCom等无线信道
+class LossyPort : public ITransport
+{
+public:
+	LossyPort*	Peer;	// 对端
+	int			Loss;	// 丢包率，百分比
+	uint		Drops;	// 丢弃包数
+
+	LossyPort() { Peer = nullptr; Loss = 0; Drops = 0; }
+
+private:
+	Random	Rnd;	// 只在构造时播种一次，否则同一秒内每包结果相同
+
+protected:
+	virtual bool OnWrite(const Buffer& bs)
+	{
+		if(!Peer) return false;
+
+		if(Rnd.Next(100) < Loss)
+		{
+			Drops++;
+			return true;
+		}
+
+		Buffer bs2((void*)bs.GetBuffer(), bs.Length());
+		Peer->OnReceive(bs2, nullptr);
+
+		return true;
+	}
+	virtual uint OnRead(Buffer& bs) { return 0; }
+};
+
+// 对端收到请求后马上响应
+static void OnPeerReceive(Message& msg, Controller& ctrl)
+{
+	if(msg.Reply) return;
+
+	ctrl.Reply(msg);
+}
+
+// 在有损链路上发送若干消息，统计完成时延和成功率
+static void TestLoss(int loss, int count)
+{
+	// 传输口在栈上，先于控制器定义，后于控制器销毁
+	LossyPort pa;
+	LossyPort pb;
+	pa.Peer	= &pb;
+	pb.Peer	= &pa;
+	pa.Loss	= loss;
+	pb.Loss	= loss;
+
+	TinyController ca;
+	ca.Address	= 0x01;
+	ca.Port		= &pa;
+	ca.Open();
+
+	TinyController cb;
+	cb.Address	= 0x02;
+	cb.Port		= &pb;
+	cb.Received	= OnPeerReceive;
+	cb.Open();
+
+	TimeCost tc;
+	for(int i=0; i<count; i++)
+	{
+		TinyMessage msg(0x05);
+		msg.Dest	= cb.Address;
+		msg.Length	= 4;
+		ca.Send(msg);
+
+		Sys.Sleep(ca.Interval);
+	}
+	// 等待所有消息完成或超时
+	Sys.Sleep(ca.Timeout * 2);
+
+	auto& st	= ca.Total;
+	int rate	= st.Msg ? st.Success * 100 / st.Msg : 0;
+	int cost	= st.Success ? st.Cost / st.Success : 0;
+	int retry	= st.Msg ? st.Send * 100 / st.Msg : 0;
+	debug_printf("丢包率 %d%% 成功=%d%% %d/%d 平均=%dms 次数=%d.%02d 超时=%d 挤出=%d 丢弃=%d 耗时=%dms\r\n", loss, rate, st.Success, st.Msg, cost, retry / 100, retry % 100, st.Expired, st.Evict, pa.Drops + pb.Drops, tc.Elapsed() / 1000);
+
+	// 控制器析构时会释放传输口，栈上的先摘下来
+	ca.Close();
+	cb.Close();
+	ca.Port	= nullptr;
+	cb.Port	= nullptr;
+}
+
+// 重复消息过滤
+static void TestWindow()
+{
+	SeqWindow win;
+
+	// 地址0的第一条消息不是重复
+	assert(!win.Check(0x00, 0x00), "SeqWindow 地址0");
+	assert(win.Check(0x00, 0x00), "SeqWindow 地址0重复");
+
+	// 请求和响应的序列号分开记录，交错也不会误判为对方重启
+	assert(!win.Check(0x05, 0x10), "SeqWindow 请求");
+	assert(!win.Check(0x05, 0xA0, true), "SeqWindow 响应");
+	assert(!win.Check(0x05, 0x11), "SeqWindow 请求");
+	assert(win.Check(0x05, 0x10), "SeqWindow 请求重传");
+	assert(win.Check(0x05, 0xA0, true), "SeqWindow 响应重传");
+	assert(win.Duplicates == 3, "SeqWindow Duplicates");
+}
+
+// 直接把数据交给控制器处理，不经过链路
+class FeedPort : public ITransport
+{
+public:
+	void Feed(Buffer& bs) { OnReceive(bs, nullptr); }
+
+protected:
+	virtual bool OnWrite(const Buffer& bs) { return true; }
+	virtual uint OnRead(Buffer& bs) { return 0; }
+};
+
+// 典型的业务处理，产生若干临时对象
+static void OnBench(Message& msg, Controller& ctrl)
+{
+	BinaryPair bp(msg.ToStream());
+	String name;
+	bp.Get("Name", name);
+
+	String str	= name;
+	for(int i=0; i<8; i++) str	+= ";Value=1234";
+
+	MemoryStream ms;
+	BinaryPair rs(ms);
+	rs.Set("Name", name);
+	rs.Set("Result", str);
+
+	ByteArray bs(ms.GetBuffer(), ms.Position());
+	assert(bs.Length() > str.Length(), "OnBench");
+}
+
+// 每秒处理消息数，对比有无内存区
+static void TestArena(bool arena, int count)
+{
+	FeedPort port;
+
+	TinyController ctrl;
+	ctrl.Address	= 0x01;
+	ctrl.Port		= &port;
+	ctrl.Received	= OnBench;
+	ctrl.UseArena	= arena;
+	ctrl.Open();
+
+	TinyMessage msg(0x10);
+	msg.Src		= 0x02;
+	msg.Dest	= ctrl.Address;
+	MemoryStream ds(msg.Data, msg.MaxDataSize());
+	BinaryPair bp(ds);
+	bp.Set("Name", String("SmartOS-Device"));
+	msg.Length	= ds.Position();
+
+	TimeCost tc;
+	for(int i=0; i<count; i++)
+	{
+		// 不同来源和序列号，避免被当作重复消息过滤
+		msg.Src	= 0x02 + (i & 0x3F);
+		msg.Seq	= i;
+
+		MemoryStream ms;
+		msg.Write(ms);
+		Buffer bs(ms.GetBuffer(), ms.Position());
+		port.Feed(bs);
+	}
+	int us	= tc.Elapsed();
+
+	int avg	= ctrl.ArenaMsgs ? ctrl.ArenaBytes / ctrl.ArenaMsgs : 0;
+	debug_printf("内存区=%d 消息=%d 耗时=%dus 每秒=%d 平均=%d字节 最大=%d字节\r\n", arena, count, us, us ? (int)((UInt64)count * 1000000 / us) : 0, avg, ctrl.ArenaMax);
+
+	ctrl.Close();
+	ctrl.Port	= nullptr;
+}
+
+void TestTinyController()
+{
+	TS("TestTinyController");
+
+	debug_printf("\r\n");
+	debug_printf("TestTinyController Start......\r\n");
+
+	TestWindow();
+
+	TestLoss(0, 50);
+	TestLoss(10, 50);
+	TestLoss(30, 50);
+
+	TestArena(false, 200);
+	TestArena(true, 200);
+
+	debug_printf("\r\n TestTinyController Finish!\r\n");
+}
+#endif
@@ -0,0 +1,110 @@
+﻿#include "Kernel\Sys.h"
+#include "Kernel\Task.h"
+#include "Kernel\WaitHandle.h"
+
+#if DEBUG
+static void TestSemaphore()
+{
+	Semaphore sem(1, 2);
+
+	auto err	= "bool TryWait()";
+
+	assert(sem.TryWait(), err);
+	assert(!sem.TryWait(), err);
+
+	// 释放超过最大计数时截断
+	sem.Release(3);
+	assert(sem.Count == 2, "int Release(int count = 1)");
+	assert(sem.Handle.Result, "int Release(int count = 1)");
+
+	assert(sem.Wait(0) && sem.Wait(0) && !sem.Wait(0), "bool Wait(int ms)");
+}
+
+static void TestAutoReset()
+{
+	AutoResetEvent ev;
+
+	assert(!ev.TryWait(), "bool TryWait()");
+	ev.Set();
+	assert(ev.TryWait(), "bool TryWait()");
+	// 自动清除，只放行一次
+	assert(!ev.TryWait(), "bool TryWait()");
+}
+
+static void TestChannel()
+{
+	Channel<int> ch(2);
+
+	auto err	= "bool TryWrite(T item)";
+
+	assert(ch.TryWrite(1) && ch.TryWrite(2), err);
+	assert(!ch.TryWrite(3), err);
+	assert(ch.CanRead.Result, err);
+
+	int v	= 0;
+	assert(ch.TryRead(v) && v == 1, "bool TryRead(T& item)");
+	// 环形缓冲区回绕
+	assert(ch.TryWrite(3), err);
+	assert(ch.TryRead(v) && v == 2, "bool TryRead(T& item)");
+	assert(ch.TryRead(v) && v == 3, "bool TryRead(T& item)");
+	assert(!ch.Read(v, 0), "bool Read(T& item, int ms = -1)");
+}
+
+// 调度器已达最大深度时，等待马上失败，不能空转
+static void TestDeep()
+{
+	auto sc	= Task::Scheduler();
+	auto dp	= sc->Deepth;
+	sc->Deepth	= sc->MaxDeepth;
+
+	assert(!WaitHandle::CanWait(), "static bool CanWait()");
+
+	Semaphore sem;
+	assert(!sem.Wait(-1), "bool Wait(int ms)");
+
+	Channel<int> ch(1);
+	int v	= 0;
+	assert(!ch.Read(v, -1), "bool Read(T& item, int ms = -1)");
+	assert(ch.TryWrite(1) && !ch.Write(2, -1), "bool Write(T item, int ms = -1)");
+
+	sc->Deepth	= dp;
+}
+
+static uint _Waiter;
+static int _Wakes;
+static void WakeTask(void* param) { _Wakes++; }
+
+static void TestISR()
+{
+	_Wakes	= 0;
+	_Waiter	= Sys.AddTask(WakeTask, nullptr, -1, -1, "延迟信号");
+
+	// 模拟中断里设置，调度器下一轮唤醒登记的任务
+	WaitHandle handle;
+	handle.Waiter	= _Waiter;
+	handle.SetISR();
+	assert(handle.Result, "void SetISR()");
+
+	bool cancel	= false;
+	Task::Scheduler()->Execute(0xFFFFFFFF, cancel);
+	assert(_Wakes == 1, "static void Flush()");
+
+	Sys.RemoveTask(_Waiter);
+}
+
+void TestWaitHandle()
+{
+	TS("TestWaitHandle");
+
+	debug_printf("\r\n");
+	debug_printf("TestWaitHandle Start......\r\n");
+
+	TestSemaphore();
+	TestAutoReset();
+	TestChannel();
+	TestDeep();
+	TestISR();
+
+	debug_printf("\r\n TestWaitHandle Finish!\r\n");
+}
+#endif
@@ -1,6 +1,7 @@
 ﻿#include "Tcp.h"
 
 #include "Kernel\WaitHandle.h"
+#include "Kernel\BinLog.h"
 
 #define NET_DEBUG 0
 //#define NET_DEBUG DEBUG
@@ -100,9 +101,8 @@ void TcpSocket::OnProcess(TCP_HEADER& tcp, Stream& ms)
 	uint ack = _REV(tcp.Ack);
 
 #if NET_DEBUG
-	debug_printf("Tcp::Process Flags=0x%02x Seq=0x%04x Ack=0x%04x From ", tcp.Flags, seq, ack);
-	Remote.Show();
-	debug_printf("\r\n");
+	auto ip = (byte*)&Remote.Address.Value;
+	log_printf("Tcp::Process Flags=0x%02x Seq=0x%04x Ack=0x%04x From %d.%d.%d.%d:%d\r\n", tcp.Flags, seq, ack, ip[0], ip[1], ip[2], ip[3], Remote.Port);
 #endif
 
 	// 下次主动发数据时，用该序列号，因为对方Ack确认期望下次得到这个序列号
@@ -295,7 +295,7 @@ bool TcpSocket::SendPacket(TCP_HEADER& tcp, uint len, byte flags)
 
 #if NET_DEBUG
 	uint hlen = tcp.Length << 2;
-	debug_printf("SendTcp: Flags=0x%02x Seq=0x%04x Ack=0x%04x Length=%d(0x%x) Payload=%d(0x%x) %d => %d \r\n", flags, _REV(tcp.Seq), _REV(tcp.Ack), hlen, hlen, len, len, _REV16(tcp.SrcPort), _REV16(tcp.DestPort));
+	log_printf("SendTcp: Flags=0x%02x Seq=0x%04x Ack=0x%04x Length=%d(0x%x) Payload=%d(0x%x) %d => %d \r\n", flags, _REV(tcp.Seq), _REV(tcp.Ack), hlen, hlen, len, len, _REV16(tcp.SrcPort), _REV16(tcp.DestPort));
 #endif
 
 	// 注意tcp->Size()包括头部的扩展数据
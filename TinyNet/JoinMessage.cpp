@@ -1,5 +1,30 @@
 ﻿#include "JoinMessage.h"
 
+#include "Message\Schema.h"
+
+// 请求：1版本+2类型+4会话+N编码
+static const FieldInfo _RequestFields[] =
+{
+	FIELD(JoinMessage, Version),
+	FIELD(JoinMessage, Kind),
+	FIELD(JoinMessage, TranID),
+	FIELD(JoinMessage, HardID),
+};
+static const Schema _Request(_RequestFields, ArrayLength(_RequestFields));
+
+// 响应：1网关+1通道+1速度+1节点地址+N密码+4会话+N网关编码
+static const FieldInfo _ReplyFields[] =
+{
+	FIELD(JoinMessage, Server),
+	FIELD(JoinMessage, Channel),
+	FIELD(JoinMessage, Speed),
+	FIELD(JoinMessage, Address),
+	FIELD(JoinMessage, Password),
+	FIELD(JoinMessage, TranID),
+	FIELD(JoinMessage, HardID),
+};
+static const Schema _Reply(_ReplyFields, ArrayLength(_ReplyFields));
+
 // 初始化消息，各字段为0
 JoinMessage::JoinMessage() : HardID(0x10), Password(0x08)
 {
@@ -16,47 +41,13 @@ JoinMessage::JoinMessage() : HardID(0x10), Password(0x08)
 // 从数据流中读取消息
 bool JoinMessage::Read(Stream& ms)
 {
-	if(!Reply)
-	{
-		Version	= ms.ReadByte();
-		Kind	= ms.ReadUInt16();
-		TranID	= ms.ReadUInt32();
-		HardID	= ms.ReadArray();
-	}
-	else
-	{
-		Server	= ms.ReadByte();
-		Channel	= ms.ReadByte();
-		Speed	= ms.ReadByte();
-		Address	= ms.ReadByte();
-		Password= ms.ReadArray();
-		TranID	= ms.ReadUInt32();
-		HardID	= ms.ReadArray();
-	}
-
-	return true;
+	return (Reply ? _Reply : _Request).Read(ms, this);
 }
 
 // 把消息写入数据流中
 void JoinMessage::Write(Stream& ms) const
 {
-	if(!Reply)
-	{
-		ms.Write(Version);
-		ms.Write(Kind);
-		ms.Write(TranID);
-		ms.WriteArray(HardID);
-	}
-	else
-	{
-		ms.Write(Server);
-		ms.Write(Channel);
-		ms.Write(Speed);
-		ms.Write(Address);
-		ms.WriteArray(Password);
-		ms.Write(TranID);
-		ms.WriteArray(HardID);
-	}
+	(Reply ? _Reply : _Request).Write(ms, this);
 }
 
 #if DEBUG
@@ -18,7 +18,7 @@ static void TinyClientTask(void* param);
 TinyClient::TinyClient(TinyController* control)
 {
 	Control = control;
-	Control->GetKey = Delegate2<byte, Buffer&>(&TinyClient::GetDeviceKey, this);
+	Control->GetKey = Delegate2<byte, Buffer&>(MethodOf(&TinyClient::GetDeviceKey), this);
 
 	Opened = false;
 	Joining = false;
@@ -35,7 +35,6 @@ TinyClient::TinyClient(TinyController* control)
 
 	_TaskID = 0;
 
-	NextReport = 0;
 	Encryption = false;
 }
 
@@ -44,7 +43,7 @@ void TinyClient::Open()
 	if (Opened) return;
 
 	// 使用另一个强类型参数的委托，事件函数里面不再需要做类型
-	Control->Received = Delegate2<TinyMessage&, TinyController&>(&TinyClient::OnReceive, this);
+	Control->Received = Delegate2<TinyMessage&, TinyController&>(MethodOf(&TinyClient::OnReceive), this);
 	//Control->Param		= this;
 
 	TranID = (int)Sys.Ms();
@@ -64,6 +63,10 @@ void TinyClient::Open()
 	Control->Mode = 0;	// 客户端只接收自己的消息
 	Control->Open();
 
+	// 单条上报不超过一个数据包，扣除消息头和偏移量
+	int max = Control->Port->MaxSize - TinyMessage::MinSize - 2;
+	if (max > 0) Reports.MaxSize = max;
+
 	int t = 5000;
 	if (Server) t = Cfg->PingTime * 1000;
 	if (t < 1000) t = 1000;
@@ -254,38 +257,63 @@ void TinyClient::ReportAsync(int offset, int length)
 	//if(this == nullptr) return;
 	if (offset + length >= Store.Data.Length()) return;
 
-	NextReport = offset;
-	ReportLength = length;
-	// 延迟200ms上报，期间有其它上报任务到来将会覆盖
-	Sys.SetTask(_TaskID, true, 200);
-}
+	// 合并到脏区，延迟预算到期或者攒够一条消息时批量上报
+	int ms = Reports.Set(offset, length);
+	if (ms < 0)
+	{
+		// 超出位图范围的直接上报
+		Report(offset, Buffer(&Store.Data[offset], length));
+		return;
+	}
 
-/******************************** 常用系统级消息 ********************************/
+	Sys.SetTask(_TaskID, true, ms);
+}
 
-void TinyClientTask(void* param)
+// 上报已到期的脏区，相邻区间合并为一条消息
+bool TinyClient::CheckReport()
 {
-	auto client = (TinyClient*)param;
-	int offset = client->NextReport;
-	int len = client->ReportLength;
-	assert(offset == 0 || offset < 0x10, "自动上报偏移量异常！");
+	TS("TinyClient::CheckReport");
+
+	auto& rp = Reports;
+	if (!rp.Any()) return false;
+
+	// 周期任务先于上报期限到来时，推迟到期限再上报
+	int ms = rp.Remain();
+	if (ms > 0)
+	{
+		Sys.SetTask(_TaskID, true, ms);
+		return false;
+	}
 
-	if (offset)
+	// 多段上报期间可能让出CPU，从快照读取，保证各段数据属于同一时刻
+	DataSnapshot snap(Store);
+	ByteArray bs;
+	int offset, len;
+	while (rp.Next(offset, len))
 	{
 		// 检查索引，否则数组越界
-		auto& bs = client->Store.Data;
-		if (bs.Length() > offset + len)
+		if (offset + len > snap.Length()) continue;
+
+		if (len == 1)
+			Report(offset, snap[offset]);
+		else
 		{
-			if (len == 1)
-				client->Report(offset, bs[offset]);
-			else
-			{
-				auto bs2 = ByteArray(&bs[offset], len);
-				client->Report(offset, bs2);
-			}
+			bs.SetLength(len);
+			snap.Read(offset, bs);
+			Report(offset, bs);
 		}
-		client->NextReport = 0;
-		return;
 	}
+
+	return true;
+}
+
+/******************************** 常用系统级消息 ********************************/
+
+void TinyClientTask(void* param)
+{
+	auto client = (TinyClient*)param;
+	if (client->CheckReport()) return;
+
 	if (client->Server == 0 || client->Joining) client->Join();
 	if (client->Server != 0) client->Ping();
 }
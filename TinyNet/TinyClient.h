@@ -7,6 +7,7 @@
 #include "TinyConfig.h"
 
 #include "Message\DataStore.h"
+#include "Message\ReportBatch.h"
 
 // 微网客户端
 class TinyClient
@@ -49,9 +50,9 @@ public:
 	bool Report(int offset, byte dat);
 	bool Report(int offset, const Buffer& bs);
 
-	int NextReport;	// 下次上报偏移，0不动
-	int ReportLength;	// 下次上报数据长度
+	ReportBatch	Reports;	// 待上报的脏区，合并后批量上报
 	void ReportAsync(int offset, int length = 1);
+	bool CheckReport();
 
 private:
 	uint _TaskID;
@@ -1,6 +1,29 @@
 ﻿#include "TinyConfig.h"
 #include "Config.h"
 
+#include "Message\Schema.h"
+
+// 压缩编码的字段描述，硬件软件版本和Mac之后才加入，作为可选字段
+static const FieldInfo _Fields[] =
+{
+	FIELD(TinyConfig, Length),
+	FIELD(TinyConfig, OfflineTime),
+	FIELD(TinyConfig, SleepTime),
+	FIELD(TinyConfig, PingTime),
+	FIELD(TinyConfig, Kind),
+	FIELD(TinyConfig, Address),
+	FIELD(TinyConfig, Server),
+	FIELD(TinyConfig, Channel),
+	FIELD_VAR(TinyConfig, Speed),
+	FIELD_VAR(TinyConfig, Interval),
+	FIELD_VAR(TinyConfig, Timeout),
+	FIELD(TinyConfig, Pass),
+	FIELD_EX(TinyConfig, HardVer, "HardVer", Schema::Optional),
+	FIELD_EX(TinyConfig, SoftVer, "SoftVer", Schema::Optional),
+	FIELD_EX(TinyConfig, Mac, "Mac", Schema::Optional),
+};
+static const Schema _TinySchema(_Fields, ArrayLength(_Fields));
+
 TinyConfig* TinyConfig::Current	= nullptr;
 
 TinyConfig::TinyConfig() : ConfigBase(),
@@ -9,6 +32,7 @@ TinyConfig::TinyConfig() : ConfigBase(),
 	_Name	= "TinyCfg";
 	_Start	= &Length;
 	_End	= &TagEnd;
+	_Schema	= &_TinySchema;
 
 	Init();
 }
@@ -1,13 +1,16 @@
 ﻿#include "Security\Crc.h"
 #include "Security\RC4.h"
 
+#include "Kernel\Task.h"
+#include "Kernel\BinLog.h"
+
 #include "TinyConfig.h"
 #include "TinyController.h"
 
 //#define MSG_DEBUG DEBUG
 #define MSG_DEBUG 0
 #if MSG_DEBUG
-	#define msg_printf debug_printf
+	#define msg_printf log_printf
 #else
 	#define msg_printf(format, ...)
 #endif
@@ -16,6 +19,9 @@
 void SendTask(void* param);
 void StatTask(void* param);
 
+// 统计计数。接收可能在中断里，发送在任务里，递增要原子
+static inline void StatAdd(uint& v, int n = 1) { AtomicAdd((volatile int*)&v, n); }
+
 // 构造控制器
 TinyController::TinyController() : Controller()
 {
@@ -57,7 +63,11 @@ TinyController::TinyController() : Controller()
 
 	_taskID		= 0;
 	_Queue		= nullptr;
+	_Head		= nullptr;
 	QueueLength	= 8;
+	MaxInflight	= 2;
+
+	Buffer(_Rtt, sizeof(_Rtt)).Clear();
 
 	// 默认屏蔽心跳日志
 	Buffer(NoLogCodes, sizeof(NoLogCodes)).Clear();
@@ -121,6 +131,7 @@ void TinyController::Open()
 	_Queue	= new MessageNode[QueueLength];
 	//Buffer(_Queue, sizeof(*_Queue)).Clear();
 	Buffer(_Queue, sizeof(MessageNode) * QueueLength).Clear();
+	_Head	= nullptr;
 
 	if(!_taskID)
 	{
@@ -150,62 +161,19 @@ void TinyController::ShowMessage(const TinyMessage& msg, bool send, const ITrans
 	if(obj)
 	  name	= obj->ToString();
 
-	msg_printf("%s", name.GetBuffer());
-#endif
-	int blank = 6;
+	cstring act;
 	if(send && !msg.Reply)
-	{
-		msg_printf("::Send ");
-		blank -= 5;
-	}
-	else
-	{
-		msg_printf("::");
-	}
-
-	if(msg.Error)
-	{
-		msg_printf("Error ");
-		blank -= 6;
-	}
-	else if(msg.Ack)
-	{
-		msg_printf("Ack ");
-		blank -= 4;
-	}
+		act	= "Send";
+	else if(msg.Error)
+		act	= "Error";
 	else if(msg.Reply)
-	{
-		msg_printf("Reply ");
-		blank -= 6;
-	}
-	else if(!send)
-	{
-		msg_printf("Recv ");
-		blank -= 5;
-	}
-	if(blank > 0)
-	{
-		String str(' ', blank);
-		str.Show();
-	}
+		act	= "Reply";
+	else
+		act	= "Recv";
 
-#if MSG_DEBUG
-	// 显示目标地址
-	auto st	= msg.State;
-	if(st)
-	{
-		msg_printf("Mac=");
-		if(name == "R24")
-			ByteArray(st, 5).Show();
-		else if(name == "ShunCom")
-			ByteArray(st, 2).Show();
-		else
-			ByteArray(st, 6).Show();
-		msg_printf(" ");
-	}
+	// 字段直接作为参数记录，不在这里格式化
+	msg_printf("%s::%s 0x%02X => 0x%02X Code=0x%02X Seq=0x%02X Retry=%d Len=%d\r\n", name.GetBuffer(), act, msg.Src, msg.Dest, msg.Code, msg.Seq, msg.Retry, msg.Length);
 #endif
-
-	msg.Show();
 }
 
 //加密。组网不加密，退网不加密
@@ -283,9 +251,8 @@ bool TinyController::Valid(const Message& _msg)
 		// Ack的包有可能重复，不做处理。正式响应包跟前面的Ack有相同的源地址和序列号
 		if(!msg.Ack)
 		{
-			// 处理重复消息。加上来源地址，以免重复
-			ushort seq = (msg.Src << 8) | msg.Seq;
-			if(_Ring.Check(seq))
+			// 处理重复消息。按来源地址分别记录，以免重复
+			if(Window.Check(msg.Src, msg.Seq, msg.Reply))
 			{
 				// 对方可能多次发同一个请求过来，都要做响应
 				if(!msg.Reply && AckResponse(msg)) return false;
@@ -293,7 +260,6 @@ bool TinyController::Valid(const Message& _msg)
 				//msg_printf("重复消息 Src=0x%02x Code=0x%02X Seq=0x%02X Retry=%d Reply=%d Ack=%d\r\n", msg.Src, msg.Code, msg.Seq, msg.Retry, msg.Reply, msg.Ack);
 				return false;
 			}
-			_Ring.Push(seq);
 		}
 	}
 
@@ -335,7 +301,7 @@ bool TinyController::Valid(const Message& _msg)
 	ShowMessage(msg, false, Port);
 #endif
 
-	Total.Receive++;
+	StatAdd(Total.Receive);
 
 	return true;
 }
@@ -348,17 +314,31 @@ void TinyController::AckRequest(const TinyMessage& msg)
 	for(int i=0; i<QueueLength; i++)
 	{
 		auto& node = _Queue[i];
-		if(node.Using && node.Seq == msg.Seq)
+		if(node.Using && node.Seq == msg.Seq && node.Times > 0)
 		{
 			int cost = (int)(Sys.Ms() - node.StartTime);
 			if(cost < 0) cost = -cost;
 
-			Total.Cost	+= cost;
-			Total.Success++;
-			Total.Bytes	+= node.Length;
+			StatAdd(Total.Cost, cost);
+			StatAdd(Total.Success);
+			StatAdd(Total.Bytes, node.Length);
+
+			// 只发送一次就得到确认的消息，往返时间才是准确的
+			if(node.Times == 1)
+			{
+				auto rtt	= FindRtt(node.Dest(), true);
+				if(rtt) rtt->Update(cost);
+			}
 
 			// 该传输口收到响应，从就绪队列中删除
-			node.Using = 0;
+			{
+				SmartIRQ irq;
+				Dequeue(&node);
+				node.Using = 0;
+			}
+
+			// 同一目标可能有请求因为在途限制而等待，马上调度
+			if(MaxInflight) Sys.SetTask(_taskID, true, 0);
 
 			/*if(msg.Ack)
 				msg_printf("收到确认 ");
@@ -373,8 +353,7 @@ void TinyController::AckRequest(const TinyMessage& msg)
 #if MSG_DEBUG
 	if(msg.Ack)
 	{
-		msg_printf("无效确认 ");
-		ShowMessage(msg, false, Port);
+		msg_printf("无效确认 0x%02X => 0x%02X Code=0x%02X Seq=0x%02X\r\n", msg.Src, msg.Dest, msg.Code, msg.Seq);
 	}
 #endif
 }
@@ -394,7 +373,11 @@ bool TinyController::AckResponse(const TinyMessage& msg)
 		if(node.Using && node.Seq == msg.Seq)
 		{
 			// 马上重发这条响应
-			node.Next	= 0;
+			{
+				SmartIRQ irq;
+				node.Next	= 0;
+				Enqueue(&node);
+			}
 
 			Sys.SetTask(_taskID, true, 0);
 
@@ -459,13 +442,13 @@ bool TinyController::Broadcast(TinyMessage& msg)
 
 	if(!Port->Open()) return false;
 
-	Total.Broadcast++;
+	StatAdd(Total.Broadcast);
 
 	return Controller::SendInternal(msg);
 }
 
 // 放入发送队列，超时之前，如果对方没有响应，会重复发送，-1表示采用系统默认超时时间Timeout
-bool TinyController::Post(const TinyMessage& msg, int msTimeout)
+bool TinyController::Post(const TinyMessage& msg, int msTimeout, Priorities priority)
 {
 	TS("TinyController::Post");
 
@@ -476,31 +459,50 @@ bool TinyController::Post(const TinyMessage& msg, int msTimeout)
 	// 如果确定不需要响应，则改用Post
 	if(msTimeout <= 0 || msg.NoAck || msg.Ack)
 	{
-		Total.Broadcast++;
+		StatAdd(Total.Broadcast);
 		return Controller::SendInternal(msg);
 	}
 
 	// 针对Zigbee等不需要Ack确认的通道
 	if(Timeout < 0)
 	{
-		Total.Broadcast++;
+		StatAdd(Total.Broadcast);
 		return Controller::SendInternal(msg);
 	}
 
+	// 自动分类。响应、组网和读写指令优先，心跳等上报其次，广播最后
+	if(priority == Auto)
+	{
+		if(msg.Reply)
+			priority	= Control;
+		else if(msg.Dest == 0)
+			priority	= Bulk;
+		else if(msg.Code == 0x03)
+			priority	= Report;
+		else
+			priority	= Control;
+	}
+
 	// 准备消息队列
 	auto now	= Sys.Ms();
 	int idx		= -1;
+	int victim	= -1;
 	for(int i=0; i<QueueLength; i++)
 	{
 		auto& node = _Queue[i];
 		// 未使用，或者即使使用也要抢走已过期的节点
 		if(!node.Using || node.EndTime < now)
 		{
-			node.Seq	= 0;
-			node.Using	= 1;
 			idx	= i;
 			break;
 		}
+		// 记录优先级最低的节点，队列满时挤掉它
+		if(node.Priority > priority && (victim < 0 || node.Priority > _Queue[victim].Priority)) victim = i;
+	}
+	if(idx < 0 && victim >= 0)
+	{
+		idx	= victim;
+		StatAdd(Total.Evict);
 	}
 	// 队列已满
 	if(idx < 0)
@@ -509,12 +511,21 @@ bool TinyController::Post(const TinyMessage& msg, int msTimeout)
 		return false;
 	}
 
-	_Queue[idx].Set(msg, msTimeout);
+	auto& node	= _Queue[idx];
+	{
+		SmartIRQ irq;
+		Dequeue(&node);
+		node.Seq	= 0;
+		node.Using	= 1;
+		node.Set(msg, msTimeout);
+		node.Priority	= priority;
+		Enqueue(&node);
+	}
 
 	if(msg.Reply)
-		Total.Reply++;
+		StatAdd(Total.Reply);
 	else
-		Total.Msg++;
+		StatAdd(Total.Msg);
 
 	Sys.SetTask(_taskID, true, 0);
 
@@ -542,45 +553,57 @@ void TinyController::Loop()
 
 	/*
 	队列机制：
-	1，定时发送请求消息，直到被响应消去或者超时
-	2，发送一次响应消息，直到超时，中途有该序列的请求则直接重发响应
-	3，不管请求还是响应，同样方式处理超时，响应的下一次时间特别长
-	4，如果某个请求序列对应的响应存在，则直接将其下一次时间置为0，让其马上重发
+	1，重发队列按下一次发送时间排序，每次只处理已到期的头部节点，然后按新的头部时间安排下一次调度
+	2，定时发送请求消息，直到被响应消去或者超时。重发间隔根据目标的往返时间自适应调整
+	3，发送一次响应消息，直到超时，中途有该序列的请求则直接重发响应
+	4，同一目标在途请求数受MaxInflight限制，超出的请求延后首次发送
 	5，发送响应消息，不好统计速度和成功率
 	6，发送次数不允许超过5次
 	*/
 
-	int count = 0;
-	for(int i=0; i<QueueLength; i++)
+	UInt64 now = Sys.Ms();
+	MessageNode* p;
+	while((p = Pop(now)) != nullptr)
 	{
-		auto& node = _Queue[i];
-		if(!node.Using || node.Seq == 0) continue;
+		auto& node = *p;
 
 		auto flag = (TFlags*)&node.Data[3];
 		bool reply	= flag->_Reply;
-		// 可用请求消息数，需要继续轮询
-		if(!reply) count++;
 
 		// 检查时间。至少发送一次
 		if(node.Times > 0)
 		{
-			UInt64 now = Sys.Ms();
-
 			// 已过期则删除
-			if(node.EndTime < now || node.Times > 50)
+			if(node.EndTime <= now || node.Times > 50)
 			{
 				//if(!reply) msg_printf("消息过期 Dest=0x%02X Seq=0x%02X Times=%d\r\n", node.Data[0], node.Seq, node.Times);
+				if(!reply) StatAdd(Total.Expired);
 				node.Using	= 0;
 				node.Seq	= 0;
 
 				continue;
 			}
 
-			// 下一次发送时间还没到，跳过
-			if(node.Next > now) continue;
-
 			//msg_printf("重发消息 Dest=0x%02X Seq=0x%02X Times=%d\r\n", node.Data[0], node.Seq, node.Times + 1);
 		}
+		// 首次发送的请求，目标在途请求太多时延后
+		else if(!reply && MaxInflight && node.Dest() && Inflight(node.Dest()) >= MaxInflight)
+		{
+			// 等待期间已过期，不再发送
+			if(node.EndTime <= now)
+			{
+				StatAdd(Total.Expired);
+				node.Using	= 0;
+				node.Seq	= 0;
+
+				continue;
+			}
+
+			node.Next	= now + Interval;
+			if(node.Next > node.EndTime) node.Next = node.EndTime;
+			Requeue(&node);
+			continue;
+		}
 
 		node.Times++;
 
@@ -602,7 +625,7 @@ void TinyController::Loop()
 		if(!reply)
 		{
 			// 增加发送次数统计
-			Total.Send++;
+			StatAdd(Total.Send);
 
 			// 分组统计
 			if(Total.Send >= 1000)
@@ -612,23 +635,151 @@ void TinyController::Loop()
 			}
 		}
 
-		// 计算下一次重发时间
+		// 计算下一次重发时间。响应消息只等待过期，中途有请求再重发
+		now	= Sys.Ms();
+		if(!reply)
+			node.Next	= now + GetInterval(node.Dest());
+		else
+			node.Next	= node.EndTime;
+		if(node.Next > node.EndTime) node.Next = node.EndTime;
+
+		Requeue(&node);
+	}
+
+	Schedule();
+}
+
+// 按时间顺序插入重发队列。时间相同时优先级高者在前，已在队列中的先移除
+// 收到确认可能在中断里处理，链表操作都要关中断
+void TinyController::Enqueue(MessageNode* node)
+{
+	SmartIRQ irq;
+
+	Dequeue(node);
+
+	auto pp	= &_Head;
+	while(*pp)
+	{
+		auto cur	= *pp;
+		if(node->Next < cur->Next || (node->Next == cur->Next && node->Priority < cur->Priority)) break;
+		pp	= &cur->Link;
+	}
+	node->Link	= *pp;
+	*pp			= node;
+}
+
+// 从重发队列中移除
+void TinyController::Dequeue(MessageNode* node)
+{
+	SmartIRQ irq;
+
+	for(auto pp = &_Head; *pp; pp = &(*pp)->Link)
+	{
+		if(*pp == node)
 		{
-			UInt64 now	= Sys.Ms();
-			//node.LastSend	= now;
-
-			// 随机延迟。随机数1~5。每次延迟递增
-			//byte rnd	= (uint)now % 3;
-			//node.Next	= now + (rnd + 1) * Interval;
-			if(!reply)
-				node.Next	= now + Interval;
-			else
-				node.Next	= now + 60000;
+			*pp			= node->Link;
+			node->Link	= nullptr;
+			return;
 		}
 	}
+}
+
+// 取出已到期的头部节点
+MessageNode* TinyController::Pop(UInt64 now)
+{
+	SmartIRQ irq;
+
+	auto node	= _Head;
+	if(!node || node->Next > now) return nullptr;
+
+	_Head		= node->Link;
+	node->Link	= nullptr;
+
+	return node;
+}
+
+// 发送后放回重发队列。发送期间可能已被确认消去，不再放回
+void TinyController::Requeue(MessageNode* node)
+{
+	SmartIRQ irq;
+
+	if(node->Using) Enqueue(node);
+}
+
+// 按重发队列头部时间安排下一次调度，没有待发消息时停止
+void TinyController::Schedule()
+{
+	bool any;
+	UInt64 next	= 0;
+	{
+		SmartIRQ irq;
+		any	= _Head != nullptr;
+		if(any) next = _Head->Next;
+	}
+	if(!any)
+	{
+		Sys.SetTask(_taskID, false);
+		return;
+	}
+
+	// 直接修改下一次执行时间，而不是按固定间隔轮询整个队列
+	auto task	= Task::Get(_taskID);
+	if(task)
+	{
+		task->Enable	= true;
+		task->NextTime	= next;
+	}
+}
+
+// 指定目标已发出但未确认的请求数
+int TinyController::Inflight(byte dest) const
+{
+	int count	= 0;
+	for(int i=0; i<QueueLength; i++)
+	{
+		auto& node = _Queue[i];
+		if(node.Using && node.Times > 0 && node.Dest() == dest && !node.IsReply()) count++;
+	}
+
+	return count;
+}
+
+TinyRtt* TinyController::FindRtt(byte dest, bool create)
+{
+	if(!dest) return nullptr;
+
+	TinyRtt* old	= nullptr;
+	for(int i=0; i<ArrayLength(_Rtt); i++)
+	{
+		auto& rtt	= _Rtt[i];
+		if(rtt.Address == dest) return &rtt;
+
+		// 空位或者最久没有采样的记录，用于新建
+		if(!old || !rtt.Address || (old->Address && rtt.Last < old->Last)) old = &rtt;
+	}
+	if(!create) return nullptr;
+
+	old->Address	= dest;
+	old->Srtt		= 0;
+	old->Rttvar		= 0;
+	old->Last		= 0;
+
+	return old;
+}
+
+// 指定目标的自适应重发间隔。还没有采样时使用默认间隔Interval
+int TinyController::GetInterval(byte dest)
+{
+	auto rtt	= FindRtt(dest, false);
+	if(!rtt || !rtt->Srtt) return Interval;
+
+	int ms	= rtt->RetryInterval();
+	// 不能太快导致信道拥塞，也不能超过超时时间的一半而失去重发机会
+	if(ms < (Interval >> 1)) ms = Interval >> 1;
+	if(Timeout > 0 && ms > (Timeout >> 1)) ms = Timeout >> 1;
+	if(ms < 1) ms = 1;
 
-	// 没有可用请求时，停止轮询
-	if(count == 0) Sys.SetTask(_taskID, false);
+	return ms;
 }
 
 // 显示统计信息
@@ -659,11 +810,40 @@ void TinyController::ShowStat() const
 	uint retry	= 0;
 	if(tmsg > 0)
 		retry	= tsend * 100 / tmsg;
-	msg_printf("Tiny::State 成功=%d%% %d/%d/%d 平均=%dms 速度=%d Byte/s 次数=%d.%02d 接收=%d 响应=%d 广播=%d \r\n", rate, tack, tmsg, tsend, cost, speed, retry/100, retry%100, Last.Receive + Total.Receive, Last.Reply + Total.Reply, Last.Broadcast + Total.Broadcast);
+	msg_printf("Tiny::State 成功=%d%% %d/%d/%d 平均=%dms 速度=%d Byte/s 次数=%d.%02d 接收=%d 响应=%d 广播=%d 重复=%d \r\n", rate, tack, tmsg, tsend, cost, speed, retry/100, retry%100, Last.Receive + Total.Receive, Last.Reply + Total.Reply, Last.Broadcast + Total.Broadcast, Window.Duplicates);
 #endif
 }
 
+/*================================ 往返时间 ================================*/
+// 按RFC6298的方法平滑往返时间，避免个别慢速节点拖累整个网络的重发节奏
+void TinyRtt::Update(int rtt)
+{
+	if(rtt < 1) rtt = 1;
+	if(rtt > 0xFFFF) rtt = 0xFFFF;
+
+	if(!Srtt)
+	{
+		Srtt	= rtt;
+		Rttvar	= rtt >> 1;
+	}
+	else
+	{
+		int err	= rtt - Srtt;
+		if(err < 0) err = -err;
+		// Rttvar = 3/4 * Rttvar + 1/4 * |err|，Srtt = 7/8 * Srtt + 1/8 * rtt
+		Rttvar	= (Rttvar * 3 + err) >> 2;
+		Srtt	= (Srtt * 7 + rtt) >> 3;
+		if(!Srtt) Srtt = 1;
+	}
+	Last	= Sys.Ms();
+}
+
 /*================================ 信息节点 ================================*/
+bool MessageNode::IsReply() const
+{
+	return ((TFlags*)&Data[3])->_Reply;
+}
+
 void MessageNode::Set(const TinyMessage& msg, int msTimeout)
 {
 	Times		= 0;
@@ -673,9 +853,9 @@ void MessageNode::Set(const TinyMessage& msg, int msTimeout)
 	StartTime	= now;
 	EndTime		= now + msTimeout;
 
-	Next		= 0;
-	// 响应消息只发一次，然后长时间等待
-	if(msg.Reply) Next	= now + 60000;
+	// 请求和响应都马上发送第一次，响应之后只等待过期
+	Next		= now;
+	Link		= nullptr;
 
 	// 注意，此时指针位于0，而内容长度为缓冲区长度
 	Stream ms(Data, ArrayLength(Data));
@@ -693,52 +873,100 @@ void MessageNode::Set(const TinyMessage& msg, int msTimeout)
 	Seq			= msg.Seq;
 }
 
-/*================================ 环形队列 ================================*/
-RingQueue::RingQueue()
+/*================================ 序列号窗口 ================================*/
+SeqWindow::SeqWindow()
 {
-	Index	= 0;
-	Buffer(Arr, sizeof(Arr)).Clear();
-	Expired	= 0;
+	Capacity	= 32;
+	Size		= 32;
+	Expire		= 10000;
+	Duplicates	= 0;
+
+	_Arr	= nullptr;
 }
 
-void RingQueue::Push(ushort item)
+SeqWindow::~SeqWindow()
 {
-	Arr[Index++] = item;
-	if(Index == ArrayLength(Arr)) Index = 0;
+	delete[] _Arr;
+	_Arr	= nullptr;
+}
 
-	// 更新过期时间，10秒
-	Expired = Sys.Ms() + 10000;
+void SeqWindow::Clear()
+{
+	if(_Arr) Buffer(_Arr, sizeof(Entry) * Capacity).Clear();
 }
 
-int RingQueue::Find(ushort item) const
+// 检查并记录序列号。类似IPsec防重放窗口，但落后太多的序列号视为对方重启，重新开始
+bool SeqWindow::Check(byte src, byte seq, bool reply)
 {
-	for(int i=0; i < ArrayLength(Arr); i++)
+	if(!Capacity) return false;
+
+	if(!_Arr)
 	{
-		if(Arr[i] == item) return i;
+		_Arr	= new Entry[Capacity];
+		Clear();
 	}
+	if(Size < 1 || Size > 32) Size = 32;
 
-	return -1;
-}
+	auto& et	= _Arr[src % Capacity];
+	auto now	= (ushort)(Sys.Ms() >> 10);
 
-bool RingQueue::Check(ushort item)
-{
-	// Expired为0说明还没有添加任何项
-	if(!Expired) return false;
+	// 新来源、被其它地址占用，或者很长时间都没有收到消息，重新开始
+	if(!et.Used || et.Src != src || (ushort)(now - et.Time) > (Expire >> 10))
+	{
+		et.Src	= src;
+		et.Used	= 0;
+	}
+	et.Time	= now;
 
-	// 首先检查是否过期。如果已过期，说明很长时间都没有收到消息
-	if(Expired < Sys.Ms())
+	int k		= reply ? 1 : 0;
+	auto& last	= et.Last[k];
+	auto& bits	= et.Bits[k];
+
+	// 该方向第一条消息
+	if(!(et.Used & (1 << k)))
+	{
+		et.Used	|= 1 << k;
+		last	= seq;
+		bits	= 1;
+
+		return false;
+	}
+
+	// 序列号前进，窗口滑动
+	byte diff	= seq - last;
+	if(diff == 0)
 	{
-		//msg_printf("环形队列过期，清空 \r\n");
-		// 清空队列，重新开始
-		Index	= 0;
-		Buffer(Arr, sizeof(Arr)).Clear();
-		Expired	= 0;
+		Duplicates++;
+		return true;
+	}
+	if(diff < 0x80)
+	{
+		bits	= diff < Size ? (bits << diff) | 1 : 1;
+		last	= seq;
 
 		return false;
 	}
 
-	// 再检查是否存在
-	return Find(item) >= 0;
+	// 序列号落后，在窗口内则检查位图
+	byte back	= last - seq;
+	if(back < Size)
+	{
+		uint bit	= 1u << back;
+		if(bits & bit)
+		{
+			Duplicates++;
+			return true;
+		}
+		bits	|= bit;
+
+		return false;
+	}
+
+	// 落后超出窗口，一般是对方重启，序列号重新开始
+	last	= seq;
+	bits	= 1;
+
+	return false;
 }
 
 TinyStat::TinyStat()
@@ -6,19 +6,35 @@
 #include "TinyMessage.h"
 
 
-// 环形队列。记录收到消息的序列号，防止短时间内重复处理消息
-class RingQueue
+// 序列号滑动窗口。按来源地址记录最近收到的序列号位图，常数时间判断重复消息，防止短时间内重复处理消息
+class SeqWindow
 {
 public:
-	int		Index;
-	ushort	Arr[32];
-	UInt64	Expired;	// 过期时间，微秒
+	ushort	Capacity;	// 来源容量。按地址取模索引，网关设为256可覆盖全部地址，默认32
+	byte	Size;		// 窗口大小，1~32，默认32
+	ushort	Expire;		// 过期时间ms。来源超过该时间没有消息则重新开始，默认10000
+	uint	Duplicates;	// 已过滤的重复消息数
 
-	RingQueue();
-	void	Push(ushort item);
-	int		Find(ushort item) const;
+	SeqWindow();
+	~SeqWindow();
 
-	bool	Check(ushort item);
+	// 检查并记录序列号。返回是否重复消息
+	// 请求用对方的序列号，响应回显我方的序列号，两者分开记录
+	bool Check(byte src, byte seq, bool reply = false);
+	void Clear();
+
+private:
+	// 每个来源的窗口，下标0为请求，1为响应
+	typedef struct
+	{
+		byte	Src;	// 来源地址
+		byte	Used;	// 已使用的窗口，位0请求，位1响应。0表示整项未使用
+		ushort	Time;	// 最后收到时间，单位1024ms
+		byte	Last[2];// 最大序列号
+		uint	Bits[2];// 位图。第n位表示序列号Last-n已收到
+	} Entry;
+
+	Entry*	_Arr;		// 首次使用时分配
 };
 
 // 统计信息
@@ -33,6 +49,8 @@ public:
 	uint	Receive;// 收到消息数
 	uint	Reply;	// 发出的响应
 	uint	Broadcast;	// 广播
+	uint	Expired;// 超时未确认的消息数
+	uint	Evict;	// 队列满时被高优先级消息挤出的消息数
 
 	TinyStat();
 	
@@ -42,6 +60,20 @@ public:
 	void Clear();
 };
 
+// 往返时间估算。按目标地址记录平滑往返时间，用于计算自适应重发间隔
+class TinyRtt
+{
+public:
+	byte	Address;	// 目标地址，0表示未使用
+	ushort	Srtt;		// 平滑往返时间ms
+	ushort	Rttvar;		// 往返时间偏差ms
+	UInt64	Last;		// 最后一次采样时间ms，淘汰时使用
+
+	void Update(int rtt);
+	// 重发间隔。平滑往返时间加上4倍偏差
+	int RetryInterval() const { return Srtt + (Rttvar << 2); }
+};
+
 class MessageNode;
 
 // 消息控制器。负责发送消息、接收消息、分发消息
@@ -49,13 +81,24 @@ class TinyController : public Controller
 {
 private:
 	MessageNode*	_Queue;	// 消息队列。允许多少个消息同时等待响应
+	MessageNode*	_Head;	// 重发队列头部。按下一次发送时间排序，时间相同时优先级高者在前
+	TinyRtt			_Rtt[8];// 往返时间表
 
-	RingQueue	_Ring;		// 环形队列
 	uint		_taskID;	// 发送队列任务
 
 	void AckRequest(const TinyMessage& msg);	// 处理收到的Ack包
 	bool AckResponse(const TinyMessage& msg);	// 向对方发出Ack包
 
+	void Enqueue(MessageNode* node);	// 按时间顺序插入重发队列
+	void Dequeue(MessageNode* node);	// 从重发队列中移除
+	MessageNode* Pop(UInt64 now);		// 取出已到期的头部节点
+	void Requeue(MessageNode* node);	// 发送后放回重发队列，已被确认消去的不再放回
+	void Schedule();					// 按重发队列头部时间安排下一次调度
+	int Inflight(byte dest) const;		// 指定目标已发出但未确认的请求数
+
+	TinyRtt* FindRtt(byte dest, bool create);
+	int GetInterval(byte dest);			// 指定目标的自适应重发间隔
+
 protected:
 	virtual bool Dispatch(Stream& ms, Message* pmsg, void* param);
 	// 收到消息校验后调用该函数。返回值决定消息是否有效，无效消息不交给处理器处理
@@ -67,6 +110,7 @@ public:
 	ushort	Interval;	// 队列发送间隔，默认10ms
 	short	Timeout;	// 队列发送超时，默认50ms。如果不需要超时重发，那么直接设置为-1
 	byte	QueueLength;// 队列长度，默认8
+	byte	MaxInflight;// 每个目标同时在途的请求数，默认2。0表示不限制
 
 	byte	NoLogCodes[8];	// 没有日志的指令
 
@@ -83,8 +127,17 @@ public:
 	// 广播消息，不等待响应和确认
 	bool Broadcast(TinyMessage& msg);
 
+	// 发送优先级。数字越小越优先，队列满时可挤出低优先级消息
+	typedef enum
+	{
+		Control = 0,	// 控制指令。组网、读写以及响应
+		Report,			// 数据上报、心跳
+		Bulk,			// 广播等批量消息
+		Auto = 0xFF		// 根据消息自动分类
+	} Priorities;
+
 	// 放入发送队列，超时之前，如果对方没有响应，会重复发送
-	bool Post(const TinyMessage& msg, int msTimeout = -1);
+	bool Post(const TinyMessage& msg, int msTimeout = -1, Priorities priority = Auto);
 
 	// 循环处理待发送的消息队列
 	void Loop();
@@ -98,6 +151,8 @@ public:
 	TinyStat	Total;	// 总统计
 	TinyStat	Last;	// 最后一次统计
 
+	SeqWindow	Window;	// 重复消息过滤窗口
+
 private:
 	// 显示统计信息
 	void ShowStat() const;
@@ -113,12 +168,17 @@ public:
 	byte	Seq;		// 序列号
 	byte	Length;
 	byte	Times;		// 发送次数
+	byte	Priority;	// 优先级
 	byte	Data[64];
 	byte	Mac[6];		// 物理地址
 	UInt64	StartTime;	// 开始时间ms
 	UInt64	EndTime;	// 过期时间ms
 	UInt64	Next;		// 下一次重发时间ms
 	//UInt64	LastSend;	// 最后一次发送时间ms
+	MessageNode*	Link;	// 重发队列中的下一个节点
+
+	byte Dest() const { return Data[0]; }
+	bool IsReply() const;
 
 	void Set(const TinyMessage& msg, int msTimeout);
 };
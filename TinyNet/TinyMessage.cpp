@@ -2,11 +2,12 @@
 
 #include "TinyMessage.h"
 #include "Security\RC4.h"
+#include "Kernel\BinLog.h"
 
 //#define MSG_DEBUG DEBUG
 #define MSG_DEBUG 0
 #if MSG_DEBUG
-	#define msg_printf debug_printf
+	#define msg_printf log_printf
 #else
 	#define msg_printf(format, ...)
 #endif
@@ -130,6 +131,45 @@ void TinyMessage::Write(Stream& ms) const
 	ms.Write(Checksum);
 }
 
+// 头部写入预留空间，负载和校验码只引用，Crc分段累加
+bool TinyMessage::Write(BufferChain& bc) const
+{
+	assert(Code, "微网指令码不能为空");
+	assert(Src, "微网源地址不能为空");
+	if(Src == Dest) return true;
+
+	TS("TinyMessage::WriteChain");
+
+	ushort len	= Length;
+	// 实际数据拷贝到占位符
+	auto p = (TinyMessage*)this;
+	p->_Code	= Code;
+	p->_Length	= (byte)len;
+	p->_Reply	= Reply;
+	p->_Error	= Error;
+
+	auto buf	= bc.Prepend(HeaderSize);
+	if(!buf) return false;
+	Buffer::Copy(buf, &Dest, HeaderSize);
+
+	// 计算Crc之前，需要清零TTL和Retry
+	byte fs		= buf[3];
+	auto flag	= (TFlags*)&buf[3];
+	flag->Retry	= 0;
+
+	ushort crc	= Crc::Hash16(Buffer(buf, HeaderSize));
+	if(len > 0) crc	= Crc::Hash16(Buffer(Data, len), crc);
+	p->Checksum = p->Crc = crc;
+
+	// 还原数据
+	buf[3] = fs;
+
+	if(!bc.Add(Data, len)) return false;
+
+	// 校验码引用消息自己的字段，发送完成前消息不会销毁
+	return bc.Add(&Checksum, sizeof(Checksum));
+}
+
 // 验证消息校验码是否有效
 bool TinyMessage::Valid() const
 {
@@ -45,6 +45,8 @@ public:
 	virtual bool Read(Stream& ms);
 	// 写入指定数据流
 	virtual void Write(Stream& ms) const;
+	// 写入分段缓冲区，负载和校验码只引用
+	virtual bool Write(BufferChain& bc) const;
 
 	// 验证消息校验码是否有效
 	virtual bool Valid() const;
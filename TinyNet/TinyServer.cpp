@@ -23,8 +23,8 @@ TinyServer::TinyServer(TinyController* control)
 	Cfg			= nullptr;
 	DeviceType	= Sys.Code;
 
-	Control->Received	= Delegate2<TinyMessage&, TinyController&>(&TinyServer::OnReceive, this);
-	Control->GetKey		= Delegate2<byte, Buffer&>(&TinyServer::GetDeviceKey, this);
+	Control->Received	= Delegate2<TinyMessage&, TinyController&>(MethodOf(&TinyServer::OnReceive), this);
+	Control->GetKey		= Delegate2<byte, Buffer&>(MethodOf(&TinyServer::GetDeviceKey), this);
 	//Control->Param		= this;
 
 	Control->Mode		= 2;	// 服务端接收所有消息
@@ -0,0 +1,132 @@
+﻿#include "ChannelSelector.h"
+
+/******************************** ChannelStat ********************************/
+
+ChannelStat::ChannelStat()
+{
+	Up	= false;
+	Reset();
+}
+
+void ChannelStat::Reset()
+{
+	Rtt			= 0;
+	Loss		= 0;
+	Miss		= 0;
+	Pending		= 0;
+	Waiting		= false;
+	LastReply	= 0;
+}
+
+// 发出请求
+void ChannelStat::OnRequest()
+{
+	if(Pending < 0xFF) Pending++;
+}
+
+// 收到响应
+void ChannelStat::OnReply()
+{
+	if(Pending) Pending--;
+	LastReply	= Sys.Ms();
+}
+
+// 心跳周期开始。上一次心跳还没有响应时计一次丢包
+void ChannelStat::OnHeartbeat()
+{
+	int sample	= 0;
+	if(Waiting)
+	{
+		sample	= 100;
+		if(Miss < 0xFF) Miss++;
+
+		// 一直没有响应的请求，也不再计入排队深度
+		Pending	= 0;
+	}
+	// 丢包率 = 3/4 * 丢包率 + 1/4 * 样本
+	Loss	= (Loss * 3 + sample) >> 2;
+
+	Waiting	= true;
+}
+
+// 收到心跳响应，采样往返时间
+void ChannelStat::OnPing(int cost)
+{
+	if(cost < 1) cost = 1;
+
+	if(Rtt)
+		Rtt	= (Rtt * 3 + cost) >> 2;
+	else
+		Rtt	= cost;
+
+	Waiting	= false;
+	Miss	= 0;
+
+	OnReply();
+}
+
+// 综合评分，越小越好。往返时间为主，丢包和排队按比例加权
+int ChannelStat::Score() const
+{
+	if(!Up) return 0x7FFFFFFF;
+
+	// 没有采样的通道给一个保守值，避免刚建立就抢走主通道
+	int rtt	= Rtt ? Rtt : 1000;
+
+	// 每1%丢包相当于增加3%的时间，每个排队请求相当于增加半个往返时间
+	int score	= rtt + rtt * Loss * 3 / 100 + (rtt >> 1) * Pending;
+	// 连续丢失心跳的通道严重降级
+	if(Miss) score	+= 10000 * Miss;
+
+	return score;
+}
+
+/******************************** ChannelSelector ********************************/
+
+ChannelSelector::ChannelSelector()
+{
+	Current		= -1;
+	Hysteresis	= 25;
+	MaxMiss		= 1;
+	Switches	= 0;
+}
+
+// 从一组通道中选择最佳通道，返回索引
+int ChannelSelector::Select(ChannelStat* const* stats, int count)
+{
+	int best	= -1;
+	int min		= 0x7FFFFFFF;
+	for(int i=0; i<count; i++)
+	{
+		if(!stats[i] || !stats[i]->Up) continue;
+
+		int score	= stats[i]->Score();
+		if(best < 0 || score < min)
+		{
+			best	= i;
+			min		= score;
+		}
+	}
+
+	int cur	= Current;
+	if(cur >= count) cur = -1;
+
+	// 当前通道不可用，或者连续丢失心跳，马上切换
+	bool fail	= cur < 0 || !stats[cur] || !stats[cur]->Up || stats[cur]->Miss >= MaxMiss;
+	if(!fail && best >= 0 && best != cur)
+	{
+		// 新通道必须明显更好才切换
+		Int64 score	= stats[cur]->Score();
+		if((Int64)min * (100 + Hysteresis) >= score * 100) best = cur;
+	}
+	// 没有更好的选择时保持不变
+	if(best < 0) best = cur;
+
+	if(best != Current)
+	{
+		if(Current >= 0 && best >= 0) Switches++;
+		Current	= best;
+	}
+
+	return best;
+}
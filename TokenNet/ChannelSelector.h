@@ -0,0 +1,50 @@
+﻿#ifndef __ChannelSelector_H__
+#define __ChannelSelector_H__
+
+#include "Kernel\Sys.h"
+
+// 通道统计。记录一条上行通道的往返时间、丢包率和排队深度
+class ChannelStat
+{
+public:
+	bool	Up;			// 通道是否可用。网卡已连接并且控制器已打开
+	int		Rtt;		// 平滑往返时间ms，来自心跳延迟，0表示还没有采样
+	byte	Loss;		// 平滑丢包率，百分比。按心跳是否得到响应计算
+	byte	Miss;		// 连续未响应的心跳数
+	byte	Pending;	// 已发出还未响应的请求数
+	bool	Waiting;	// 心跳已发出还未响应
+	UInt64	LastReply;	// 最后收到响应时间ms
+
+	ChannelStat();
+
+	void Reset();
+
+	// 发出请求
+	void OnRequest();
+	// 收到响应
+	void OnReply();
+	// 心跳周期开始。上一次心跳还没有响应时计一次丢包
+	void OnHeartbeat();
+	// 收到心跳响应，采样往返时间
+	void OnPing(int cost);
+
+	// 综合评分，越小越好。不可用的通道返回最大值
+	int Score() const;
+};
+
+// 通道选择器。根据通道统计在多条上行通道中选择最佳者，带迟滞避免来回切换
+class ChannelSelector
+{
+public:
+	int		Current;	// 当前通道索引，-1表示没有
+	byte	Hysteresis;	// 切换门槛，百分比。新通道评分好于当前通道该比例才切换，默认25
+	byte	MaxMiss;	// 当前通道连续丢失心跳达到该次数时马上切换，默认1
+	int		Switches;	// 切换次数
+
+	ChannelSelector();
+
+	// 从一组通道中选择最佳通道，返回索引
+	int Select(ChannelStat* const* stats, int count);
+};
+
+#endif
@@ -107,7 +107,7 @@ void Gateway::Start()
 
 	Running = true;
 
-	Client->Register("Gateway/Study", &Gateway::InvokeStudy, this);
+	Client->Register("Gateway/Study", MethodOf(&Gateway::InvokeStudy), this);
 }
 
 // 停止网关。取消本地和远程的消息挂载
@@ -1,5 +1,28 @@
 ﻿#include "LoginMessage.h"
-#include "Message\BinaryPair.h"
+#include "Message\Schema.h"
+
+static const FieldInfo _RequestFields[] =
+{
+	FIELD_EX(LoginMessage, User, "UserName", 0),
+	FIELD_EX(LoginMessage, Pass, "Password", 0),
+	FIELD_EX(LoginMessage, Cookie, "Cookie", Schema::Optional),
+	FIELD_EX(LoginMessage, Salt, "Salt", Schema::Optional),
+};
+static const Schema _Request(_RequestFields, ArrayLength(_RequestFields));
+
+static const FieldInfo _ReplyFields[] =
+{
+	FIELD(LoginMessage, Token),
+	FIELD_EX(LoginMessage, Key, "Key", Schema::Optional),
+};
+static const Schema _Reply(_ReplyFields, ArrayLength(_ReplyFields));
+
+static const FieldInfo _ErrorFields[] =
+{
+	FIELD(LoginMessage, ErrorCode),
+	FIELD(LoginMessage, ErrorMessage),
+};
+static const Schema _Error(_ErrorFields, ArrayLength(_ErrorFields));
 
 // 初始化消息，各字段为0
 LoginMessage::LoginMessage() : Key(0)
@@ -9,45 +32,23 @@ LoginMessage::LoginMessage() : Key(0)
 // 从数据流中读取消息
 bool LoginMessage::Read(Stream& ms)
 {
-	BinaryPair bp(ms);
 	if (!Reply)
-	{
-		bp.Get("UserName", User);
-		bp.Get("Password", Pass);
-		bp.Get("Salt", Salt);
-		// bp.Get("VisitToken", VisitToken);
-	}
+		_Request.ReadPair(ms, this);
 	else if (!Error)
-	{
-		bp.Get("Token", Token);
-		//bp.Get("Password", Pass);
-		bp.Get("Key", Key);
-	}
+		_Reply.ReadPair(ms, this);
 	else
-	{
-		bp.Get("ErrorCode", ErrorCode);
-		bp.Get("ErrorMessage", ErrorMessage);
-	}
+		_Error.ReadPair(ms, this);
+
 	return false;
 }
 
 // 把消息写入数据流中
 void LoginMessage::Write(Stream& ms) const
 {
-	BinaryPair bp(ms);
-
 	if (!Reply)
-	{
-		bp.Set("UserName", User);
-		bp.Set("Password", Pass);
-		if(Cookie.Length())	bp.Set("Cookie", Cookie);
-		if(Salt.Length())	bp.Set("Salt", Salt);
-	}
+		_Request.WritePair(ms, this);
 	else if (!Error)
-	{
-		bp.Set("Token", Token);
-		if(Key.Length())	bp.Set("Key", Key);
-	}
+		_Reply.WritePair(ms, this);
 }
 
 #if DEBUG
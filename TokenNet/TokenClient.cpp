@@ -4,6 +4,7 @@
 #include "Net\Socket.h"
 #include "Net\NetworkInterface.h"
 
+#include "Core\Intern.h"
 #include "Message\BinaryPair.h"
 
 #include "TokenClient.h"
@@ -24,7 +25,6 @@ TokenClient* TokenClient::Current = nullptr;
 //static void BroadcastHelloTask(void* param);
 
 TokenClient::TokenClient()
-	: Routes(String::Compare)
 {
 	Token = 0;
 
@@ -40,11 +40,15 @@ TokenClient::TokenClient()
 	Master = nullptr;
 	Cfg = nullptr;
 
+	Bonding = false;
+	Redundant = false;
+
 	Received = nullptr;
 	Param = nullptr;
 
-	NextReport = -1;
-	ReportLength = 0;
+	// 上行带宽充足，单条上报可以覆盖更大的数据区
+	Reports.Delay = 100;
+	Reports.MaxSize = 128;
 
 	_Expect = nullptr;
 
@@ -76,6 +80,13 @@ void TokenClient::Close()
 	Sys.RemoveTask(_task);
 	//Sys.RemoveTask(_taskBroadcast);
 
+	auto& us = Uplinks;
+	for (int i = 0; i < us.Count(); i++)
+	{
+		if (us[i] != Master) delete us[i];
+	}
+	us.Clear();
+
 	if (Master)
 	{
 		delete Master;
@@ -92,11 +103,39 @@ void TokenClient::Close()
 	Opened = false;
 }
 
+// 查找建立在指定网卡上的上行通道
+static TokenController* FindUplink(const List<TokenController*>& us, NetworkInterface* ni)
+{
+	for (int i = 0; i < us.Count(); i++)
+	{
+		if (us[i]->_Socket->Host == ni) return us[i];
+	}
+
+	return nullptr;
+}
+
 static TokenController* AddMaster(TokenClient& client)
 {
+	// 多通道时，已有的上行通道直接提升为主通道，不在同一网卡上重复创建
+	auto& us = client.Uplinks;
+	for (int i = 0; i < us.Count(); i++)
+	{
+		auto ctrl = us[i];
+		if (ctrl->Opened && ctrl->_Socket->Host->Linked)
+		{
+			client.Master = ctrl;
+			return ctrl;
+		}
+	}
+
 	auto uri = client.Cfg->Uri();
-	// 创建连接服务器的Socket
-	auto socket = Socket::CreateRemote(uri);
+	// 创建连接服务器的Socket，跳过已有上行通道的网卡
+	Socket* socket = nullptr;
+	auto& nis = NetworkInterface::All;
+	for (int k = 0; k < nis.Count() && !socket; k++)
+	{
+		if (!FindUplink(us, nis[k])) socket = nis[k]->CreateRemote(uri);
+	}
 	if (!socket) return nullptr;
 
 	// 创建连接服务器的控制器
@@ -130,6 +169,9 @@ static TokenController* AddControl(TokenClient& client, NetworkInterface* host,
 
 void TokenClient::CheckNet()
 {
+	// 多通道时优先切换到其它可用通道，不必重新握手
+	if (Bonding) CheckUplinks();
+
 	auto mst = Master;
 	auto& cs = Controls;
 	//assert(cs.Count() > 0, "令牌客户端还没设置控制器呢");
@@ -152,6 +194,7 @@ void TokenClient::CheckNet()
 		linked = false;
 		debug_printf("TokenClient::CheckNet %s断开，切换主连接\r\n", mst->_Socket->Host->Name);
 
+		Uplinks.Remove(mst);
 		delete mst;
 		Master = nullptr;
 
@@ -169,7 +212,7 @@ void TokenClient::CheckNet()
 	mst = Master;
 	if (!linked && mst)
 	{
-		Delegate2<TokenMessage&, TokenController&> dlg(&TokenClient::OnReceive, this);
+		Delegate2<TokenMessage&, TokenController&> dlg(MethodOf(&TokenClient::OnReceive), this);
 		mst->Received = dlg;
 		mst->Open();
 
@@ -224,10 +267,96 @@ void TokenClient::CheckNet()
 	}
 }
 
+// 检查上行通道。在其它已连接网卡上建立通道，并按链路质量选择主通道
+void TokenClient::CheckUplinks()
+{
+	TS("TokenClient::CheckUplinks");
+
+	// 主通道由CheckNet创建
+	auto mst = Master;
+	if (!mst) return;
+
+	auto& us = Uplinks;
+	if (us.FindIndex(mst) < 0) us.Add(mst);
+
+	// 移除已经断开的备用通道，主通道由CheckNet处理。倒序，因为可能有删除
+	for (int i = us.Count() - 1; i >= 0; i--)
+	{
+		auto ctrl = us[i];
+		auto ni = ctrl->_Socket->Host;
+		if (ctrl == mst || (ctrl->Opened && ni->Active() && ni->Linked)) continue;
+
+		debug_printf("TokenClient::CheckUplinks %s 断开，移除上行通道\r\n", ni->Name);
+
+		us.RemoveAt(i);
+		delete ctrl;
+	}
+
+	// 在其它已连接网卡上建立到服务器的通道
+	auto& nis = NetworkInterface::All;
+	for (int k = 0; k < nis.Count(); k++)
+	{
+		auto ni = nis[k];
+		if (!ni->Active() || !ni->Linked) continue;
+		if (FindUplink(us, ni)) continue;
+
+		auto socket = ni->CreateRemote(Cfg->Uri());
+		if (!socket) continue;
+
+		auto ctrl = new TokenController();
+		ctrl->_Socket = socket;
+		ctrl->Received = Delegate2<TokenMessage&, TokenController&>(MethodOf(&TokenClient::OnReceive), this);
+		ctrl->Open();
+		us.Add(ctrl);
+
+		debug_printf("TokenClient::CheckUplinks %s 创建上行通道\r\n", ni->Name);
+	}
+
+	// 更新通道可用状态。备用通道各自握手登录，登录成功前不参与选择
+	ChannelStat* stats[8];
+	int count = us.Count();
+	if (count > ArrayLength(stats)) count = ArrayLength(stats);
+	for (int i = 0; i < count; i++)
+	{
+		auto ctrl = us[i];
+		bool linked = ctrl->Opened && ctrl->_Socket->Host->Linked;
+		if (ctrl != mst)
+		{
+			// 主通道登录以后，备用通道才能用同一账号登录
+			if (linked && !ctrl->Token && Status >= 2) SayHello(false, ctrl);
+			linked = linked && ctrl->Token;
+		}
+		ctrl->Channel.Up = linked;
+		stats[i] = &ctrl->Channel;
+	}
+
+	Selector.Current = us.FindIndex(mst);
+	int idx = Selector.Select(stats, count);
+	if (idx >= 0 && us[idx] != mst) SetMaster(us[idx]);
+}
+
+// 切换主通道。备用通道已经用自己的令牌和密码登录，切换后不必重新握手
+void TokenClient::SetMaster(TokenController* ctrl)
+{
+	auto mst = Master;
+	if (ctrl == mst) return;
+
+	debug_printf("TokenClient::SetMaster %s => %s\r\n", mst ? mst->_Socket->Host->Name : "", ctrl->_Socket->Host->Name);
+
+	if (ctrl->Token) Token = ctrl->Token;
+	Master = ctrl;
+}
+
+// 是否备用上行通道
+bool TokenClient::IsStandby(TokenController* ctrl) const
+{
+	return Bonding && ctrl && ctrl != Master && Uplinks.FindIndex(ctrl) >= 0;
+}
+
 // 启用内网功能。必须显式调用，否则内网功能不参与编译链接，以减少大小
 void TokenClient::UseLocal()
 {
-	_LocalReceive = Delegate2<TokenMessage&, TokenController&>(&TokenClient::OnReceiveLocal, this);
+	_LocalReceive = Delegate2<TokenMessage&, TokenController&>(MethodOf(&TokenClient::OnReceiveLocal), this);
 }
 
 bool TokenClient::Send(TokenMessage& msg, TokenController* ctrl)
@@ -246,7 +375,20 @@ bool TokenClient::Send(TokenMessage& msg, TokenController* ctrl)
 	// 最后发送仅统计主控制器
 	if (ctrl == Master) LastSend = Sys.Ms();
 
-	return ctrl->Send(msg);
+	bool rs = ctrl->Send(msg);
+
+	// 关键消息同时从其它可用通道发送。序列号相同，对方按序列号去重
+	if (Redundant && ctrl == Master && !msg.Reply && (msg.Code == 0x06 || msg.Code == 0x08))
+	{
+		auto& us = Uplinks;
+		for (int i = 0; i < us.Count(); i++)
+		{
+			auto uc = us[i];
+			if (uc != ctrl && uc->Channel.Up) rs |= uc->Send(msg);
+		}
+	}
+
+	return rs;
 }
 
 bool TokenClient::Reply(TokenMessage& msg, TokenController* ctrl)
@@ -448,7 +590,7 @@ void TokenClient::LoopTask()
 // 请求：2版本 + S类型 + S名称 + 8本地时间 + 6本地IP端口 + S支持加密算法列表
 // 响应：2版本 + S类型 + S名称 + 8本地时间 + 6对方IP端口 + 1加密算法 + N密钥
 // 错误：0xFE + 1协议 + S服务器 + 2端口
-void TokenClient::SayHello(bool broadcast)
+void TokenClient::SayHello(bool broadcast, TokenController* ctrl)
 {
 	TS("TokenClient::SayHello");
 
@@ -498,7 +640,7 @@ void TokenClient::SayHello(bool broadcast)
 		}
 	}
 	else
-		Send(msg);
+		Send(msg, ctrl);
 }
 
 // 握手响应
@@ -513,6 +655,17 @@ bool TokenClient::OnHello(TokenMessage& msg, TokenController* ctrl)
 	ext.ReadMessage(msg);
 	ext.Show(true);
 
+	// 备用通道各自握手登录，不影响主通道状态
+	if (IsStandby(ctrl))
+	{
+		if (msg.Error) return false;
+
+		if (ext.Key.Length() > 0) ctrl->Key.Copy(0, ext.Key, 0, ext.Key.Length());
+		if (Cfg->User()) Login(ctrl);
+
+		return true;
+	}
+
 	// 如果收到响应，并且来自来源服务器
 	if (msg.Error)
 	{
@@ -668,7 +821,7 @@ void TokenClient::OnRegister(TokenMessage& msg, TokenController* ctrl)
 }
 
 // 登录
-void TokenClient::Login()
+void TokenClient::Login(TokenController* ctrl)
 {
 	TS("TokenClient::Login");
 
@@ -696,7 +849,7 @@ void TokenClient::Login()
 	login.WriteMessage(msg);
 	login.Show(true);
 
-	Send(msg);
+	Send(msg, ctrl);
 }
 
 bool TokenClient::OnLogin(TokenMessage& msg, TokenController* ctrl)
@@ -711,6 +864,15 @@ bool TokenClient::OnLogin(TokenMessage& msg, TokenController* ctrl)
 	logMsg.ReadMessage(msg);
 	logMsg.Show(true);
 
+	// 备用通道只记录自己的令牌和密码
+	if (IsStandby(ctrl))
+	{
+		ctrl->Token = logMsg.Error ? 0 : logMsg.Token;
+		if (!logMsg.Error && logMsg.Key.Length()) ctrl->Key = logMsg.Key;
+
+		return !logMsg.Error;
+	}
+
 	if (logMsg.Error)
 	{
 		// 登录失败，清空令牌
@@ -812,6 +974,24 @@ void TokenClient::Ping()
 		return;
 	}
 
+	// 备用通道每个心跳周期都要探测，用于测量往返时间和丢包，主通道失效时能在一个心跳内切换
+	if (Bonding)
+	{
+		TokenPingMessage pm;
+		TokenMessage msg(3);
+		pm.WriteMessage(msg);
+
+		auto& us = Uplinks;
+		for (int i = 0; i < us.Count(); i++)
+		{
+			auto ctrl = us[i];
+			if (ctrl == Master || !ctrl->Channel.Up) continue;
+
+			ctrl->Channel.OnHeartbeat();
+			ctrl->Send(msg);
+		}
+	}
+
 	// 30秒内发过数据，不再发送心跳
 	if (LastSend > 0 && LastSend + 60000 > Sys.Ms()) return;
 
@@ -821,6 +1001,7 @@ void TokenClient::Ping()
 	TokenMessage msg(3);
 	pm.WriteMessage(msg);
 
+	Master->Channel.OnHeartbeat();
 	Send(msg);
 }
 
@@ -835,6 +1016,11 @@ bool TokenClient::OnPing(TokenMessage& msg, TokenController* ctrl)
 
 	int cost = (int)(DateTime::Now().TotalMs() - pm.LocalTime);
 
+	if (ctrl) ctrl->Channel.OnPing(cost);
+
+	// 心跳延迟仅统计主通道
+	if (ctrl && ctrl != Master) return true;
+
 	if (Delay)
 		Delay = (Delay + cost) / 2;
 	else
@@ -922,32 +1108,51 @@ void TokenClient::ReportAsync(int start, uint length)
 		return;
 	}
 
-	NextReport = start;
-	ReportLength = length;
+	// 合并到脏区，延迟预算到期或者攒够一条消息时批量上报
+	int ms = Reports.Set(start, length);
+	if (ms < 0)
+	{
+		// 超出位图范围的直接上报
+		Write(start, Buffer(&Store.Data[start], length));
+		return;
+	}
 
-	// 延迟上报，期间有其它上报任务到来将会覆盖
-	Sys.SetTask(_task, true, 20);
+	Sys.SetTask(_task, true, ms);
 }
 
 bool TokenClient::CheckReport()
 {
 	TS("TokenClient::CheckReport");
 
-	auto offset = NextReport;
-	int len = ReportLength;
+	auto& rp = Reports;
+	if (!rp.Any()) return false;
 
-	if (offset < 0) return false;
+	// 周期任务先于上报期限到来时，推迟到期限再上报
+	int ms = rp.Remain();
+	if (ms > 0)
+	{
+		Sys.SetTask(_task, true, ms);
+		return false;
+	}
 
-	// 检查索引，否则数组越界
-	auto& bs = Store.Data;
-	if (bs.Length() >= offset + len)
+	// 多段上报期间可能让出CPU，从快照读取，保证各段数据属于同一时刻
+	DataSnapshot snap(Store);
+	ByteArray bs;
+	int offset, len;
+	while (rp.Next(offset, len))
 	{
+		// 检查索引，否则数组越界
+		if (offset + len > snap.Length()) continue;
+
 		if (len == 1)
-			Write(offset, bs[offset]);
+			Write(offset, snap[offset]);
 		else
-			Write(offset, Buffer(&bs[offset], len));
+		{
+			bs.SetLength(len);
+			snap.Read(offset, bs);
+			Write(offset, bs);
+		}
 	}
-	NextReport = -1;
 
 	return true;
 }
@@ -1143,34 +1348,36 @@ void TokenClient::OnInvoke(const TokenMessage& msg, TokenController* ctrl)
 
 bool TokenClient::OnInvoke(const String& action, const Pair& args, Stream& result)
 {
+	// 先换成驻留指针，未驻留的动作肯定没有注册
+	auto key = Intern::Find(action.GetBuffer(), action.Length());
+	if (!key) return false;
 
-	IDelegate* dlg = nullptr;
-	if (!Routes.TryGetValue(action.GetBuffer(), dlg) || !dlg) return false;
+	void* handler = nullptr;
+	if (!Routes.TryGetValue(key, handler) || !handler) return false;
 
-	auto inv = (InvokeHandler)dlg->Method;
+	void* param = nullptr;
+	Params.TryGetValue(key, param);
 
-	return inv(dlg->Target, args, result);
+	auto inv = (InvokeHandler)handler;
+
+	return inv(param, args, result);
 }
 
 void TokenClient::Register(cstring action, InvokeHandler handler, void* param)
 {
+	// 处理器和参数分别存放，不需要为每个路由申请委托对象
+	// 动作名称驻留后作为键，调用时按指针匹配
 	if (handler)
 	{
-		auto dlg = new IDelegate();
-		dlg->Method = (void*)handler;
-		dlg->Target = param;
-
-		Routes.Add(action, dlg);
+		auto key = Intern::Static(action);
+		Routes.Add(key, (void*)handler);
+		Params.Add(key, param);
 	}
 	else
 	{
-		IDelegate* dlg = nullptr;
-		if (Routes.TryGetValue(action, dlg))
-		{
-			delete dlg;
-
-			Routes.Remove(action);
-		}
+		auto key = Intern::Find(action);
+		Routes.Remove(key);
+		Params.Remove(key);
 	}
 }
 
@@ -9,6 +9,7 @@
 #include "TokenNet\TokenController.h"
 
 #include "Message\DataStore.h"
+#include "Message\ReportBatch.h"
 #include "Message\Pair.h"
 
 // 微网客户端
@@ -29,10 +30,17 @@ public:
 
 	TokenController*		Master;		// 主通道
 	List<TokenController*>	Controls;	// 从通道
+
+	// 多通道绑定。在每个已连接网卡上建立到服务器的上行通道，按链路质量选择主通道
+	bool	Bonding;	// 是否启用多通道，默认false
+	bool	Redundant;	// 关键消息（写入、调用）同时从所有可用上行通道发送，默认false
+	List<TokenController*>	Uplinks;	// 上行通道集合，包含主通道
+	ChannelSelector			Selector;	// 通道选择器
 	IList					Sessions;	// 会话集合
 	TokenConfig*	Cfg;
 	DataStore	Store;	// 数据存储区
-	Dictionary<cstring, IDelegate*>	Routes;	// 路由集合
+	Dictionary<cstring, void*>	Routes;	// 路由集合，键为驻留名称，值为InvokeHandler
+	Dictionary<cstring, void*>	Params;	// 参数集合，键为驻留名称
 
 	TokenClient();
 
@@ -55,13 +63,13 @@ public:
 
 	// 常用系统级消息
 	// 握手广播
-	void SayHello(bool broadcast);
+	void SayHello(bool broadcast, TokenController* ctrl = nullptr);
 
 	// 注册
 	void Register();
 
-	// 登录
-	void Login();
+	// 登录。指定通道时只登录该通道，用于备用上行通道
+	void Login(TokenController* ctrl = nullptr);
 	// 重置并上报
 	void Reset(const String& reason);
 	void Reboot(const String& reason);
@@ -78,20 +86,15 @@ public:
 
 	// 必须满足 start > 0 才可以。
 	void ReportAsync(int start, uint length = 1);
+	ReportBatch	Reports;	// 待上报的脏区，合并后批量上报
 
 	// 远程调用
 	void Invoke(const String& action, const Buffer& bs);
 
 	// 远程调用委托。传入参数名值对以及结果缓冲区引用，业务失败时返回false并把错误信息放在结果缓冲区
 	typedef bool(*InvokeHandler)(void* param, const Pair& args, Stream& result);
-	// 注册远程调用处理器
+	// 注册远程调用处理器。成员函数用MethodOf(&T::Func)
 	void Register(cstring action, InvokeHandler handler, void* param = nullptr);
-	// 模版支持成员函数
-	template<typename T>
-	void Register(cstring action, bool(T::*func)(const Pair&, Stream&), T* target)
-	{
-		Register(action, *(InvokeHandler*)&func, target);
-	}
 
 	static TokenClient* Current;
 
@@ -135,12 +138,12 @@ private:
 
 	Delegate2<Message&, Controller&>	_LocalReceive;
 
-	int		NextReport = -1;	// 下次上报偏移，-1不动
-	byte	ReportLength;	// 下次上报数据长度
-
 	void LoopTask();
 	bool CheckReport();
 	void CheckNet();
+	void CheckUplinks();
+	void SetMaster(TokenController* ctrl);
+	bool IsStandby(TokenController* ctrl) const;
 };
 
 #endif
@@ -1,5 +1,7 @@
 ﻿#include "TokenController.h"
 
+#include "Kernel\BinLog.h"
+
 #include "Net\Socket.h"
 #include "Security\RC4.h"
 #include "Security\Crc.h"
@@ -210,6 +212,7 @@ bool TokenController::OnReceive(Message& msg)
 
 	if (msg.Reply)
 	{
+		Channel.OnReply();
 	}
 	else
 	{
@@ -285,6 +288,26 @@ bool TokenController::Send(Message& msg)
 	// 如果没有传输口处于打开状态，则发送失败
 	if (!Port->Open()) return false;
 
+	if (!msg.Reply && !msg.OneWay) Channel.OnRequest();
+
+	// 握手不加密
+	bool plain = msg.Code <= 0x01 || Key.Length() == 0;
+
+	// 不加密时不必合并，头部和负载分段交给传输口。分段放不下时走下面的合并
+	if (plain)
+	{
+		BufferChain bc;
+		if (msg.Write(bc))
+		{
+#if DEBUG
+			// 加入统计
+			StatSend(msg);
+#endif
+
+			return Controller::SendInternal(bc, msg.State);
+		}
+	}
+
 	//byte buf[1472];
 	//Stream ms(buf, ArrayLength(buf));
 	byte buf[256];
@@ -292,8 +315,8 @@ bool TokenController::Send(Message& msg)
 	// 带有负载数据，需要合并成为一段连续的内存
 	msg.Write(ms);
 
-	// 握手不加密
-	if (msg.Code > 0x01 && Key.Length() > 0)
+	// 加密需要修改负载，只能拷贝一份
+	if (!plain)
 	{
 		ms.SetPosition(0);
 		if (!Encrypt(ms, Key)) return false;
@@ -320,16 +343,20 @@ void TokenController::ShowMessage(cstring action, const Message& msg)
 		if (NoLogCodes[i] == 0) break;
 	}
 
-	debug_printf("Token::%s ", action);
+	// 字段直接作为参数记录，不在这里格式化
+	auto& tmsg = (const TokenMessage&)msg;
+	byte code = msg.Code;
+	if (msg.Reply) code |= 0x80;
+	if ((!msg.Reply && msg.OneWay) || (msg.Reply && msg.Error)) code |= (1 << 6);
 
 	if (ShowRemote && msg.State)
 	{
 		auto svr = (IPEndPoint*)msg.State;
-		svr->Show();
-		debug_printf(" ");
+		auto ip = (byte*)&svr->Address.Value;
+		log_printf("Token::%s %d.%d.%d.%d:%d Code=%02X Seq=%02X Len=%d\r\n", action, ip[0], ip[1], ip[2], ip[3], svr->Port, code, tmsg.Seq, msg.Length);
 	}
-
-	msg.Show();
+	else
+		log_printf("Token::%s Code=%02X Seq=%02X Len=%d\r\n", action, code, tmsg.Seq, msg.Length);
 
 	/*// 后半截全部当字符串输出处理
 	Stream ms(msg.Data , msg.Length);
@@ -8,6 +8,7 @@
 #include "Message\Controller.h"
 
 #include "TokenMessage.h"
+#include "ChannelSelector.h"
 
 // 令牌控制器
 class TokenController : public Controller
@@ -32,6 +33,8 @@ public:
 	byte	NoLogCodes[8];	// 没有日志的指令
 	bool	ShowRemote;	// 消息日志中是否显示远程地址
 
+	ChannelStat	Channel;	// 通道统计。多通道时用于选择最佳链路
+
 	TokenController();
 	virtual ~TokenController();
 
@@ -66,6 +66,26 @@ void TokenMessage::Write(Stream& ms) const
 	ms.WriteArray(Buffer(Data, Length));
 }
 
+// 头部写入预留空间，负载只引用不拷贝
+bool TokenMessage::Write(BufferChain& bc) const
+{
+	TS("TokenMessage::WriteChain");
+
+	byte tmp = Code | (Reply << 7);
+	if((!Reply && OneWay) || (Reply && Error)) tmp |= (1 << 6);
+
+	// 代码、序列号和压缩编码的长度
+	byte buf[2 + 5];
+	Stream ms(buf, sizeof(buf));
+	ms.Write(tmp);
+	ms.Write(Seq);
+	ms.WriteEncodeInt(Length);
+
+	if(!bc.Prepend(Buffer(buf, ms.Position()))) return false;
+
+	return bc.Add(Data, Length);
+}
+
 // 验证消息校验码是否有效
 bool TokenMessage::Valid() const
 {
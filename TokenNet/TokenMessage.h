@@ -30,6 +30,8 @@ public:
 	virtual bool Read(Stream& ms);
 	// 把消息写入数据流中
 	virtual void Write(Stream& ms) const;
+	// 把消息写入分段缓冲区，负载只引用
+	virtual bool Write(BufferChain& bc) const;
 
 	// 消息总长度，包括头部、负载数据和校验
 	virtual int Size() const;
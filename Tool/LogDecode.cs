@@ -0,0 +1,202 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using NewLife.Log;
+
+namespace NewLife.Reflection
+{
+    /// <summary>二进制日志解码。把设备BinLog输出还原为文本</summary>
+    /// <remarks>
+    /// 用法：XScript LogDecode.cs 固件.bin 串口抓包.log [固件基址，默认0x08000000]
+    /// 帧格式：0x1E 长度 编号(4) 参数...，编号为格式串在固件里的地址，帧以外的字节按文本原样输出
+    /// </remarks>
+    public class ScriptEngine
+    {
+        const Byte Mark = 0x1E;
+
+        static void Main(params String[] args)
+        {
+            var bin = args.Length > 0 ? args[0] : "SmartOS.bin";
+            var log = args.Length > 1 ? args[1] : "log.bin";
+            var baseAddr = args.Length > 2 ? Convert.ToUInt32(args[2], 16) : 0x08000000;
+
+            try
+            {
+                var firm = File.ReadAllBytes(bin);
+                var data = File.ReadAllBytes(log);
+                var txt = Decode(firm, baseAddr, data);
+
+                var file = Path.ChangeExtension(log, ".txt");
+                File.WriteAllText(file, txt, Encoding.UTF8);
+                Console.WriteLine("解码完成 {0} => {1}", log, file);
+            }
+            catch (Exception ex)
+            {
+                XTrace.WriteException(ex);
+            }
+        }
+
+        /// <summary>解码整段抓包数据</summary>
+        static String Decode(Byte[] firm, UInt32 baseAddr, Byte[] data)
+        {
+            var sb = new StringBuilder();
+            var text = new MemoryStream();
+            for (var i = 0; i < data.Length; i++)
+            {
+                if (data[i] == Mark && i + 6 <= data.Length)
+                {
+                    var len = data[i + 1];
+                    var fmt = i + 2 + len <= data.Length ? GetFormat(firm, baseAddr, BitConverter.ToUInt32(data, i + 2)) : null;
+                    if (fmt != null)
+                    {
+                        Flush(sb, text);
+                        sb.Append(Format(fmt, data, i + 6, i + 2 + len));
+                        i += 1 + len;
+                        continue;
+                    }
+                }
+                text.WriteByte(data[i]);
+            }
+            Flush(sb, text);
+
+            return sb.ToString();
+        }
+
+        static void Flush(StringBuilder sb, MemoryStream text)
+        {
+            if (text.Length == 0) return;
+
+            sb.Append(Encoding.UTF8.GetString(text.ToArray()));
+            text.SetLength(0);
+        }
+
+        static Dictionary<UInt32, String> _Formats = new Dictionary<UInt32, String>();
+        /// <summary>从固件读取格式串，地址不合法返回空</summary>
+        static String GetFormat(Byte[] firm, UInt32 baseAddr, UInt32 addr)
+        {
+            String fmt;
+            if (_Formats.TryGetValue(addr, out fmt)) return fmt;
+
+            if (addr < baseAddr || addr - baseAddr >= firm.Length) return null;
+
+            var p = (Int32)(addr - baseAddr);
+            var e = p;
+            while (e < firm.Length && firm[e] != 0) e++;
+            if (e >= firm.Length) return null;
+
+            fmt = Encoding.UTF8.GetString(firm, p, e - p);
+            _Formats[addr] = fmt;
+
+            return fmt;
+        }
+
+        /// <summary>按printf格式串还原参数</summary>
+        static String Format(String fmt, Byte[] data, Int32 p, Int32 end)
+        {
+            var sb = new StringBuilder();
+            for (var i = 0; i < fmt.Length; i++)
+            {
+                var ch = fmt[i];
+                if (ch != '%' || i + 1 >= fmt.Length)
+                {
+                    sb.Append(ch);
+                    continue;
+                }
+                if (fmt[i + 1] == '%')
+                {
+                    sb.Append('%');
+                    i++;
+                    continue;
+                }
+
+                // 标志、宽度、精度、长度
+                var k = i + 1;
+                var left = false;
+                var zero = false;
+                for (; k < fmt.Length && "-+ #0".IndexOf(fmt[k]) >= 0; k++)
+                {
+                    if (fmt[k] == '-') left = true;
+                    if (fmt[k] == '0') zero = true;
+                }
+                var width = 0;
+                for (; k < fmt.Length && Char.IsDigit(fmt[k]); k++) width = width * 10 + fmt[k] - '0';
+                var prec = -1;
+                if (k < fmt.Length && fmt[k] == '.')
+                {
+                    prec = 0;
+                    for (k++; k < fmt.Length && Char.IsDigit(fmt[k]); k++) prec = prec * 10 + fmt[k] - '0';
+                }
+                var longlong = false;
+                for (; k < fmt.Length && "hlLqjzt".IndexOf(fmt[k]) >= 0; k++)
+                {
+                    if (fmt[k] == 'l' && k + 1 < fmt.Length && fmt[k + 1] == 'l') longlong = true;
+                }
+                if (k >= fmt.Length) break;
+
+                var conv = fmt[k];
+                String val;
+                switch (conv)
+                {
+                    case 'd':
+                    case 'i':
+                        val = longlong ? ReadInt64(data, ref p, end).ToString() : ((Int32)ReadUInt32(data, ref p, end)).ToString();
+                        break;
+                    case 'u':
+                        val = longlong ? ((UInt64)ReadInt64(data, ref p, end)).ToString() : ReadUInt32(data, ref p, end).ToString();
+                        break;
+                    case 'x':
+                    case 'X':
+                        val = longlong ? ((UInt64)ReadInt64(data, ref p, end)).ToString(conv + "") : ReadUInt32(data, ref p, end).ToString(conv + "");
+                        break;
+                    case 'p':
+                        val = "0x" + ReadUInt32(data, ref p, end).ToString("x8");
+                        break;
+                    case 'c':
+                        val = ((Char)ReadUInt32(data, ref p, end)).ToString();
+                        break;
+                    case 'f':
+                    case 'e':
+                    case 'g':
+                        var f = BitConverter.ToSingle(BitConverter.GetBytes(ReadUInt32(data, ref p, end)), 0);
+                        val = f.ToString(conv == 'f' ? "F" + (prec < 0 ? 6 : prec) : conv + "");
+                        break;
+                    case 's':
+                        var n = p < end ? data[p++] : 0;
+                        if (p + n > end) n = end - p;
+                        val = Encoding.UTF8.GetString(data, p, n);
+                        p += n;
+                        break;
+                    default:
+                        val = fmt.Substring(i, k - i + 1);
+                        break;
+                }
+                if (val.Length < width)
+                    val = left ? val.PadRight(width) : val.PadLeft(width, zero && conv != 's' ? '0' : ' ');
+                sb.Append(val);
+
+                i = k;
+            }
+
+            return sb.ToString();
+        }
+
+        static UInt32 ReadUInt32(Byte[] data, ref Int32 p, Int32 end)
+        {
+            if (p + 4 > end) return 0;
+
+            var v = BitConverter.ToUInt32(data, p);
+            p += 4;
+            return v;
+        }
+
+        static Int64 ReadInt64(Byte[] data, ref Int32 p, Int32 end)
+        {
+            if (p + 8 > end) return 0;
+
+            var v = BitConverter.ToInt64(data, p);
+            p += 8;
+            return v;
+        }
+    }
+}